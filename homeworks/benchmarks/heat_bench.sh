@@ -0,0 +1,196 @@
+#!/bin/bash
+# Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+#
+# Benchmarks every variant of the heat simulation on synthetic plates.
+# usage: ./heat_bench.sh [repetitions] [thread counts] [output prefix]
+# Run from homeworks/benchmarks after `make build`, or just run `make`.
+# Each case is a plate of a size (SIZES, rows x cols) and pattern
+# (PATTERNS, see plate_gen), generated with SEED in a temporary directory,
+# with a job of LADDER epsilons from EPSILON. Every run starts from a fresh
+# copy of it. The serial variant simulates each case once first, as the
+# reference every run must match: the same states and the same output plate,
+# byte for byte. Runs alternate between variants and thread counts, so slow
+# drifts of the machine affect all of them alike.
+# Writes OUTPUT.runs.tsv (every run), OUTPUT.tsv and OUTPUT.json (medians),
+# and prints OUTPUT.tsv. Exits with 1 if a run failed or did not match.
+# Speedup is the median of serial over the median of the run, efficiency the
+# speedup per worker: the threads that ran, as the pthread variants give a
+# plate at most one thread per row inside its border, times the processes
+# for omp_mpi. GB/s follows the
+# model of the omp_mpi kernels: a state reads and writes every cell once.
+# Both count the states of every epsilon, as if simulated from the plate.
+
+REPETITIONS=${1:-5}
+THREAD_COUNTS=${2:-"1 2 4"}
+OUTPUT=${3:-results/heat_bench}
+SIZES=${SIZES:-"128x128 256x256"}
+PATTERNS=${PATTERNS:-"top gradient"}
+EPSILON=${EPSILON:-0.5}
+LADDER=${LADDER:-1}
+SEED=${SEED:-1}
+VARIANTS=${VARIANTS:-"serial pthread pthread_optimized omp_mpi"}
+MPIEXEC=${MPIEXEC:-"mpiexec -np 1"}
+HOMEWORKS=$(cd "$(dirname "$0")/.." && pwd)
+PLATE_GEN=$HOMEWORKS/plate_gen/bin/plate_gen
+PROCESSES=$(awk '{for (i = 1; i < NF; ++i) if ($i == "-np") print $(i + 1)}' \
+    <<< "$MPIEXEC")
+PROCESSES=${PROCESSES:-1}
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+mkdir -p "$(dirname "$OUTPUT")"
+
+# Prints the command that runs a variant
+variant_command() {
+  case $1 in
+    serial) echo "$HOMEWORKS/serial/bin/serial" ;;
+    pthread) echo "$HOMEWORKS/pthread/bin/pthread" ;;
+    pthread_optimized)
+      echo "$HOMEWORKS/optimized/pthread_optimized/bin/pthread_optimized" ;;
+    omp_mpi) echo "$MPIEXEC $HOMEWORKS/omp_mpi/bin/omp_mpi" ;;
+    *) return 1 ;;
+  esac
+}
+
+# Simulates a case with a variant in $WORK/run, and sets SECONDS_RUN,
+# STATES and OUTPUT_PLATE
+run_case() {
+  local variant=$1 case_name=$2 threads=$3
+  local command
+  command=$(variant_command "$variant") || {
+    echo "Error: Unknown variant $variant" >&2
+    return 1
+  }
+  rm -rf "$WORK/run"
+  cp -r "$WORK/cases/$case_name" "$WORK/run"
+  mkdir "$WORK/run/reports"
+  # Reports are written to the working directory
+  if ! (cd "$WORK/run" && $command "$WORK/run/job.txt" "$threads" \
+      > run.log 2>&1); then
+    echo "Error: $variant failed on $case_name with $threads threads" >&2
+    tail "$WORK/run/run.log" >&2
+    return 1
+  fi
+  SECONDS_RUN=$(awk '/^Completed job in:/ {print $4 + 0}' "$WORK/run/run.log")
+  # The states of every epsilon, and the plate of the smallest one
+  STATES=$(awk '{printf "%s%s", (NR > 1 ? "," : ""), $6}' \
+      "$WORK/run/reports/job.tsv")
+  OUTPUT_PLATE=$WORK/run/plate-${STATES##*,}.bin
+}
+
+# Cases, and the serial reference of each one
+CASES=""
+mkdir -p "$WORK/cases" "$WORK/reference"
+for size in $SIZES; do
+  for pattern in $PATTERNS; do
+    case_name=${size}_$pattern
+    mkdir "$WORK/cases/$case_name"
+    "$PLATE_GEN" "${size%x*}" "${size#*x}" "$pattern" \
+        "$WORK/cases/$case_name/plate.bin" --seed="$SEED" \
+        --job="$WORK/cases/$case_name/job.txt" --epsilon="$EPSILON" \
+        --ladder="$LADDER" || exit 1
+    run_case serial "$case_name" 1 || exit 1
+    echo "$STATES" > "$WORK/reference/$case_name.states"
+    cp "$OUTPUT_PLATE" "$WORK/reference/$case_name.bin"
+    CASES="$CASES $case_name"
+  done
+done
+
+FAILED=0
+printf "variant\tcase\tthreads\trepetition\tseconds\tstates\tmatches\n" \
+    > "$OUTPUT.runs.tsv"
+for repetition in $(seq "$REPETITIONS"); do
+  for case_name in $CASES; do
+    for variant in $VARIANTS; do
+      # Serial ignores the thread count
+      threads_list=$THREAD_COUNTS
+      [ "$variant" == "serial" ] && threads_list=1
+      for threads in $threads_list; do
+        run_case "$variant" "$case_name" "$threads" || { FAILED=1; continue; }
+        matches=true
+        if [ "$STATES" != "$(cat "$WORK/reference/$case_name.states")" ] \
+            || ! cmp -s "$OUTPUT_PLATE" "$WORK/reference/$case_name.bin"; then
+          echo "Error: $variant on $case_name with $threads threads differs" \
+              "from serial" >&2
+          matches=false
+          FAILED=1
+        fi
+        printf "%s\t%s\t%s\t%s\t%s\t%s\t%s\n" "$variant" "$case_name" \
+            "$threads" "$repetition" "$SECONDS_RUN" "$STATES" "$matches" \
+            >> "$OUTPUT.runs.tsv"
+      done
+    done
+  done
+done
+
+# Runs of a variant, case and thread count are consecutive and sorted by
+# seconds, so the median and 95th percentile (nearest rank) are positions
+tail -n +2 "$OUTPUT.runs.tsv" | sort -t$'\t' -k1,1 -k2,2 -k3,3n -k5,5g \
+    | awk -F'\t' -v processes="$PROCESSES" -v json="$OUTPUT.json" \
+        -v repetitions="$REPETITIONS" -v epsilon="$EPSILON" '
+  function flush() {
+    if (count == 0) return
+    median = count % 2 ? seconds[(count + 1) / 2] \
+        : (seconds[count / 2] + seconds[count / 2 + 1]) / 2
+    p95 = seconds[int((95 * count + 99) / 100)]
+    keys[++groups] = key
+    medians[key] = median
+    p95s[key] = p95
+    runs[key] = count
+    split(key, fields, "\t")
+    group_states[key] = states
+    group_matches[key] = matches
+    if (fields[1] == "serial") serial[fields[2]] = median
+    count = 0
+  }
+  {
+    current = $1 "\t" $2 "\t" $3
+    if (current != key) { flush(); key = current; matches = "true" }
+    seconds[++count] = $5
+    states = $6
+    if ($7 != "true") matches = "false"
+  }
+  END {
+    flush()
+    printf "variant\tcase\tthreads\tworkers\truns\tmedian\tp95\tspeedup" \
+        "\tefficiency\tcells/s\tGB/s\tstates\tmatches\n"
+    printf "{\n  \"repetitions\": %d,\n  \"epsilon\": %.9g,\n" \
+        "  \"results\": [", repetitions, epsilon > json
+    for (group = 1; group <= groups; ++group) {
+      key = keys[group]
+      split(key, fields, "\t")
+      split(fields[2], size, "[x_]")
+      # The pthread variants run at most a thread per evaluated row
+      workers = fields[3]
+      if (fields[1] ~ /^pthread/ && workers > size[1] - 2) {
+        workers = size[1] - 2
+      }
+      if (fields[1] == "omp_mpi") workers *= processes
+      cells = (size[1] - 2) * (size[2] - 2)
+      median = medians[key]
+      # Every line of the job counts, as the serial variant simulates them
+      rungs = split(group_states[key], rung_states, ",")
+      total_states = 0
+      for (rung = 1; rung <= rungs; ++rung) total_states += rung_states[rung]
+      speedup = serial[fields[2]] && median ? serial[fields[2]] / median : 0
+      cells_per_second = median ? total_states * cells / median : 0
+      gigabytes = median ? total_states * 2 * 8 * size[1] * size[2] \
+          / median / 1e9 : 0
+      printf "%s\t%s\t%d\t%d\t%d\t%.6f\t%.6f\t%.3f\t%.3f\t%.4g\t%.3f" \
+          "\t%s\t%s\n", fields[1], fields[2], fields[3], workers, \
+          runs[key], median, p95s[key], speedup, speedup / workers, \
+          cells_per_second, gigabytes, group_states[key], group_matches[key]
+      printf "%s\n    {\"variant\": \"%s\", \"case\": \"%s\", " \
+          "\"threads\": %d, \"workers\": %d, \"median\": %.6f, " \
+          "\"p95\": %.6f, \"speedup\": %.3f, \"efficiency\": %.3f, " \
+          "\"cells_per_second\": %.4g, \"gb_per_second\": %.3f, " \
+          "\"states\": [%s], \"matches\": %s}", (group > 1 ? "," : ""), \
+          fields[1], fields[2], fields[3], workers, median, p95s[key], \
+          speedup, speedup / workers, cells_per_second, gigabytes, \
+          group_states[key], group_matches[key] > json
+    }
+    printf "\n  ]\n}\n" > json
+  }' > "$OUTPUT.tsv"
+
+cat "$OUTPUT.tsv"
+exit $FAILED
@@ -0,0 +1,35 @@
+#!/bin/bash
+# Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+#
+# Compares checking convergence every state with checking it every few
+# states, fixed or adaptive.
+# usage: benchmarks/check_states.sh [job] [threads] [repetitions]
+# Run from homeworks/omp_mpi after `make release`. The job (job003 by default)
+# is copied to a temporary directory, so its plate files are not modified.
+# Prints: check_states repetition seconds
+
+JOB=${1:-jobs/job003b/job003.txt}
+THREADS=${2:-1}
+REPETITIONS=${3:-3}
+CHECK_STATES=${CHECK_STATES:-"1 8 64 auto"}
+MPIEXEC=${MPIEXEC:-"mpiexec -np 1"}
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+JOB_NAME=$(basename "$JOB")
+
+printf "check_states\trepetition\tseconds\n"
+for check_states in $CHECK_STATES; do
+  for repetition in $(seq "$REPETITIONS"); do
+    # Every run starts from the original plate files
+    rm -rf "$WORK/job"
+    cp -r "$(dirname "$JOB")" "$WORK/job"
+    rm -f "$WORK"/job/*-*.bin
+    $MPIEXEC bin/omp_mpi "$WORK/job/$JOB_NAME" "$THREADS" \
+        --check-states="$check_states" > "$WORK/run.log" || exit 1
+    awk -v check_states="$check_states" -v repetition="$repetition" '
+      /^Completed job in:/ {
+        printf "%s\t%s\t%s\n", check_states, repetition, $4 + 0
+      }' "$WORK/run.log"
+  done
+done
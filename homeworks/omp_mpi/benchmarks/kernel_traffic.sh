@@ -0,0 +1,54 @@
+#!/bin/bash
+# Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+#
+# Compares memory traffic per state of the equilibrate_plate kernels.
+# usage: benchmarks/kernel_traffic.sh [job_file] [thread_count] [options...]
+# Run from homeworks/omp_mpi after `make release`. Output plates are written
+# to a temporary copy of the job directory, so the job's files are untouched.
+# Prints: kernel plate states bytes/state(model) seconds [LLC misses/state]
+
+JOB=${1:-jobs/job002b/job002.txt}
+THREADS=${2:-$(nproc)}
+shift 2 2> /dev/null
+EXTRA=("$@")
+KERNELS=${KERNELS:-"sweep wavefront"}
+MPIEXEC=${MPIEXEC:-"mpiexec -np 1"}
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+cp -r "$(dirname "$JOB")" "$WORK/job"
+JOB_COPY="$WORK/job/$(basename "$JOB")"
+
+# Hardware counters are reported only if perf is available
+PERF=""
+if perf stat -e LLC-load-misses true > /dev/null 2>&1; then
+  PERF="perf stat -x, -e LLC-load-misses,LLC-store-misses -o $WORK/perf.txt"
+fi
+
+printf "kernel\tplate\tstates\tbytes/state\tseconds"
+[ -n "$PERF" ] && printf "\tllc_misses/state"
+printf "\n"
+
+for kernel in $KERNELS; do
+  $PERF $MPIEXEC bin/omp_mpi "$JOB_COPY" "$THREADS" --kernel="$kernel" \
+      --stats "${EXTRA[@]}" > "$WORK/$kernel.log" || exit 1
+  misses=""
+  if [ -n "$PERF" ]; then
+    misses=$(awk -F, '{sum += $1} END {print sum}' "$WORK/perf.txt")
+  fi
+  # Join the timing line and the statistics line of every plate
+  awk -v kernel="$kernel" -v misses="$misses" '
+    /^Equilibrated plate/ { seconds[$3] = $5 + 0 }
+    /^Plate [0-9]+: .* kernel,/ {
+      plate = $2 + 0; states[plate] = $5; bytes[plate] = $7
+      total_states += $5
+    }
+    END {
+      for (plate in states) {
+        printf "%s\t%s\t%s\t%s\t%s", kernel, plate, states[plate],
+            bytes[plate], seconds[plate]
+        if (misses != "") printf "\t%.1f", misses / total_states
+        printf "\n"
+      }
+    }' "$WORK/$kernel.log" | sort -t$'\t' -k2,2n
+done
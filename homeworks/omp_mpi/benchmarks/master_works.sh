@@ -0,0 +1,38 @@
+#!/bin/bash
+# Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+#
+# Compares the first process only dispatching ladders with it simulating them
+# too, for several amounts of processes.
+# usage: benchmarks/master_works.sh [job] [threads] [repetitions]
+# Run from homeworks/omp_mpi after `make release`. The job (job002 by default)
+# is copied to a temporary directory, so its plate files are not modified.
+# Prints: processes master_works repetition seconds
+
+JOB=${1:-jobs/job002b/job002.txt}
+THREADS=${2:-2}
+REPETITIONS=${3:-3}
+PROCESSES=${PROCESSES:-"2 3 4"}
+MPIEXEC=${MPIEXEC:-"mpiexec --oversubscribe"}
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+JOB_NAME=$(basename "$JOB")
+
+printf "processes\tmaster_works\trepetition\tseconds\n"
+for processes in $PROCESSES; do
+  for master_works in off on; do
+    for repetition in $(seq "$REPETITIONS"); do
+      # Every run starts from the original plate files
+      rm -rf "$WORK/job"
+      cp -r "$(dirname "$JOB")" "$WORK/job"
+      rm -f "$WORK"/job/*-*.bin
+      $MPIEXEC -np "$processes" bin/omp_mpi "$WORK/job/$JOB_NAME" "$THREADS" \
+          --master-works="$master_works" > "$WORK/run.log" || exit 1
+      awk -v processes="$processes" -v master_works="$master_works" \
+          -v repetition="$repetition" '
+        /^Completed job in:/ {
+          printf "%s\t%s\t%s\t%s\n", processes, master_works, repetition, $4 + 0
+        }' "$WORK/run.log"
+    done
+  done
+done
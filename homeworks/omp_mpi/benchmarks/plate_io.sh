@@ -0,0 +1,47 @@
+#!/bin/bash
+# Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+#
+# Compares the io modes reading and writing a large plate file.
+# usage: benchmarks/plate_io.sh [size] [repetitions]
+# Run from homeworks/omp_mpi after `make release`. Creates a size x size plate
+# (4096 by default, 128 MiB) in a temporary directory, in the file system of
+# TMPDIR, which must not be tmpfs to measure O_DIRECT.
+# Prints: io repetition read_seconds write_seconds
+
+SIZE=${1:-4096}
+REPETITIONS=${2:-3}
+IO_MODES=${IO_MODES:-"stdio mmap direct"}
+MPIEXEC=${MPIEXEC:-"mpiexec -np 1"}
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+# Writes a 64 bits unsigned integer in little endian
+write_uint64() {
+  local value=$1
+  for byte in 0 1 2 3 4 5 6 7; do
+    printf "\\x$(printf %02x $(( (value >> (8 * byte)) & 255 )))"
+  done
+}
+
+# Plate of zeros, so it is equilibrated in one state of any epsilon
+{
+  write_uint64 "$SIZE"
+  write_uint64 "$SIZE"
+  head -c $(( SIZE * SIZE * 8 )) /dev/zero
+} > "$WORK/plate.bin"
+printf "plate.bin 1 1 1 1\n" > "$WORK/job.txt"
+
+printf "io\trepetition\tread_seconds\twrite_seconds\n"
+for io in $IO_MODES; do
+  for repetition in $(seq "$REPETITIONS"); do
+    # Cache disabled so the plate file is read every time
+    $MPIEXEC bin/omp_mpi "$WORK/job.txt" 1 --io="$io" --plate-cache=0 \
+        --stats > "$WORK/$io.log" || exit 1
+    awk -v io="$io" -v repetition="$repetition" '
+      /^Plate [0-9]+: .* io,/ {
+        printf "%s\t%s\t%s\t%s\n", io, repetition, $7 + 0, $10 + 0
+      }' "$WORK/$io.log"
+    rm -f "$WORK"/plate-*.bin
+  done
+done
@@ -0,0 +1,52 @@
+#!/bin/bash
+# Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+#
+# Measures the time from the start of a job until its report is on disk.
+# usage: benchmarks/report_writer.sh [lines] [repetitions] [extra options]
+# Run from homeworks/omp_mpi after `make release`. Creates a job of lines
+# plates (100000 by default) of the same 3 x 3 plate file with decreasing
+# epsilons, in a temporary directory, like benchmarks/job_load.sh.
+# Prints: lines repetition job_seconds report_seconds total_seconds
+
+LINES=${1:-100000}
+REPETITIONS=${2:-3}
+shift $(( $# < 2 ? $# : 2 ))
+MPIEXEC=${MPIEXEC:-"mpiexec -np 1"}
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+# Writes a 64 bits unsigned integer in little endian
+write_uint64() {
+  local value=$1
+  for byte in 0 1 2 3 4 5 6 7; do
+    printf "\\x$(printf %02x $(( (value >> (8 * byte)) & 255 )))"
+  done
+}
+
+# Plate of zeros, so it is equilibrated in one state of any epsilon
+{
+  write_uint64 3
+  write_uint64 3
+  head -c 72 /dev/zero
+} > "$WORK/plate.bin"
+awk -v lines="$LINES" 'BEGIN {
+  for (line = 0; line < lines; ++line) {
+    printf "plate.bin\t1\t1\t1\t%.9g\n", 1 / (line + 2)
+  }
+}' > "$WORK/job.txt"
+
+printf "lines\trepetition\tjob_seconds\treport_seconds\ttotal_seconds\n"
+for repetition in $(seq "$REPETITIONS"); do
+  $MPIEXEC bin/omp_mpi "$WORK/job.txt" 1 --stats "$@" > "$WORK/run.log" \
+      || exit 1
+  awk -v lines="$LINES" -v repetition="$repetition" '
+    /^Completed job in:/ { job = $NF + 0 }
+    /^Reported job in:/ { report = $NF + 0 }
+    END {
+      total = job + report
+      printf "%s\t%s\t%s\t%s\t%.9f\n", lines, repetition, job, report, total
+    }
+  ' "$WORK/run.log"
+  rm -f "$WORK"/plate-*.bin
+done
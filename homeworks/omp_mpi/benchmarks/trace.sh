@@ -0,0 +1,37 @@
+#!/bin/bash
+# Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+#
+# Measures the cost of sampling the maximum change of every plate.
+# usage: benchmarks/trace.sh [job] [threads] [repetitions] [extra options]
+# Run from homeworks/omp_mpi after `make release`. The job (job003 by default)
+# is copied to a temporary directory, so its plate files are not modified.
+# Runs alternate between trace settings, 0 disables the trace, so slow
+# drifts of the machine affect all of them alike.
+# Prints: trace repetition seconds
+
+JOB=${1:-jobs/job003b/job003.txt}
+THREADS=${2:-1}
+REPETITIONS=${3:-5}
+shift $(( $# < 3 ? $# : 3 ))
+TRACES=${TRACES:-"0 1 100"}
+MPIEXEC=${MPIEXEC:-"mpiexec -np 1"}
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+JOB_NAME=$(basename "$JOB")
+
+printf "trace\trepetition\tseconds\n"
+for repetition in $(seq "$REPETITIONS"); do
+  for trace in $TRACES; do
+    # Every run starts from the original plate files
+    rm -rf "$WORK/job"
+    cp -r "$(dirname "$JOB")" "$WORK/job"
+    rm -f "$WORK"/job/*-*.bin
+    $MPIEXEC bin/omp_mpi "$WORK/job/$JOB_NAME" "$THREADS" --trace="$trace" \
+        "$@" > "$WORK/run.log" || exit 1
+    awk -v trace="$trace" -v repetition="$repetition" '
+      /^Completed job in:/ {
+        printf "%s\t%s\t%s\n", trace, repetition, $4 + 0
+      }' "$WORK/run.log"
+  done
+done
@@ -0,0 +1,333 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "active.h"
+#include "placement.h"
+#include <omp.h>
+
+/**
+ * @struct tile_box_t
+ * @brief Bounding rows and columns of tiles, empty if first_row is not
+ * before last_row.
+ */
+typedef struct {
+  uint64_t first_row;  ///< First tile row
+  uint64_t last_row;   ///< Tile row after the last one
+  uint64_t first_col;  ///< First tile column
+  uint64_t last_col;   ///< Tile column after the last one
+} tile_box_t;
+
+/**
+ * @struct active_t
+ * @brief Data shared by the threads updating the active tiles of a plate.
+ */
+typedef struct {
+  plate_matrix_t* plate_matrix;  ///< Plate matrix being equilibrated
+  double mult_constant;          ///< Constant in new temp formula
+  update_row_t update_row;       ///< Row kernel updating tile rows
+  uint64_t tile_rows;            ///< Rows of each tile, but the last ones
+  uint64_t tile_cols;            ///< Columns of each tile, but the last ones
+  uint64_t tile_row_count;       ///< Rows of tiles in the interior
+  uint64_t tile_col_count;       ///< Columns of tiles in the interior
+  uint64_t* changed_states;      ///< Last state each tile changed in, twice,
+                                 ///< for even and odd states
+  tile_box_t* changed_boxes;     ///< Tiles that changed in each thread's
+                                 ///< block, twice, for even and odd states
+  double* max_deltas;            ///< Maximum change of each thread's block,
+                                 ///< twice, for even and odd states
+} active_t;
+
+/**
+ * @brief Finds the tiles of a thread's block that may be active in a state:
+ * the tiles around the ones that changed in the previous state in the block
+ * and in its neighbor blocks, which hold the tiles above and below it.
+ *
+ * @param active Data of the plate being equilibrated
+ * @param thread Number of the thread
+ * @param team Amount of threads in the team
+ * @param block Tile rows of the thread, and every tile column
+ * @param state State to update, relative to the first state of the call
+ * @return Bounding tiles to look for active tiles in
+ */
+tile_box_t get_candidate_box(const active_t* active, uint64_t thread
+    , uint64_t team, const tile_box_t* block, uint64_t state);
+
+/**
+ * @brief Checks if a tile has to be updated in a state: if it or any of its
+ * four neighbor tiles changed in the previous state.
+ * @param active Data of the plate being equilibrated
+ * @param tile_row Row of the tile
+ * @param tile_col Column of the tile
+ * @param state State to update, relative to the first state of the call
+ */
+bool is_tile_active(const active_t* active, uint64_t tile_row
+    , uint64_t tile_col, uint64_t state);
+
+/**
+ * @brief Updates the cells of a tile.
+ * @param active Data of the plate being equilibrated
+ * @param current Matrix with the temperatures of the current state
+ * @param next Matrix where the new temperatures are stored
+ * @param tile_row Row of the tile
+ * @param tile_col Column of the tile
+ * @param cells Where the amount of cells of the tile is added
+ * @return Maximum temperature change of the tile
+ */
+double update_tile(const active_t* active, const double* current
+    , double* next, uint64_t tile_row, uint64_t tile_col, uint64_t* cells);
+
+/// @brief Returns the range of states of the statistics a state belongs to
+static inline uint64_t get_state_range(uint64_t state) {
+  uint64_t range = 0;
+  while (state >>= 1) ++range;
+  return range;
+}
+
+int equilibrate_plate_active(plate_t* plate, const options_t* options) {
+  plate_matrix_t* plate_matrix = plate->plate_matrix;
+  active_t active;
+  active.plate_matrix = plate_matrix;
+  active.mult_constant = calculate_mult_constant(plate);
+  active.update_row = get_update_row(options->simd);
+  active.tile_rows = options->tile_rows;
+  active.tile_cols = options->tile_cols;
+  // Plates with less than three rows or columns have no interior cells
+  const uint64_t interior_rows = plate_matrix->rows > 2 ?
+      plate_matrix->rows - 2 : 0;
+  const uint64_t interior_cols = plate_matrix->cols > 2 ?
+      plate_matrix->cols - 2 : 0;
+  active.tile_row_count = (interior_rows + active.tile_rows - 1)
+      / active.tile_rows;
+  active.tile_col_count = (interior_cols + active.tile_cols - 1)
+      / active.tile_cols;
+
+  const uint64_t tile_count = active.tile_row_count * active.tile_col_count;
+  active.changed_states = (uint64_t*) calloc(2 * tile_count + 1
+      , sizeof(uint64_t));
+  active.changed_boxes = (tile_box_t*) calloc(2 * options->thread_count
+      , sizeof(tile_box_t));
+  active.max_deltas = (double*) calloc(2 * options->thread_count
+      , sizeof(double));
+  if (!active.changed_states || !active.changed_boxes || !active.max_deltas) {
+    fprintf(stderr, "Error: Could not allocate active kernel buffers\n");
+    free(active.changed_states);
+    free(active.changed_boxes);
+    free(active.max_deltas);
+    return ERR_KERNEL_ALLOC;
+  }
+
+  const double epsilon = plate->epsilon;
+  const uint64_t first_state = plate->k_states;
+  // States until the stop state, or unlimited
+  const uint64_t state_budget = plate->stop_state ?
+      plate->stop_state - plate->k_states : UINT64_MAX;
+  uint64_t states = 0, updated_cells = 0;
+  double max_delta = 0;
+  double* current_matrix = plate_matrix->matrix;
+  double* previous_matrix = plate_matrix->auxiliary_matrix;
+
+  #pragma omp parallel num_threads(options->thread_count) default(none) \
+      shared(active, options, plate, epsilon, first_state, state_budget \
+      , states, updated_cells, max_delta, current_matrix, previous_matrix)
+  {  // NOLINT (whitespace/braces)
+    const uint64_t thread = omp_get_thread_num();
+    const uint64_t team = omp_get_num_threads();
+    pin_thread(options, thread);
+    // Static map of tile rows by blocks, as the one of plate rows
+    tile_box_t block = {0, 0, 0, active.tile_col_count};
+    get_block_rows(thread, team, active.tile_row_count + 2, &block.first_row
+        , &block.last_row);
+    --block.first_row;
+    --block.last_row;
+
+    // Each thread keeps its own pointers, so a state costs a single barrier
+    double* current = current_matrix;
+    double* next = previous_matrix;
+    uint64_t thread_states = 0, thread_cells = 0;
+    uint64_t tile_updates[TILE_STATE_RANGES] = {0};
+    uint64_t skipped_tiles[TILE_STATE_RANGES] = {0};
+    double state_delta = 0;
+    while (true) {
+      const uint64_t state = ++thread_states;
+      const tile_box_t candidates = get_candidate_box(&active, thread, team
+          , &block, state);
+      tile_box_t changed = {block.last_row, block.first_row
+          , block.last_col, block.first_col};
+      double block_delta = 0;
+      uint64_t updated_tiles = 0;
+      for (uint64_t tile_row = candidates.first_row
+          ; tile_row < candidates.last_row; ++tile_row) {
+        for (uint64_t tile_col = candidates.first_col
+            ; tile_col < candidates.last_col; ++tile_col) {
+          if (!is_tile_active(&active, tile_row, tile_col, state)) continue;
+          ++updated_tiles;
+          const double tile_delta = update_tile(&active, current, next
+              , tile_row, tile_col, &thread_cells);
+          // Any difference, even below epsilon, keeps its neighbors active
+          if (tile_delta > 0) {
+            active.changed_states[state % 2 * (active.tile_row_count
+                * active.tile_col_count) + tile_row * active.tile_col_count
+                + tile_col] = state;
+            if (tile_row < changed.first_row) changed.first_row = tile_row;
+            if (tile_row >= changed.last_row) changed.last_row = tile_row + 1;
+            if (tile_col < changed.first_col) changed.first_col = tile_col;
+            if (tile_col >= changed.last_col) changed.last_col = tile_col + 1;
+          }
+          if (tile_delta > block_delta) block_delta = tile_delta;
+        }
+      }
+      active.changed_boxes[state % 2 * team + thread] = changed;
+      active.max_deltas[state % 2 * team + thread] = block_delta;
+      const uint64_t range = get_state_range(first_state + state);
+      const uint64_t block_tiles = (block.last_row - block.first_row)
+          * active.tile_col_count;
+      tile_updates[range] += block_tiles;
+      skipped_tiles[range] += block_tiles - updated_tiles;
+      // Changes of the state are complete before the next one reads them
+      #pragma omp barrier
+
+      // Every thread finds the maximum change, since all of them need it
+      state_delta = 0;
+      for (uint64_t index = 0; index < team; ++index) {
+        const double delta = active.max_deltas[state % 2 * team + index];
+        if (delta > state_delta) state_delta = delta;
+      }
+      if (thread == 0) {
+        trace_state(plate->trace, first_state + state, state_delta);
+      }
+      double* swap = current;
+      current = next;
+      next = swap;
+      if (state_delta <= epsilon || thread_states == state_budget) break;
+    }
+
+    #pragma omp critical(active_statistics)
+    {
+      for (uint64_t range = 0; range < TILE_STATE_RANGES; ++range) {
+        plate->tile_updates[range] += tile_updates[range];
+        plate->skipped_tiles[range] += skipped_tiles[range];
+      }
+      updated_cells += thread_cells;
+    }
+    if (thread == 0) {
+      states = thread_states;
+      max_delta = state_delta;
+      current_matrix = current;
+      previous_matrix = next;
+    }
+  }
+
+  // Current state is the matrix of the plate, and the previous one its
+  // auxiliary, as the sweep kernel leaves them
+  plate_matrix->matrix = current_matrix;
+  plate_matrix->auxiliary_matrix = previous_matrix;
+  plate->k_states += states;
+  plate->max_delta = max_delta;
+  // Updated cells read the current matrix and write the new one
+  plate->moved_bytes += updated_cells * 2 * sizeof(double);
+
+  free(active.changed_states);
+  free(active.changed_boxes);
+  free(active.max_deltas);
+  return EXIT_SUCCESS;
+}
+
+tile_box_t get_candidate_box(const active_t* active, uint64_t thread
+    , uint64_t team, const tile_box_t* block, uint64_t state) {
+  // Every tile is updated in the first state, nothing changed before it
+  if (state == 1) return *block;
+
+  const tile_box_t* changed_boxes = active->changed_boxes
+      + (state - 1) % 2 * team;
+  tile_box_t candidates = {UINT64_MAX, 0, UINT64_MAX, 0};
+  const uint64_t first_thread = thread > 0 ? thread - 1 : 0;
+  const uint64_t last_thread = thread + 1 < team ? thread + 1 : thread;
+  for (uint64_t index = first_thread; index <= last_thread; ++index) {
+    const tile_box_t* changed = changed_boxes + index;
+    if (changed->first_row >= changed->last_row) continue;
+    // Tiles around the changed ones are active as well
+    const uint64_t first_row = changed->first_row > 0 ?
+        changed->first_row - 1 : 0;
+    const uint64_t first_col = changed->first_col > 0 ?
+        changed->first_col - 1 : 0;
+    if (first_row < candidates.first_row) candidates.first_row = first_row;
+    if (changed->last_row + 1 > candidates.last_row) {
+      candidates.last_row = changed->last_row + 1;
+    }
+    if (first_col < candidates.first_col) candidates.first_col = first_col;
+    if (changed->last_col + 1 > candidates.last_col) {
+      candidates.last_col = changed->last_col + 1;
+    }
+  }
+
+  // Only the tiles of the block are updated by the thread
+  if (candidates.first_row < block->first_row) {
+    candidates.first_row = block->first_row;
+  }
+  if (candidates.last_row > block->last_row) {
+    candidates.last_row = block->last_row;
+  }
+  if (candidates.last_col > block->last_col) {
+    candidates.last_col = block->last_col;
+  }
+  return candidates;
+}
+
+bool is_tile_active(const active_t* active, uint64_t tile_row
+    , uint64_t tile_col, uint64_t state) {
+  if (state == 1) return true;
+  // Last state each tile changed in, as stored in the previous state
+  const uint64_t* changed_states = active->changed_states + (state - 1) % 2
+      * (active->tile_row_count * active->tile_col_count);
+  const uint64_t tile = tile_row * active->tile_col_count + tile_col;
+  const uint64_t previous = state - 1;
+  return changed_states[tile] == previous
+      || (tile_row > 0
+      && changed_states[tile - active->tile_col_count] == previous)
+      || (tile_row + 1 < active->tile_row_count
+      && changed_states[tile + active->tile_col_count] == previous)
+      || (tile_col > 0 && changed_states[tile - 1] == previous)
+      || (tile_col + 1 < active->tile_col_count
+      && changed_states[tile + 1] == previous);
+}
+
+double update_tile(const active_t* active, const double* current
+    , double* next, uint64_t tile_row, uint64_t tile_col, uint64_t* cells) {
+  const plate_matrix_t* plate_matrix = active->plate_matrix;
+  const uint64_t cols = plate_matrix->cols;
+  // Tiles start after the border, the last ones end before it
+  const uint64_t first_row = 1 + tile_row * active->tile_rows;
+  uint64_t last_row = first_row + active->tile_rows;
+  if (last_row > plate_matrix->rows - 1) last_row = plate_matrix->rows - 1;
+  const uint64_t first_col = 1 + tile_col * active->tile_cols;
+  uint64_t last_col = first_col + active->tile_cols;
+  if (last_col > cols - 1) last_col = cols - 1;
+
+  double max_delta = 0;
+  for (uint64_t row = first_row; row < last_row; ++row) {
+    const uint64_t first_cell = row * cols + first_col;
+    const double row_delta = active->update_row(current + first_cell
+        , next + first_cell, last_col - first_col, cols
+        , active->mult_constant);
+    if (row_delta > max_delta) max_delta = row_delta;
+  }
+  *cells += (last_row - first_row) * (last_col - first_col);
+  return max_delta;
+}
+
+void report_skipped_tiles(size_t plate_number, const plate_t* plate) {
+  uint64_t tile_updates = 0, skipped_tiles = 0;
+  for (uint64_t range = 0; range < TILE_STATE_RANGES; ++range) {
+    tile_updates += plate->tile_updates[range];
+    skipped_tiles += plate->skipped_tiles[range];
+  }
+  printf("Plate %zu: active kernel, %.1lf%% of tiles skipped, by states:"
+      , plate_number, tile_updates ? 100.0 * skipped_tiles / tile_updates
+      : 0);
+  for (uint64_t range = 0; range < TILE_STATE_RANGES; ++range) {
+    if (plate->tile_updates[range] == 0) continue;
+    printf(" %" PRIu64 "-%" PRIu64 " %.1lf%%", (uint64_t) 1 << range
+        , ((uint64_t) 2 << range) - 1, 100.0 * plate->skipped_tiles[range]
+        / plate->tile_updates[range]);
+  }
+  printf("\n");
+}
@@ -0,0 +1,42 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef ACTIVE_H
+#define ACTIVE_H
+
+#include "options.h"
+#include "plate.h"
+
+/**
+ * @brief Simulates heat transfer of a plate until equilibrium updating only
+ * the tiles whose temperatures may still change.
+ *
+ * The interior of the plate is split into tiles, and tile rows are split in
+ * a static block per thread. A tile is settled in a state if none of its
+ * cells changed, not even by a unit in the last place. A settled tile whose
+ * four neighbor tiles are settled too would be computed from the same
+ * temperatures as in the previous state, so its new temperatures are the
+ * ones both matrices already hold, and it is skipped. Every other tile is
+ * active and updated. Each thread keeps the bounding rows and columns of
+ * the tiles of its block that changed, and only looks for active tiles
+ * around them and the ones of its neighbor blocks.
+ *
+ * Skipped tiles are exactly the ones that would not change, so k_states and
+ * the final temperatures are the same as the ones of the sweep kernel. The
+ * first state of every call updates every tile.
+ *
+ * @param plate Plate to equilibrate
+ * @param options Options with tile dimensions, amount of threads and
+ * instruction set
+ * @return EXIT_SUCCESS on success, ERR_KERNEL_ALLOC otherwise.
+ */
+int equilibrate_plate_active(plate_t* plate, const options_t* options);
+
+/**
+ * @brief Prints the percentage of tile updates skipped by the active kernel
+ * in a plate, in total and for the states of each power of two.
+ * @param plate_number Number of the plate in the job
+ * @param plate Plate equilibrated with the active kernel
+ */
+void report_skipped_tiles(size_t plate_number, const plate_t* plate);
+
+#endif  // ACTIVE_H
@@ -0,0 +1,253 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "balance.h"
+#include "placement.h"
+#include <omp.h>
+#include <stdatomic.h>
+
+/**
+ * @struct steal_t
+ * @brief Data shared by the threads sweeping a plate and stealing rows.
+ */
+typedef struct {
+  plate_matrix_t* plate_matrix;  ///< Plate matrix being equilibrated
+  double mult_constant;          ///< Constant in new temp formula
+  update_row_t update_row;       ///< Row kernel updating rows
+  uint64_t interior_cols;        ///< Cells updated in each row
+  uint64_t chunk_rows;           ///< Rows taken at once from a block
+  uint64_t* first_rows;          ///< First row of each thread's block
+  uint64_t* last_rows;           ///< Row after the last one of each block
+  _Atomic uint64_t* chunks;      ///< Chunks left in each block, head in the
+                                 ///< upper 32 bits and tail in the lower
+                                 ///< ones, twice, for even and odd states
+  double* max_deltas;            ///< Maximum change of each thread's rows,
+                                 ///< twice, for even and odd states
+} steal_t;
+
+/**
+ * @brief Takes a chunk from the head or the tail of a block.
+ *
+ * The owner of a block takes its chunks from the head, and threads that
+ * finished their own blocks take them from the tail. Both ends are in the
+ * same word, so each chunk is taken by a single thread without locks.
+ *
+ * @param chunks Chunks left in the block
+ * @param from_tail True to take the last chunk, false for the first one
+ * @param chunk Where the number of the chunk taken is stored
+ * @return True if a chunk was taken, false if none was left.
+ */
+bool take_chunk(_Atomic uint64_t* chunks, bool from_tail, uint64_t* chunk);
+
+/**
+ * @brief Updates the rows of a chunk of a block.
+ * @param steal Data of the plate being equilibrated
+ * @param block Thread whose block the chunk belongs to
+ * @param chunk Number of the chunk in the block
+ * @param current Matrix with the temperatures of the current state
+ * @param next Matrix where the new temperatures are stored
+ * @param rows Where the amount of rows of the chunk is stored
+ * @return Maximum temperature change of the chunk
+ */
+double update_chunk(const steal_t* steal, uint64_t block, uint64_t chunk
+    , const double* current, double* next, uint64_t* rows);
+
+/// @brief Returns the elapsed seconds since a time, and sets it to now
+static inline double lap_seconds(struct timespec* time) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  const double seconds = get_elapsed_seconds(time, &now);
+  *time = now;
+  return seconds;
+}
+
+int equilibrate_plate_steal(plate_t* plate, const options_t* options) {
+  plate_matrix_t* plate_matrix = plate->plate_matrix;
+  const uint64_t team = options->thread_count;
+  steal_t steal;
+  steal.plate_matrix = plate_matrix;
+  steal.mult_constant = calculate_mult_constant(plate);
+  steal.update_row = get_update_row(options->simd);
+  // Plates with less than three columns have no interior cells
+  steal.interior_cols = plate_matrix->cols > 2 ? plate_matrix->cols - 2 : 0;
+  steal.chunk_rows = plate_matrix->cols < STEAL_CHUNK_CELLS ?
+      STEAL_CHUNK_CELLS / plate_matrix->cols : 1;
+  steal.first_rows = (uint64_t*) calloc(team, sizeof(uint64_t));
+  steal.last_rows = (uint64_t*) calloc(team, sizeof(uint64_t));
+  steal.chunks = (_Atomic uint64_t*) calloc(2 * team, sizeof(uint64_t));
+  steal.max_deltas = (double*) calloc(2 * team, sizeof(double));
+  if (!steal.first_rows || !steal.last_rows || !steal.chunks
+      || !steal.max_deltas) {
+    fprintf(stderr, "Error: Could not allocate stealing kernel buffers\n");
+    free(steal.first_rows);
+    free(steal.last_rows);
+    free((void*) steal.chunks);
+    free(steal.max_deltas);
+    return ERR_KERNEL_ALLOC;
+  }
+  // Blocks of the static map, the ones rows are placed by in NUMA mode
+  for (uint64_t thread = 0; thread < team; ++thread) {
+    get_block_rows(thread, team, plate_matrix->rows
+        , &steal.first_rows[thread], &steal.last_rows[thread]);
+    // The first state takes its chunks from the odd half
+    const uint64_t block_rows = steal.last_rows[thread]
+        - steal.first_rows[thread];
+    atomic_init(&steal.chunks[team + thread]
+        , (block_rows + steal.chunk_rows - 1) / steal.chunk_rows);
+    atomic_init(&steal.chunks[thread], 0);
+  }
+
+  const double epsilon = plate->epsilon;
+  const uint64_t first_state = plate->k_states;
+  // States until the stop state, or unlimited
+  const uint64_t state_budget = plate->stop_state ?
+      plate->stop_state - plate->k_states : UINT64_MAX;
+  uint64_t states = 0;
+  double max_delta = 0;
+  double* current_matrix = plate_matrix->matrix;
+  double* previous_matrix = plate_matrix->auxiliary_matrix;
+
+  #pragma omp parallel num_threads(team) default(none) \
+      shared(steal, options, plate, team, epsilon, first_state, state_budget \
+      , states, max_delta, current_matrix, previous_matrix)
+  {  // NOLINT (whitespace/braces)
+    const uint64_t thread = omp_get_thread_num();
+    pin_thread(options, thread);
+    thread_balance_t* balance = plate->balance ? plate->balance + thread
+        : NULL;
+    struct timespec lap_time;
+    if (balance) clock_gettime(CLOCK_MONOTONIC, &lap_time);
+    const uint64_t block_chunks = (steal.last_rows[thread]
+        - steal.first_rows[thread] + steal.chunk_rows - 1) / steal.chunk_rows;
+
+    // Each thread keeps its own pointers, so a state costs a single barrier
+    double* current = current_matrix;
+    double* next = previous_matrix;
+    uint64_t thread_states = 0;
+    double state_delta = 0;
+    while (true) {
+      const uint64_t state = ++thread_states;
+      _Atomic uint64_t* chunks = steal.chunks + state % 2 * team;
+      double thread_delta = 0;
+      uint64_t chunk = 0, rows = 0;
+      // Own block first, from its head
+      while (take_chunk(&chunks[thread], /*from_tail*/ false, &chunk)) {
+        const double delta = update_chunk(&steal, thread, chunk, current
+            , next, &rows);
+        if (delta > thread_delta) thread_delta = delta;
+      }
+      // Then the tails of the other blocks, nearest first
+      for (uint64_t distance = 1; distance < team; ++distance) {
+        for (uint64_t side = 0; side < 2; ++side) {
+          if (side == 0 ? thread + distance >= team : distance > thread) {
+            continue;
+          }
+          const uint64_t victim = side == 0 ? thread + distance
+              : thread - distance;
+          while (take_chunk(&chunks[victim], /*from_tail*/ true, &chunk)) {
+            const double delta = update_chunk(&steal, victim, chunk, current
+                , next, &rows);
+            if (delta > thread_delta) thread_delta = delta;
+            if (balance) balance->stolen_rows += rows;
+          }
+        }
+      }
+      steal.max_deltas[state % 2 * team + thread] = thread_delta;
+      // Chunks of the next state, last taken in the previous one, which
+      // every thread finished before this one started
+      atomic_store_explicit(&steal.chunks[(state + 1) % 2 * team + thread]
+          , block_chunks, memory_order_relaxed);
+      if (balance) balance->busy_seconds += lap_seconds(&lap_time);
+      // New temperatures are complete before the next state reads them
+      #pragma omp barrier
+      if (balance) balance->idle_seconds += lap_seconds(&lap_time);
+
+      // Every thread finds the maximum change, since all of them need it
+      state_delta = 0;
+      for (uint64_t index = 0; index < team; ++index) {
+        const double delta = steal.max_deltas[state % 2 * team + index];
+        if (delta > state_delta) state_delta = delta;
+      }
+      if (thread == 0) {
+        trace_state(plate->trace, first_state + state, state_delta);
+      }
+      double* swap = current;
+      current = next;
+      next = swap;
+      if (state_delta <= epsilon || thread_states == state_budget) break;
+    }
+
+    if (thread == 0) {
+      states = thread_states;
+      max_delta = state_delta;
+      current_matrix = current;
+      previous_matrix = next;
+    }
+  }
+
+  // Current state is the matrix of the plate, and the previous one its
+  // auxiliary, as the sweep kernel leaves them
+  plate_matrix->matrix = current_matrix;
+  plate_matrix->auxiliary_matrix = previous_matrix;
+  plate->k_states += states;
+  plate->max_delta = max_delta;
+  // Every state reads the whole current matrix and writes the whole new one
+  plate->moved_bytes += states * 2 * sizeof(double) * plate_matrix->rows
+      * plate_matrix->cols;
+
+  free(steal.first_rows);
+  free(steal.last_rows);
+  free((void*) steal.chunks);
+  free(steal.max_deltas);
+  return EXIT_SUCCESS;
+}
+
+bool take_chunk(_Atomic uint64_t* chunks, bool from_tail, uint64_t* chunk) {
+  // Blocks have far less than 2^32 chunks, so both ends fit in a word and
+  // the owner and thieves agree on the chunks left with a single CAS
+  uint64_t left = atomic_load_explicit(chunks, memory_order_relaxed);
+  while (true) {
+    const uint64_t head = left >> 32;
+    const uint64_t tail = left & UINT32_MAX;
+    if (head >= tail) return false;
+    const uint64_t taken = from_tail ? left - 1 : left + ((uint64_t) 1 << 32);
+    if (atomic_compare_exchange_weak_explicit(chunks, &left, taken
+        , memory_order_relaxed, memory_order_relaxed)) {
+      *chunk = from_tail ? tail - 1 : head;
+      return true;
+    }
+  }
+}
+
+double update_chunk(const steal_t* steal, uint64_t block, uint64_t chunk
+    , const double* current, double* next, uint64_t* rows) {
+  const plate_matrix_t* plate_matrix = steal->plate_matrix;
+  const uint64_t first_row = steal->first_rows[block]
+      + chunk * steal->chunk_rows;
+  uint64_t last_row = first_row + steal->chunk_rows;
+  if (last_row > steal->last_rows[block]) last_row = steal->last_rows[block];
+
+  double max_delta = 0;
+  for (uint64_t row = first_row; row < last_row; ++row) {
+    // Update the row and get its maximum temperature change in one pass
+    const size_t first_cell = row * plate_matrix->cols + 1;
+    const double row_delta = steal->update_row(current + first_cell
+        , next + first_cell, steal->interior_cols, plate_matrix->cols
+        , steal->mult_constant);
+    if (row_delta > max_delta) max_delta = row_delta;
+  }
+  *rows = last_row - first_row;
+  return max_delta;
+}
+
+void report_balance(size_t plate_number, const plate_t* plate
+    , uint64_t thread_count) {
+  for (uint64_t thread = 0; thread < thread_count; ++thread) {
+    const thread_balance_t* balance = plate->balance + thread;
+    const double seconds = balance->busy_seconds + balance->idle_seconds;
+    printf("Plate %zu: thread %" PRIu64 " busy %.6lfs, idle %.6lfs (%.1lf%%)"
+        ", %" PRIu64 " rows stolen\n", plate_number, thread
+        , balance->busy_seconds, balance->idle_seconds
+        , seconds > 0 ? 100.0 * balance->idle_seconds / seconds : 0
+        , balance->stolen_rows);
+  }
+}
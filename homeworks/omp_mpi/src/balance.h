@@ -0,0 +1,45 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef BALANCE_H
+#define BALANCE_H
+
+#include "options.h"
+#include "plate.h"
+
+/** @brief Cells of the rows a thread takes at once from a block, rounded to
+ * whole rows and at least one. */
+#define STEAL_CHUNK_CELLS 16384
+
+/**
+ * @brief Simulates heat transfer of a plate until equilibrium, sweeping the
+ * whole matrix once per state with rows balanced by work stealing.
+ *
+ * Each thread keeps the block of rows of the static map every state, so its
+ * rows stay in its caches and NUMA node. Rows of a block are split in
+ * chunks of about STEAL_CHUNK_CELLS cells: the owner takes them from the
+ * head of its block, and a thread that finished its own block takes them
+ * from the tail of the nearest blocks first, so a straggler only gives away
+ * the rows it would have reached last. Every row is updated once from the
+ * previous state, so states and temperatures are identical to the sweep
+ * kernel. States are checked every one of them.
+ *
+ * If the plate has balance statistics, each thread adds the seconds it was
+ * busy and idle and the rows it stole to its own.
+ *
+ * @param plate Plate to equilibrate
+ * @param options Options with amount of threads and instruction set
+ * @return EXIT_SUCCESS on success, ERR_KERNEL_ALLOC otherwise.
+ */
+int equilibrate_plate_steal(plate_t* plate, const options_t* options);
+
+/**
+ * @brief Prints the busy and idle seconds and stolen rows of each thread of
+ * a plate.
+ * @param plate_number Number of the plate in the job
+ * @param plate Plate with balance statistics
+ * @param thread_count Threads of the statistics
+ */
+void report_balance(size_t plate_number, const plate_t* plate
+    , uint64_t thread_count);
+
+#endif  // BALANCE_H
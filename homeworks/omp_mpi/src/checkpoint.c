@@ -0,0 +1,220 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "checkpoint.h"
+
+#include <unistd.h>
+
+/** @brief Offset and prime of the 64 bits FNV-1a hash. */
+#define CHECKSUM_OFFSET 14695981039346656037ULL
+#define CHECKSUM_PRIME 1099511628211ULL
+
+/**
+ * @brief Continues a checksum with a block of bytes, a word at a time.
+ * @param checksum Checksum of the previous blocks, CHECKSUM_OFFSET at first
+ * @param data Bytes of the block, a multiple of 8
+ * @param size Amount of bytes
+ * @return Checksum including the block
+ */
+uint64_t update_checksum(uint64_t checksum, const void* data, size_t size);
+
+/// @brief Writes the snapshots of a writer until it is stopped
+/// @param data Checkpoint writer
+int run_checkpoint_writer(void* data);
+
+int init_checkpoint_writer(checkpoint_writer_t* writer) {
+  memset(writer, 0, sizeof(checkpoint_writer_t));
+  if (mtx_init(&writer->mutex, mtx_plain) != thrd_success) {
+    return EXIT_FAILURE;
+  }
+  if (cnd_init(&writer->changed) != thrd_success) {
+    mtx_destroy(&writer->mutex);
+    return EXIT_FAILURE;
+  }
+  if (thrd_create(&writer->thread, run_checkpoint_writer, writer)
+      != thrd_success) {
+    cnd_destroy(&writer->changed);
+    mtx_destroy(&writer->mutex);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+void destroy_checkpoint_writer(checkpoint_writer_t* writer) {
+  mtx_lock(&writer->mutex);
+  writer->stop = true;
+  cnd_broadcast(&writer->changed);
+  mtx_unlock(&writer->mutex);
+  thrd_join(writer->thread, NULL);
+
+  cnd_destroy(&writer->changed);
+  mtx_destroy(&writer->mutex);
+  free(writer->temperatures);
+  free(writer->path);
+}
+
+bool submit_checkpoint(checkpoint_writer_t* writer, const char* path
+    , const checkpoint_header_t* header, const double* temperatures) {
+  mtx_lock(&writer->mutex);
+  const bool busy = writer->pending;
+  if (busy) ++writer->skipped;
+  mtx_unlock(&writer->mutex);
+  if (busy) return false;
+
+  // Writer is idle until pending is set, so its buffers are not in use
+  const size_t cells = header->rows * header->cols;
+  if (cells > writer->capacity) {
+    double* resized = (double*) realloc(writer->temperatures
+        , cells * sizeof(double));
+    if (!resized) return false;
+    writer->temperatures = resized;
+    writer->capacity = cells;
+  }
+  char* path_copy = strdup(path);
+  if (!path_copy) return false;
+  free(writer->path);
+  writer->path = path_copy;
+  writer->header = *header;
+  memcpy(writer->temperatures, temperatures, cells * sizeof(double));
+
+  mtx_lock(&writer->mutex);
+  writer->pending = true;
+  cnd_broadcast(&writer->changed);
+  mtx_unlock(&writer->mutex);
+  return true;
+}
+
+void wait_checkpoint_writer(checkpoint_writer_t* writer) {
+  mtx_lock(&writer->mutex);
+  while (writer->pending) {
+    cnd_wait(&writer->changed, &writer->mutex);
+  }
+  mtx_unlock(&writer->mutex);
+}
+
+int run_checkpoint_writer(void* data) {
+  checkpoint_writer_t* writer = (checkpoint_writer_t*) data;
+  mtx_lock(&writer->mutex);
+  while (true) {
+    while (!writer->pending && !writer->stop) {
+      cnd_wait(&writer->changed, &writer->mutex);
+    }
+    if (!writer->pending) break;
+    mtx_unlock(&writer->mutex);
+
+    // Disk is only waited for by this thread
+    if (write_checkpoint(writer->path, &writer->header, writer->temperatures)
+        == EXIT_SUCCESS) {
+      ++writer->written;
+    }
+
+    mtx_lock(&writer->mutex);
+    writer->pending = false;
+    cnd_broadcast(&writer->changed);
+  }
+  mtx_unlock(&writer->mutex);
+  return EXIT_SUCCESS;
+}
+
+int write_checkpoint(const char* path, const checkpoint_header_t* header
+    , const double* temperatures) {
+  const size_t cells = header->rows * header->cols;
+  uint64_t checksum = update_checksum(CHECKSUM_OFFSET, header
+      , sizeof(checkpoint_header_t));
+  checksum = update_checksum(checksum, temperatures, cells * sizeof(double));
+
+  // Previous checkpoint is kept until the new one is complete on disk
+  const size_t temporary_size = strlen(path) + sizeof(".tmp");
+  char* temporary_path = (char*) malloc(temporary_size);
+  if (!temporary_path) return EXIT_FAILURE;
+  snprintf(temporary_path, temporary_size, "%s.tmp", path);
+
+  int error = EXIT_FAILURE;
+  FILE* file = fopen(temporary_path, "wb");
+  if (file) {
+    if (fwrite(header, sizeof(checkpoint_header_t), 1, file) == 1
+        && fwrite(temperatures, sizeof(double), cells, file) == cells
+        && fwrite(&checksum, sizeof(uint64_t), 1, file) == 1
+        && fflush(file) == 0 && fsync(fileno(file)) == 0) {
+      error = EXIT_SUCCESS;
+    }
+    if (fclose(file) != 0) error = EXIT_FAILURE;
+  }
+  if (error == EXIT_SUCCESS && rename(temporary_path, path) != 0) {
+    error = EXIT_FAILURE;
+  }
+
+  if (error != EXIT_SUCCESS) {
+    fprintf(stderr, "Error: Could not write checkpoint %s\n", path);
+    remove(temporary_path);
+  }
+  free(temporary_path);
+  return error;
+}
+
+bool read_checkpoint(const char* path, uint64_t plate_number, double epsilon
+    , checkpoint_header_t* header, double** temperatures) {
+  *temperatures = NULL;
+  FILE* file = fopen(path, "rb");
+  if (!file) return false;
+
+  bool valid = fread(header, sizeof(checkpoint_header_t), 1, file) == 1
+      && memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic)) == 0
+      && header->plate_number == plate_number && header->epsilon == epsilon
+      && (header->finished || (header->rows > 0 && header->cols > 0));
+
+  const size_t cells = valid ? header->rows * header->cols : 0;
+  if (valid && cells > 0) {
+    *temperatures = (double*) malloc(cells * sizeof(double));
+    valid = *temperatures
+        && fread(*temperatures, sizeof(double), cells, file) == cells;
+  }
+
+  // Incomplete or corrupted files are ignored
+  uint64_t stored_checksum = 0;
+  if (valid) {
+    uint64_t checksum = update_checksum(CHECKSUM_OFFSET, header
+        , sizeof(checkpoint_header_t));
+    checksum = update_checksum(checksum, *temperatures
+        , cells * sizeof(double));
+    valid = fread(&stored_checksum, sizeof(uint64_t), 1, file) == 1
+        && stored_checksum == checksum;
+  }
+  fclose(file);
+
+  if (!valid) {
+    free(*temperatures);
+    *temperatures = NULL;
+  }
+  return valid;
+}
+
+char* build_checkpoint_path(const char* job_file_path, uint64_t plate_number) {
+  // Job file name without its extension
+  const char* last_slash = strrchr(job_file_path, '/');
+  const char* name = last_slash ? last_slash + 1 : job_file_path;
+  const char* last_dot = strrchr(name, '.');
+  const int name_length = (int) (last_dot ? (size_t) (last_dot - name)
+      : strlen(name));
+  const int directory_length = (int) (name - job_file_path);
+
+  const int size = snprintf(NULL, 0, "%.*s%.*s-%" PRIu64 ".ckpt"
+      , directory_length, job_file_path, name_length, name, plate_number) + 1;
+  char* path = (char*) malloc(size);
+  if (path) {
+    snprintf(path, size, "%.*s%.*s-%" PRIu64 ".ckpt", directory_length
+        , job_file_path, name_length, name, plate_number);
+  }
+  return path;
+}
+
+uint64_t update_checksum(uint64_t checksum, const void* data, size_t size) {
+  const unsigned char* bytes = (const unsigned char*) data;
+  for (size_t offset = 0; offset + sizeof(uint64_t) <= size;
+      offset += sizeof(uint64_t)) {
+    uint64_t word = 0;
+    memcpy(&word, bytes + offset, sizeof(uint64_t));
+    checksum ^= word;
+    checksum *= CHECKSUM_PRIME;
+  }
+  return checksum;
+}
@@ -0,0 +1,129 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+
+#include "plate_matrix.h"
+
+/** @brief First bytes of every checkpoint file, with the layout version. */
+#define CHECKPOINT_MAGIC "PLATECK1"
+
+/**
+ * @struct checkpoint_header_t
+ * @brief State of a plate stored at the start of its checkpoint file.
+ *
+ * Checkpoints of plates being simulated are followed by the rows x cols
+ * temperatures of the state. Checkpoints of finished plates have no
+ * temperatures, since those are in the plate file written. Both end with a
+ * checksum of everything before it.
+ */
+typedef struct {
+  char magic[8];          ///< CHECKPOINT_MAGIC, not null terminated
+  uint64_t plate_number;  ///< Number of the plate in the job
+  uint64_t finished;      ///< 1 if the plate was equilibrated and written
+  uint64_t k_states;      ///< States simulated
+  uint64_t moved_bytes;   ///< Matrix bytes read and written by kernels
+  uint64_t float_states;  ///< States simulated in single precision
+  double max_delta;       ///< Maximum temperature change in last state
+  double epsilon;         ///< Epsilon of the plate, to validate the file
+  uint64_t rows;          ///< Rows of the temperatures stored
+  uint64_t cols;          ///< Columns of the temperatures stored
+} checkpoint_header_t;
+
+/**
+ * @struct checkpoint_writer_t
+ * @brief Background thread writing checkpoints, so simulating threads only
+ * copy the state to memory and never wait for the disk.
+ *
+ * The writer holds one snapshot. A checkpoint requested while the previous
+ * one is still being written is skipped.
+ */
+typedef struct {
+  thrd_t thread;                ///< Thread writing snapshots
+  mtx_t mutex;                  ///< Protects pending and stop
+  cnd_t changed;                ///< Signals pending or stop changes
+  bool pending;                 ///< True while a snapshot is not written
+  bool stop;                    ///< True to finish the thread
+  checkpoint_header_t header;   ///< Header of the snapshot
+  double* temperatures;         ///< Temperatures of the snapshot
+  size_t capacity;              ///< Cells the temperatures buffer holds
+  char* path;                   ///< Checkpoint file of the snapshot
+  uint64_t written;             ///< Checkpoints written
+  uint64_t skipped;             ///< Checkpoints skipped, writer was busy
+} checkpoint_writer_t;
+
+/**
+ * @brief Starts the background thread of a checkpoint writer.
+ * @param writer Writer to initialize
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE otherwise.
+ */
+int init_checkpoint_writer(checkpoint_writer_t* writer);
+
+/**
+ * @brief Writes pending snapshot, stops the thread and frees the writer.
+ * @param writer Writer to destroy
+ */
+void destroy_checkpoint_writer(checkpoint_writer_t* writer);
+
+/**
+ * @brief Copies the state of a plate for the writer to store it, unless the
+ * previous checkpoint is still being written.
+ *
+ * @param writer Writer of the checkpoint
+ * @param path Checkpoint file of the plate
+ * @param header State of the plate, rows and cols included
+ * @param temperatures Temperatures of the plate in that state
+ * @return True if the snapshot was taken, false if it was skipped.
+ */
+bool submit_checkpoint(checkpoint_writer_t* writer, const char* path
+    , const checkpoint_header_t* header, const double* temperatures);
+
+/// @brief Waits until the writer stored its pending snapshot, if any
+void wait_checkpoint_writer(checkpoint_writer_t* writer);
+
+/**
+ * @brief Writes a checkpoint file atomically: it is written and flushed to
+ * disk with a temporary name, then renamed, so the file of a plate is
+ * always its previous or its new checkpoint.
+ *
+ * @param path Checkpoint file
+ * @param header State of the plate
+ * @param temperatures Temperatures, ignored if header has 0 rows or cols
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE otherwise.
+ */
+int write_checkpoint(const char* path, const checkpoint_header_t* header
+    , const double* temperatures);
+
+/**
+ * @brief Reads and validates a checkpoint file.
+ *
+ * @param path Checkpoint file
+ * @param plate_number Plate the checkpoint must belong to
+ * @param epsilon Epsilon the plate must have
+ * @param header Where the header is stored
+ * @param temperatures Where a new buffer with the temperatures is stored,
+ * NULL for checkpoints of finished plates
+ * @return True if the file exists, belongs to the plate and its checksum is
+ * valid, false otherwise.
+ */
+bool read_checkpoint(const char* path, uint64_t plate_number, double epsilon
+    , checkpoint_header_t* header, double** temperatures);
+
+/**
+ * @brief Builds the path of the checkpoint file of a plate, in the directory
+ * of the job file, e.g. jobs/job002b/job002-3.ckpt.
+ *
+ * @param job_file_path Path of the job file
+ * @param plate_number Number of the plate in the job
+ * @return New string with the path, NULL on failure.
+ */
+char* build_checkpoint_path(const char* job_file_path, uint64_t plate_number);
+
+#endif  // CHECKPOINT_H
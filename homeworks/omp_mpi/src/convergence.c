@@ -0,0 +1,260 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "convergence.h"
+#include "placement.h"
+
+#include <omp.h>
+#include <string.h>
+
+/**
+ * @struct amortized_t
+ * @brief Data shared by the threads of a plate checked every few states.
+ */
+typedef struct {
+  plate_matrix_t* plate_matrix;  ///< Plate matrix being equilibrated
+  double mult_constant;          ///< Constant in new temp formula
+  update_row_t update_row;       ///< Row kernel of checked states
+  update_row_unchecked_t update_row_unchecked;  ///< Row kernel of the rest
+  uint64_t interior_cols;        ///< Cells updated in each row
+  double* matrices[3];           ///< Start of the run, and two to alternate
+  double* max_deltas;            ///< Maximum change of each thread's block,
+                                 ///< twice, for even and odd checks
+  uint64_t fixed_states;         ///< States between checks, 0 to adapt them
+} amortized_t;
+
+/**
+ * @brief Simulates a state of the rows of a thread's block.
+ *
+ * @param amortized Data of the plate being equilibrated
+ * @param current Matrix with the temperatures of the current state
+ * @param next Matrix where the new temperatures are stored
+ * @param first_row First row of the block
+ * @param last_row Row after the last one of the block
+ * @param check True to measure the maximum change of the block
+ * @return Maximum temperature change of the block, 0 if not checked
+ */
+double update_rows(const amortized_t* amortized, const double* current
+    , double* next, uint64_t first_row, uint64_t last_row, bool check);
+
+/// @brief Returns the maximum change of a check, once every thread stored
+/// the one of its block
+double get_state_delta(const amortized_t* amortized, uint64_t team
+    , uint64_t check);
+
+/**
+ * @brief Chooses the states until the next convergence check.
+ *
+ * Assumes the maximum change decays geometrically, at the rate measured
+ * between the last two checks, and checks again at half the states predicted
+ * to reach epsilon, so the states simulated again after the last check are
+ * few. States between checks at most double from one check to the next.
+ *
+ * @param check_states States of the last run
+ * @param delta Maximum change at the last check
+ * @param previous_delta Maximum change at the check before, 0 if none
+ * @param epsilon Epsilon of the plate
+ * @return States of the next run, at least 1
+ */
+uint64_t choose_check_states(uint64_t check_states, double delta
+    , double previous_delta, double epsilon);
+
+int equilibrate_plate_amortized(plate_t* plate, const options_t* options) {
+  plate_matrix_t* plate_matrix = plate->plate_matrix;
+  amortized_t amortized;
+  amortized.plate_matrix = plate_matrix;
+  amortized.mult_constant = calculate_mult_constant(plate);
+  amortized.update_row = get_update_row(options->simd);
+  amortized.update_row_unchecked = get_update_row_unchecked(options->simd);
+  // Plates with less than three rows or columns have no interior cells
+  amortized.interior_cols = plate_matrix->cols > 2 ? plate_matrix->cols - 2
+      : 0;
+  // The maximum change may grow in unstable plates
+  amortized.fixed_states = amortized.mult_constant > 0.25 ? 1
+      : options->check_states;
+
+  const uint64_t cells = plate_matrix->rows * plate_matrix->cols;
+  amortized.matrices[0] = plate_matrix->matrix;
+  amortized.matrices[1] = plate_matrix->auxiliary_matrix;
+  amortized.matrices[2] = (double*) malloc((cells + 1) * sizeof(double));
+  amortized.max_deltas = (double*) calloc(2 * options->thread_count
+      , sizeof(double));
+  if (!amortized.matrices[2] || !amortized.max_deltas) {
+    fprintf(stderr, "Error: Could not allocate amortized kernel buffers\n");
+    free(amortized.matrices[2]);
+    free(amortized.max_deltas);
+    return ERR_KERNEL_ALLOC;
+  }
+
+  const double epsilon = plate->epsilon;
+  const uint64_t first_state = plate->k_states;
+  // States until the stop state, or unlimited
+  const uint64_t state_budget = plate->stop_state ?
+      plate->stop_state - plate->k_states : UINT64_MAX;
+  uint64_t states = 0, checks = 0, replayed_states = 0;
+  size_t current = 0, previous = 1;
+  double max_delta = 0;
+
+  #pragma omp parallel num_threads(options->thread_count) default(none) \
+      shared(amortized, options, plate, plate_matrix, cells, epsilon \
+      , first_state, state_budget, states, checks, replayed_states, current \
+      , previous, max_delta)
+  {  // NOLINT (whitespace/braces)
+    const uint64_t thread = omp_get_thread_num();
+    const uint64_t team = omp_get_num_threads();
+    pin_thread(options, thread);
+    uint64_t first_row = 0, last_row = 0;
+    get_block_rows(thread, team, plate_matrix->rows, &first_row, &last_row);
+
+    // Third matrix has the borders of the plate, and the rows of each thread
+    // are first touched by it, as in NUMA mode
+    #pragma omp single
+    {
+      memcpy(amortized.matrices[2], amortized.matrices[0], plate_matrix->cols
+          * sizeof(double));
+      const size_t last_row_start = cells - plate_matrix->cols;
+      memcpy(amortized.matrices[2] + last_row_start, amortized.matrices[0]
+          + last_row_start, plate_matrix->cols * sizeof(double));
+    }
+    memcpy(amortized.matrices[2] + first_row * plate_matrix->cols
+        , amortized.matrices[0] + first_row * plate_matrix->cols
+        , (last_row - first_row) * plate_matrix->cols * sizeof(double));
+    #pragma omp barrier
+
+    // Every thread takes the same decisions from the same shared deltas, so
+    // they only meet at the barrier of each state
+    uint64_t thread_states = 0, thread_checks = 0, thread_replayed = 0;
+    uint64_t check_states = amortized.fixed_states ? amortized.fixed_states
+        : 1;
+    size_t start = 0, last = 1;
+    double state_delta = 0, previous_delta = 0;
+    while (true) {
+      if (check_states > state_budget - thread_states) {
+        check_states = state_budget - thread_states;
+      }
+      // Run from the start matrix, alternating between the other two
+      const size_t others[2] = {(start + 1) % 3, (start + 2) % 3};
+      size_t position = start;
+      for (uint64_t state = 1; state <= check_states; ++state) {
+        const size_t next = others[state % 2];
+        const bool check = state == check_states;
+        const double block_delta = update_rows(&amortized
+            , amortized.matrices[position], amortized.matrices[next]
+            , first_row, last_row, check);
+        if (check) {
+          amortized.max_deltas[thread_checks % 2 * team + thread]
+              = block_delta;
+        }
+        #pragma omp barrier
+        last = position;
+        position = next;
+      }
+      state_delta = get_state_delta(&amortized, team, thread_checks++);
+      // Checks within epsilon are sampled once the run is simulated again
+      if (thread == 0 && state_delta > epsilon) {
+        trace_state(plate->trace, first_state + thread_states + check_states
+            , state_delta);
+      }
+
+      if (state_delta <= epsilon && check_states > 1) {
+        // Equilibrated at or before the check, find the first state within
+        // epsilon simulating the run again from its start
+        position = start;
+        for (uint64_t state = 1; state <= check_states; ++state) {
+          const size_t next = others[state % 2];
+          amortized.max_deltas[thread_checks % 2 * team + thread]
+              = update_rows(&amortized, amortized.matrices[position]
+              , amortized.matrices[next], first_row, last_row, true);
+          #pragma omp barrier
+          state_delta = get_state_delta(&amortized, team, thread_checks++);
+          last = position;
+          position = next;
+          if (state_delta <= epsilon) {
+            // The whole run was simulated once before
+            thread_replayed += check_states;
+            check_states = state;
+            break;
+          }
+        }
+      }
+
+      thread_states += check_states;
+      start = position;
+      if (state_delta <= epsilon || thread_states == state_budget) break;
+      check_states = amortized.fixed_states ? amortized.fixed_states
+          : choose_check_states(check_states, state_delta, previous_delta
+          , epsilon);
+      previous_delta = state_delta;
+    }
+
+    if (thread == 0) {
+      states = thread_states;
+      checks = thread_checks;
+      replayed_states = thread_replayed;
+      current = start;
+      previous = last;
+      max_delta = state_delta;
+    }
+  }
+
+  // Current state is the matrix of the plate, and the previous one its
+  // auxiliary, as the sweep kernel leaves them
+  plate_matrix->matrix = amortized.matrices[current];
+  plate_matrix->auxiliary_matrix = amortized.matrices[previous];
+  free(amortized.matrices[3 - current - previous]);
+  free(amortized.max_deltas);
+
+  plate->k_states += states;
+  plate->max_delta = max_delta;
+  plate->checks += checks;
+  plate->replayed_states += replayed_states;
+  // Every state reads the whole current matrix and writes the whole new one
+  plate->moved_bytes += (states + replayed_states) * 2 * sizeof(double)
+      * cells;
+  return EXIT_SUCCESS;
+}
+
+double update_rows(const amortized_t* amortized, const double* current
+    , double* next, uint64_t first_row, uint64_t last_row, bool check) {
+  const uint64_t cols = amortized->plate_matrix->cols;
+  double max_delta = 0;
+  for (uint64_t row = first_row; row < last_row; ++row) {
+    const size_t first_cell = row * cols + 1;
+    if (check) {
+      const double row_delta = amortized->update_row(current + first_cell
+          , next + first_cell, amortized->interior_cols, cols
+          , amortized->mult_constant);
+      if (row_delta > max_delta) max_delta = row_delta;
+    } else {
+      amortized->update_row_unchecked(current + first_cell, next + first_cell
+          , amortized->interior_cols, cols, amortized->mult_constant);
+    }
+  }
+  return max_delta;
+}
+
+double get_state_delta(const amortized_t* amortized, uint64_t team
+    , uint64_t check) {
+  // Deltas of even and odd checks are stored apart, so a thread stores the
+  // delta of its next check while others still read this one
+  const double* max_deltas = amortized->max_deltas + check % 2 * team;
+  double state_delta = 0;
+  for (uint64_t index = 0; index < team; ++index) {
+    if (max_deltas[index] > state_delta) state_delta = max_deltas[index];
+  }
+  return state_delta;
+}
+
+uint64_t choose_check_states(uint64_t check_states, double delta
+    , double previous_delta, double epsilon) {
+  uint64_t limit = 2 * check_states;
+  if (limit > MAX_CHECK_STATES) limit = MAX_CHECK_STATES;
+  // Without a decay to extrapolate, the next check is farther away
+  if (previous_delta <= 0 || delta <= 0 || delta >= previous_delta) {
+    return limit;
+  }
+  const double decay_per_state = log(delta / previous_delta) / check_states;
+  const double remaining_states = log(epsilon / delta) / decay_per_state;
+  if (remaining_states / 2 < 1) return 1;
+  return remaining_states / 2 < limit ? (uint64_t) (remaining_states / 2)
+      : limit;
+}
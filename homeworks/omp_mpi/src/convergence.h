@@ -0,0 +1,35 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef CONVERGENCE_H
+#define CONVERGENCE_H
+
+#include "options.h"
+#include "plate.h"
+
+/** @brief Most states between two convergence checks in adaptive mode */
+#define MAX_CHECK_STATES 1024
+
+/**
+ * @brief Simulates heat transfer of a plate until equilibrium, measuring the
+ * maximum temperature change only every few states.
+ *
+ * States between checks use the unchecked row kernel, and each state costs a
+ * single barrier, since every thread updates the same static block of rows
+ * and keeps its own pointers to the matrices. The state a run of states
+ * started from is kept in a third matrix, so when a check finds the plate
+ * equilibrated, the run is simulated again from it checking every state, and
+ * the plate stops at the first state within epsilon, with the same k_states
+ * and temperatures as the sweep kernel.
+ *
+ * A check skips no earlier equilibrated state because the maximum change
+ * never grows while the constant of the plate is at most 1/4. Plates with a
+ * greater constant are checked every state.
+ *
+ * @param plate Plate to equilibrate
+ * @param options Options with amount of threads, instruction set, and states
+ * between checks, 0 to adapt them to how fast the maximum change decays
+ * @return EXIT_SUCCESS on success, ERR_KERNEL_ALLOC otherwise.
+ */
+int equilibrate_plate_amortized(plate_t* plate, const options_t* options);
+
+#endif  // CONVERGENCE_H
@@ -0,0 +1,287 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "decomposition.h"
+#include "placement.h"
+
+#include <mpi.h>
+#include <omp.h>
+#include <time.h>
+
+/** @brief Process that gathers the plates and writes their files. */
+#define GATHERING_PROCESS 0
+
+/**
+ * @brief Finds the rows of a process for a plate of the given rows.
+ * @param decomposition Decomposition with the rows of the plate
+ * @param process_number Process whose rows are found
+ * @param first_row Where the first row updated by the process is stored
+ * @param last_row Where the row after its last updated row is stored
+ */
+void get_process_rows(const decomposition_t* decomposition, int process_number
+    , uint64_t* first_row, uint64_t* last_row);
+
+/**
+ * @brief Finds the rows a process sends to be written: its block, and also
+ * the borders of the plate for the first and last processes with rows.
+ * @see get_process_rows
+ */
+void get_written_rows(const decomposition_t* decomposition
+    , int process_number, uint64_t* first_row, uint64_t* last_row);
+
+/// @brief Returns the worst error of all processes, so all of them agree
+int agree_on_error(int error);
+
+void init_decomposition(decomposition_t* decomposition, int process_number
+    , int process_count) {
+  memset(decomposition, 0, sizeof(decomposition_t));
+  decomposition->process_number = process_number;
+  decomposition->process_count = process_count;
+}
+
+void get_process_rows(const decomposition_t* decomposition, int process_number
+    , uint64_t* first_row, uint64_t* last_row) {
+  // Processes without rows have an empty block at the start of the plate
+  *first_row = 0;
+  *last_row = 0;
+  if (process_number < decomposition->active_count) {
+    get_block_rows(process_number, decomposition->active_count
+        , decomposition->rows, first_row, last_row);
+  }
+}
+
+void get_written_rows(const decomposition_t* decomposition
+    , int process_number, uint64_t* first_row, uint64_t* last_row) {
+  get_process_rows(decomposition, process_number, first_row, last_row);
+  if (process_number == 0) *first_row = 0;
+  if (process_number == decomposition->active_count - 1) {
+    *last_row = decomposition->rows;
+  }
+}
+
+int agree_on_error(int error) {
+  int worst_error = error;
+  MPI_Allreduce(&error, &worst_error, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  return worst_error;
+}
+
+int read_plate_block(plate_t* plate, char* source_directory
+    , decomposition_t* decomposition) {
+  int error = EXIT_SUCCESS;
+  char* plate_file_path = build_file_path(source_directory, plate->file_name);
+  FILE* plate_file = plate_file_path ? fopen(plate_file_path, "rb") : NULL;
+  free(plate_file_path);
+
+  uint64_t rows = 0, cols = 0;
+  if (!plate_file) {
+    fprintf(stderr, "Error: Plate file %s could not be opened\n"
+        , plate->file_name);
+    error = ERR_OPEN_PLATE_FILE;
+  } else if (fread(&rows, sizeof(uint64_t), 1, plate_file) != 1
+      || fread(&cols, sizeof(uint64_t), 1, plate_file) != 1) {
+    perror("Error: Rows and cols could not be read");
+    error = ERR_ROWS_COLS;
+  }
+
+  if (error == EXIT_SUCCESS) {
+    // Every process with rows has at least one interior row
+    const uint64_t interior_rows = rows > 2 ? rows - 2 : 0;
+    decomposition->rows = rows;
+    decomposition->cols = cols;
+    decomposition->active_count = interior_rows
+        < (uint64_t) decomposition->process_count ?
+        (int) (interior_rows > 0 ? interior_rows : 1)
+        : decomposition->process_count;
+    get_process_rows(decomposition, decomposition->process_number
+        , &decomposition->first_row, &decomposition->last_row);
+
+    // Block with the row above and below it. Processes without rows keep the
+    // first row, so all of them have a plate matrix
+    const bool active = decomposition->process_number
+        < decomposition->active_count;
+    decomposition->first_local_row = active ? decomposition->first_row - 1 : 0;
+    const uint64_t end_row = active ? (decomposition->last_row + 1 < rows ?
+        decomposition->last_row + 1 : rows) : 1;
+    const uint64_t local_rows = end_row - decomposition->first_local_row;
+
+    plate->plate_matrix = init_plate_matrix(local_rows, cols);
+    const size_t cells = local_rows * cols;
+    if (!plate->plate_matrix
+        || fseeko(plate_file, (off_t) (2 * sizeof(uint64_t)
+        + decomposition->first_local_row * cols * sizeof(double)), SEEK_SET)
+        != 0 || fread(plate->plate_matrix->matrix, sizeof(double), cells
+        , plate_file) != cells) {
+      fprintf(stderr, "Error: Rows of plate file %s could not be read\n"
+          , plate->file_name);
+      error = ERR_ROWS_COLS;
+    }
+  }
+  if (plate_file) fclose(plate_file);
+
+  error = agree_on_error(error);
+  if (error != EXIT_SUCCESS && plate->plate_matrix) {
+    destroy_plate_matrix(plate->plate_matrix);
+    plate->plate_matrix = NULL;
+  }
+  return error;
+}
+
+int equilibrate_plate_decomposed(plate_t* plate, const options_t* options
+    , decomposition_t* decomposition) {
+  plate_matrix_t* plate_matrix = plate->plate_matrix;
+  int error = EXIT_SUCCESS;
+  if (!plate_matrix->auxiliary_matrix
+      && init_auxiliary(plate_matrix) != EXIT_SUCCESS) {
+    fprintf(stderr, "Error: Could not allocate auxiliary matrix\n");
+    error = ERR_KERNEL_ALLOC;
+  }
+  error = agree_on_error(error);
+  if (error != EXIT_SUCCESS) return error;
+
+  const double mult_constant = calculate_mult_constant(plate);
+  const update_row_t update_row = get_update_row(options->simd);
+  const uint64_t cols = plate_matrix->cols;
+  const uint64_t interior_cols = cols > 2 ? cols - 2 : 0;
+  const int halo_count = (int) cols;
+  // Rows updated by this process, in the local plate matrix
+  const uint64_t first_row = decomposition->first_row
+      - decomposition->first_local_row;
+  const uint64_t last_row = decomposition->last_row
+      - decomposition->first_local_row;
+  const uint64_t halo_row = plate_matrix->rows - 1;
+  // Blocks of a single row have one edge, empty blocks have none
+  const uint64_t edge_rows[2] = {first_row, last_row > 0 ? last_row - 1 : 0};
+  const uint64_t edge_count = last_row > first_row + 1 ? 2
+      : last_row - first_row;
+  const uint64_t interior_end = edge_count == 2 ? last_row - 1 : first_row;
+  // Borders of the plate have no neighbor, so nothing is exchanged there
+  const int process_number = decomposition->process_number;
+  const int active_count = decomposition->active_count;
+  const int upper_process = process_number > 0
+      && process_number < active_count ? process_number - 1 : MPI_PROC_NULL;
+  const int lower_process = process_number + 1 < active_count ?
+      process_number + 1 : MPI_PROC_NULL;
+
+  uint64_t states = 0;
+  double max_delta = 0;
+  struct timespec exchange_start_time, exchange_finish_time;
+  while (true) {
+    ++states;
+    set_auxiliary(plate_matrix);
+
+    // Edge rows are updated first, so they travel while the interior is
+    double block_delta = 0;
+    for (uint64_t edge = 0; edge < edge_count; ++edge) {
+      const size_t first_cell = edge_rows[edge] * cols + 1;
+      const double row_delta = update_row(plate_matrix->auxiliary_matrix
+          + first_cell, plate_matrix->matrix + first_cell, interior_cols
+          , cols, mult_constant);
+      if (row_delta > block_delta) block_delta = row_delta;
+    }
+
+    MPI_Request requests[4];
+    MPI_Irecv(plate_matrix->matrix, halo_count, MPI_DOUBLE, upper_process
+        , HALO_TAG, MPI_COMM_WORLD, &requests[0]);
+    MPI_Irecv(plate_matrix->matrix + halo_row * cols, halo_count, MPI_DOUBLE
+        , lower_process, HALO_TAG, MPI_COMM_WORLD, &requests[1]);
+    MPI_Isend(plate_matrix->matrix + first_row * cols, halo_count, MPI_DOUBLE
+        , upper_process, HALO_TAG, MPI_COMM_WORLD, &requests[2]);
+    MPI_Isend(plate_matrix->matrix + edge_rows[1] * cols, halo_count
+        , MPI_DOUBLE, lower_process, HALO_TAG, MPI_COMM_WORLD, &requests[3]);
+
+    #pragma omp parallel num_threads(options->thread_count) default(none) \
+        shared(options, plate_matrix, update_row, mult_constant \
+        , interior_cols, cols, first_row, interior_end) \
+        reduction(max:block_delta)
+    {  // NOLINT (whitespace/braces)
+      pin_thread(options, omp_get_thread_num());
+      #pragma omp for schedule(static)
+      for (uint64_t row = first_row + 1; row < interior_end; ++row) {
+        const size_t first_cell = row * cols + 1;
+        const double row_delta = update_row(plate_matrix->auxiliary_matrix
+            + first_cell, plate_matrix->matrix + first_cell, interior_cols
+            , cols, mult_constant);
+        if (row_delta > block_delta) block_delta = row_delta;
+      }
+    }
+
+    // Halos of the new state are needed before the next one
+    clock_gettime(CLOCK_MONOTONIC, &exchange_start_time);
+    MPI_Waitall(4, requests, MPI_STATUSES_IGNORE);
+    MPI_Allreduce(&block_delta, &max_delta, 1, MPI_DOUBLE, MPI_MAX
+        , MPI_COMM_WORLD);
+    clock_gettime(CLOCK_MONOTONIC, &exchange_finish_time);
+    decomposition->exchange_seconds += get_elapsed_seconds(
+        &exchange_start_time, &exchange_finish_time);
+
+    trace_state(plate->trace, plate->k_states + states, max_delta);
+    if (max_delta <= plate->epsilon
+        || plate->k_states + states == plate->stop_state) {
+      break;
+    }
+  }
+
+  plate->k_states += states;
+  plate->max_delta = max_delta;
+  // Bytes moved by all processes, the same as the sweep kernel
+  plate->moved_bytes += states * 2 * sizeof(double) * decomposition->rows
+      * decomposition->cols;
+  return EXIT_SUCCESS;
+}
+
+int write_plate_decomposed(plate_t* plate, char* source_directory, io_t io
+    , const decomposition_t* decomposition) {
+  int error = EXIT_SUCCESS;
+  const bool gathering = decomposition->process_number == GATHERING_PROCESS;
+  plate_matrix_t* local_matrix = plate->plate_matrix;
+  plate_matrix_t* plate_matrix = NULL;
+  int* row_counts = NULL;
+  int* row_offsets = NULL;
+
+  // Rows are gathered as a datatype, so counts fit in int for large plates
+  MPI_Datatype row_type;
+  MPI_Type_contiguous((int) decomposition->cols, MPI_DOUBLE, &row_type);
+  MPI_Type_commit(&row_type);
+
+  if (gathering) {
+    plate_matrix = init_plate_matrix(decomposition->rows, decomposition->cols);
+    row_counts = (int*) calloc(decomposition->process_count, sizeof(int));
+    row_offsets = (int*) calloc(decomposition->process_count, sizeof(int));
+    if (!plate_matrix || !row_counts || !row_offsets) {
+      fprintf(stderr, "Error: Could not allocate gathered plate matrix\n");
+      error = ERR_KERNEL_ALLOC;
+    }
+    for (int process = 0; error == EXIT_SUCCESS
+        && process < decomposition->process_count; ++process) {
+      uint64_t first_row = 0, last_row = 0;
+      get_written_rows(decomposition, process, &first_row, &last_row);
+      row_counts[process] = (int) (last_row - first_row);
+      row_offsets[process] = (int) first_row;
+    }
+  }
+  MPI_Bcast(&error, 1, MPI_INT, GATHERING_PROCESS, MPI_COMM_WORLD);
+
+  if (error == EXIT_SUCCESS) {
+    uint64_t first_row = 0, last_row = 0;
+    get_written_rows(decomposition, decomposition->process_number, &first_row
+        , &last_row);
+    MPI_Gatherv(local_matrix->matrix + (first_row
+        - decomposition->first_local_row) * decomposition->cols
+        , (int) (last_row - first_row), row_type
+        , gathering ? plate_matrix->matrix : NULL, row_counts, row_offsets
+        , row_type, GATHERING_PROCESS, MPI_COMM_WORLD);
+
+    if (gathering) {
+      // Plate file is written from the whole plate matrix
+      plate->plate_matrix = plate_matrix;
+      error = update_plate_file(plate, source_directory, io);
+      plate->plate_matrix = local_matrix;
+    }
+    MPI_Bcast(&error, 1, MPI_INT, GATHERING_PROCESS, MPI_COMM_WORLD);
+  }
+
+  if (plate_matrix) destroy_plate_matrix(plate_matrix);
+  free(row_counts);
+  free(row_offsets);
+  MPI_Type_free(&row_type);
+  return error;
+}
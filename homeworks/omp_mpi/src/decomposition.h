@@ -0,0 +1,98 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef DECOMPOSITION_H
+#define DECOMPOSITION_H
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "options.h"
+#include "plate.h"
+
+/** @brief Tag of the halo rows exchanged by neighbor processes. */
+#define HALO_TAG 1
+
+/**
+ * @struct decomposition_t
+ * @brief Rows of the current plate held by a process, when every plate is
+ * split by rows among all processes instead of simulated by one of them.
+ *
+ * Interior rows are split with the same static map by blocks of the OpenMP
+ * threads, among the processes that get at least one row. Each process
+ * stores its block plus the row above and below it: borders of the plate, or
+ * halos with the edge rows of its neighbor processes.
+ */
+typedef struct {
+  int process_number;       ///< Number of this process
+  int process_count;        ///< Processes the plates are split among
+  int active_count;         ///< Processes with rows of the current plate
+  uint64_t rows;            ///< Rows of the whole current plate
+  uint64_t cols;            ///< Columns of the current plate
+  uint64_t first_row;       ///< First row updated by this process
+  uint64_t last_row;        ///< Row after the last one updated by this process
+  uint64_t first_local_row; ///< Row of the plate stored first by this process
+  double exchange_seconds;  ///< Seconds waiting for halos and reductions
+} decomposition_t;
+
+/**
+ * @brief Initializes the decomposition of a process, without a plate.
+ * @param decomposition Decomposition to initialize
+ * @param process_number Number of this process
+ * @param process_count Processes the plates are split among
+ */
+void init_decomposition(decomposition_t* decomposition, int process_number
+    , int process_count);
+
+/**
+ * @brief Reads the rows of a plate file held by this process into a new
+ * plate matrix, and finds the rows of every process.
+ *
+ * Only the block of the process and its halos are read, with a single seek,
+ * so no process stores the whole plate. Every process must call it, since
+ * they agree on errors so all of them stop if any of them failed.
+ *
+ * @param plate Plate whose (local) plate matrix is created
+ * @param source_directory Directory containing the plate file
+ * @param decomposition Decomposition updated with the rows of the plate
+ * @return EXIT_SUCCESS on success, error code otherwise.
+ */
+int read_plate_block(plate_t* plate, char* source_directory
+    , decomposition_t* decomposition);
+
+/**
+ * @brief Simulates heat transfer of a plate split among processes until
+ * equilibrium.
+ *
+ * In every state, each process updates the edge rows of its block first and
+ * sends them to its neighbors with MPI_Isend, while the halos of the new
+ * state are received with MPI_Irecv. The interior rows of the block are
+ * updated with OpenMP while the halos travel. Then an MPI_Allreduce finds the
+ * maximum temperature change of the whole plate, which decides equilibrium
+ * in every process at once.
+ *
+ * Every row is updated by the row kernel of the sweep kernel from the same
+ * temperatures, so states and temperatures are the same as the sweep kernel.
+ *
+ * @param plate Plate with the local plate matrix of this process
+ * @param options Options with amount of threads and instruction set
+ * @param decomposition Rows of the plate held by this process
+ * @return EXIT_SUCCESS on success, ERR_KERNEL_ALLOC otherwise.
+ */
+int equilibrate_plate_decomposed(plate_t* plate, const options_t* options
+    , decomposition_t* decomposition);
+
+/**
+ * @brief Gathers the blocks of every process in the first one, which writes
+ * the updated plate file.
+ *
+ * @param plate Plate with the local plate matrix of this process
+ * @param source_directory Directory where the file is written
+ * @param io Way to write the plate file
+ * @param decomposition Rows of the plate held by this process
+ * @return EXIT_SUCCESS on success in the first process, error code otherwise.
+ */
+int write_plate_decomposed(plate_t* plate, char* source_directory, io_t io
+    , const decomposition_t* decomposition);
+
+#endif  // DECOMPOSITION_H
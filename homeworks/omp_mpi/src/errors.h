@@ -8,7 +8,8 @@
 // ARGS RELATED
 enum {
   ERR_NO_JOB_FILE = EXIT_FAILURE + 1,
-  ERR_INVALID_THREAD_COUNT
+  ERR_INVALID_THREAD_COUNT,
+  ERR_INVALID_OPTION
 };
 
 // JOB RELATED
@@ -19,7 +20,9 @@ enum {
   ERR_PLATE_FILE_NAME_ALLOC,
   ERR_JOB_EXPANSION,
   ERR_RESULTS_FILE_PATH,
-  ERR_OPEN_RESULTS_FILE
+  ERR_OPEN_RESULTS_FILE,
+  ERR_LADDER_ALLOC,
+  ERR_JOB_FILE_FORMAT
 };
 
 // PLATE RELATED
@@ -28,7 +31,10 @@ enum {
   ERR_UPDATE_OUTPUT_FILE_NAME,
   ERR_ROWS_COLS,
   ERR_BUILD_OUTPUT_FILE_NAME,
-  ERR_OPEN_OUTPUT_FILE
+  ERR_OPEN_OUTPUT_FILE,
+  ERR_KERNEL_ALLOC,
+  ERR_MAP_PLATE_FILE,
+  ERR_WRITE_OUTPUT_FILE
 };
 
 // MPI RELATED
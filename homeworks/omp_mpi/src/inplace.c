@@ -0,0 +1,181 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "inplace.h"
+#include "placement.h"
+#include <omp.h>
+
+/**
+ * @struct inplace_t
+ * @brief Data shared by the threads updating a plate in place.
+ */
+typedef struct {
+  plate_matrix_t* plate_matrix;  ///< Plate matrix being equilibrated
+  double mult_constant;          ///< Constant in new temp formula
+  update_row_t update_row;       ///< Row kernel updating rows
+  uint64_t interior_cols;        ///< Cells updated in each row
+  double* saved_rows;            ///< Three new rows kept aside per thread
+  double* max_deltas;            ///< Maximum change of each thread's block
+} inplace_t;
+
+/**
+ * @brief Updates the rows of a thread's block, writing the new temperatures
+ * of all of them but the first and the last one.
+ *
+ * @param inplace Data of the plate being equilibrated
+ * @param first_row First row of the block
+ * @param last_row Row after the last one of the block
+ * @param saved_rows Rows of the calling thread to keep new rows aside
+ * @return Maximum temperature change of the block
+ */
+double update_block(const inplace_t* inplace, uint64_t first_row
+    , uint64_t last_row, double* saved_rows);
+
+/// @brief Writes the new first and last rows of a block, kept aside by
+/// update_block
+/// @see update_block
+void write_block_edges(const inplace_t* inplace, uint64_t first_row
+    , uint64_t last_row, double* saved_rows);
+
+/**
+ * @brief Returns where the new temperatures of a row of a block are kept.
+ *
+ * The first row of the block has its own row, the rest alternate between
+ * the other two, so a row is kept until the next one is computed.
+ *
+ * @param saved_rows Rows of the calling thread
+ * @param position Position of the row in its block
+ * @param interior_cols Cells of each saved row
+ */
+static inline double* get_saved_row(double* saved_rows, uint64_t position
+    , uint64_t interior_cols) {
+  const uint64_t saved_row = position == 0 ? 0 : 1 + position % 2;
+  return saved_rows + saved_row * interior_cols;
+}
+
+int equilibrate_plate_inplace(plate_t* plate, const options_t* options) {
+  plate_matrix_t* plate_matrix = plate->plate_matrix;
+  inplace_t inplace;
+  inplace.plate_matrix = plate_matrix;
+  inplace.mult_constant = calculate_mult_constant(plate);
+  inplace.update_row = get_update_row(options->simd);
+  // Plates with less than three rows or columns have no interior cells
+  inplace.interior_cols = plate_matrix->cols > 2 ? plate_matrix->cols - 2 : 0;
+
+  inplace.saved_rows = (double*) malloc((3 * options->thread_count
+      * inplace.interior_cols + 1) * sizeof(double));
+  inplace.max_deltas = (double*) calloc(options->thread_count
+      , sizeof(double));
+  if (!inplace.saved_rows || !inplace.max_deltas) {
+    fprintf(stderr, "Error: Could not allocate in-place kernel buffers\n");
+    free(inplace.saved_rows);
+    free(inplace.max_deltas);
+    return ERR_KERNEL_ALLOC;
+  }
+
+  const double epsilon = plate->epsilon;
+  // States until the stop state, or unlimited
+  const uint64_t state_budget = plate->stop_state ?
+      plate->stop_state - plate->k_states : UINT64_MAX;
+  const uint64_t first_state = plate->k_states;
+  uint64_t states = 0;
+  double max_delta = 0;
+
+  #pragma omp parallel num_threads(options->thread_count) default(none) \
+      shared(inplace, options, plate, plate_matrix, epsilon, first_state \
+      , state_budget, states, max_delta)
+  {  // NOLINT (whitespace/braces)
+    const uint64_t thread = omp_get_thread_num();
+    const uint64_t team = omp_get_num_threads();
+    pin_thread(options, thread);
+    // Static map by blocks, first blocks have one more row if not even
+    uint64_t first_row = 0, last_row = 0;
+    get_block_rows(thread, team, plate_matrix->rows, &first_row, &last_row);
+    double* saved_rows = inplace.saved_rows
+        + thread * 3 * inplace.interior_cols;
+
+    uint64_t thread_states = 0;
+    while (true) {
+      ++thread_states;
+      inplace.max_deltas[thread] = update_block(&inplace, first_row, last_row
+          , saved_rows);
+      // Neighbor blocks finished reading the edges of this block
+      #pragma omp barrier
+
+      // Every thread finds the maximum change, since all of them need it
+      double state_delta = 0;
+      for (uint64_t index = 0; index < team; ++index) {
+        if (inplace.max_deltas[index] > state_delta) {
+          state_delta = inplace.max_deltas[index];
+        }
+      }
+      if (thread == 0) {
+        trace_state(plate->trace, first_state + thread_states, state_delta);
+      }
+      write_block_edges(&inplace, first_row, last_row, saved_rows);
+      // Edges are written before the next state reads them
+      #pragma omp barrier
+
+      if (state_delta <= epsilon || thread_states == state_budget) {
+        if (thread == 0) {
+          states = thread_states;
+          max_delta = state_delta;
+        }
+        break;
+      }
+    }
+  }
+
+  plate->k_states += states;
+  plate->max_delta = max_delta;
+  // Every state reads the whole matrix and writes the whole matrix
+  plate->moved_bytes += states * 2 * sizeof(double) * plate_matrix->rows
+      * plate_matrix->cols;
+
+  free(inplace.saved_rows);
+  free(inplace.max_deltas);
+  return EXIT_SUCCESS;
+}
+
+double update_block(const inplace_t* inplace, uint64_t first_row
+    , uint64_t last_row, double* saved_rows) {
+  plate_matrix_t* plate_matrix = inplace->plate_matrix;
+  const uint64_t cols = plate_matrix->cols;
+  const uint64_t interior_cols = inplace->interior_cols;
+  double max_delta = 0;
+
+  for (uint64_t row = first_row; row < last_row; ++row) {
+    // Rows above and below still hold the temperatures of the previous state
+    double* new_row = get_saved_row(saved_rows, row - first_row
+        , interior_cols);
+    const double delta = inplace->update_row(plate_matrix->matrix
+        + row * cols + 1, new_row, interior_cols, cols
+        , inplace->mult_constant);
+    if (delta > max_delta) max_delta = delta;
+
+    // Previous row is no longer needed, unless it is the first of the block
+    if (row > first_row + 1) {
+      memcpy(plate_matrix->matrix + (row - 1) * cols + 1
+          , get_saved_row(saved_rows, row - 1 - first_row, interior_cols)
+          , interior_cols * sizeof(double));
+    }
+  }
+  return max_delta;
+}
+
+void write_block_edges(const inplace_t* inplace, uint64_t first_row
+    , uint64_t last_row, double* saved_rows) {
+  plate_matrix_t* plate_matrix = inplace->plate_matrix;
+  const uint64_t cols = plate_matrix->cols;
+  const uint64_t interior_cols = inplace->interior_cols;
+
+  if (last_row > first_row) {
+    memcpy(plate_matrix->matrix + first_row * cols + 1
+        , get_saved_row(saved_rows, 0, interior_cols)
+        , interior_cols * sizeof(double));
+  }
+  if (last_row > first_row + 1) {
+    memcpy(plate_matrix->matrix + (last_row - 1) * cols + 1
+        , get_saved_row(saved_rows, last_row - 1 - first_row, interior_cols)
+        , interior_cols * sizeof(double));
+  }
+}
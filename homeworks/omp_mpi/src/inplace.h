@@ -0,0 +1,29 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef INPLACE_H
+#define INPLACE_H
+
+#include "options.h"
+#include "plate.h"
+
+/**
+ * @brief Simulates heat transfer of a plate until equilibrium updating a
+ * single matrix in place, without an auxiliary matrix.
+ *
+ * Interior rows are split in a static block per thread. Each thread sweeps
+ * its block top-down, keeping every new row aside until the row below it was
+ * computed, so rows are always computed from the temperatures of the previous
+ * state. The new first and last rows of each block are only written once all
+ * threads finished their blocks, since neighbor blocks still need the
+ * previous temperatures of those rows.
+ *
+ * Results are identical to the sweep kernel, with one plate matrix plus three
+ * rows per thread in memory, instead of two plate matrices.
+ *
+ * @param plate Plate to equilibrate
+ * @param options Options with amount of threads and instruction set
+ * @return EXIT_SUCCESS on success, ERR_KERNEL_ALLOC otherwise.
+ */
+int equilibrate_plate_inplace(plate_t* plate, const options_t* options);
+
+#endif  // INPLACE_H
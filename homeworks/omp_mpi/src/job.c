@@ -1,11 +1,108 @@
 // Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
 
+#include "active.h"
+#include "balance.h"
 #include "job.h"
+#include "schedule.h"
+#include "solver.h"
 #include <omp.h>
 
+/**
+ * @struct ladder_rung_t
+ * @brief Plate of the job with its number, sorted to build epsilon ladders.
+ */
+typedef struct {
+  const job_file_t* job_file;  ///< Table of the plates of the job
+  size_t plate_number;         ///< Number of the plate in the job
+} ladder_rung_t;
+
+/**
+ * @struct ladder_span_t
+ * @brief Range of sorted rungs that share the same plate and parameters.
+ */
+typedef struct {
+  size_t first_rung;    ///< First rung of the ladder
+  size_t rungs_count;   ///< Amount of rungs of the ladder
+  size_t first_plate;   ///< Smallest plate number of the ladder
+} ladder_span_t;
+
+/**
+ * @struct dispatch_t
+ * @brief Ladders sent to each worker and not finished yet, with the time the
+ * first of them is expected to finish, to decide when to send more.
+ */
+typedef struct {
+  uint64_t prefetch;            ///< Most ladders sent to a worker
+  uint64_t* queued;             ///< Ladders sent to each worker, not finished
+  int* ladders;                 ///< Those ladders, prefetch per worker, in
+                                ///< the order the worker simulates them
+  double* finish_times;         ///< Seconds of the dispatch when the first
+                                ///< ladder of each worker is expected to end
+  size_t sent_ladders;          ///< Ladders of the schedule sent so far
+  struct timespec start_time;   ///< When the dispatch started
+} dispatch_t;
+
+/// @brief Compares the plate file and physical parameters of two plates of
+/// the table of a job
+/// @return Negative, zero or positive, like strcmp
+int compare_plate_parameters(const job_file_t* job_file, size_t first
+    , size_t second);
+
+/// @brief Sorts rungs by plate parameters, then by decreasing epsilon, then
+/// by plate number. Used with qsort
+int compare_ladder_rungs(const void* first, const void* second);
+
+/// @brief Sorts ladder spans by their smallest plate number. Used with qsort
+int compare_ladder_spans(const void* first, const void* second);
+
+/// @brief Allocates the queues of every worker of a dispatch
+/// @return EXIT_SUCCESS on success, ERR_LADDER_ALLOC otherwise.
+int init_dispatch(dispatch_t* dispatch, int process_count, uint64_t prefetch);
+
+/// @brief Frees the queues of a dispatch
+void destroy_dispatch(dispatch_t* dispatch);
+
+/// @brief Returns the seconds since the dispatch started
+double get_dispatch_seconds(const dispatch_t* dispatch);
+
+/// @brief Sends a ladder to a worker process, or queues it to the local
+/// worker if the worker is the first process
+int send_ladder(local_worker_t* local_worker, int worker, int ladder_idx);
+
+/**
+ * @brief Tells whether the next ladder of the schedule can be sent to a
+ * worker: always to an idle one, and to a busy one while its queue has room
+ * and, with a trace, its ladders are expected to finish within
+ * PREFETCH_HORIZON_SECONDS.
+ */
+bool should_send_ahead(const job_t* job, const schedule_t* schedule
+    , const dispatch_t* dispatch, int worker);
+
+/// @brief Sends the next ladder of the schedule to a worker, and records it
+/// in the queue of the worker
+int send_next_ladder(schedule_t* schedule, dispatch_t* dispatch
+    , local_worker_t* local_worker, int worker);
+
+/// @brief Sends the next ladders of the schedule to a worker while
+/// should_send_ahead allows it
+int refill_worker(const job_t* job, schedule_t* schedule
+    , dispatch_t* dispatch, local_worker_t* local_worker, int worker);
+
+/// @brief Records the result of a ladder of a worker and sends it the next
+/// ladders of the schedule, if any
+int finish_dispatched_ladder(job_t* job, schedule_t* schedule
+    , dispatch_t* dispatch, local_worker_t* local_worker, int worker
+    , size_t ladder_idx, double seconds);
+
+/// @brief Records the seconds the ladder of a worker is expected to take
+/// yet, and sends the worker the next ladders if it is about to finish
+int update_progress(const job_t* job, schedule_t* schedule
+    , dispatch_t* dispatch, local_worker_t* local_worker, int worker
+    , size_t ladder_idx, double seconds);
+
 // ***[JOB RELATED]***
 
-job_t* init_job(char* job_file_name) {
+job_t* init_job(char* job_file_name, const options_t* options) {
   // Allocate memory for a new job structure
   job_t* job = (job_t*) calloc(1, sizeof(job_t));
 
@@ -14,15 +111,30 @@ job_t* init_job(char* job_file_name) {
     job->file_name = job_file_name;
     job->source_directory = extract_directory(job_file_name);
     job->plates_count = 0;
-    job->plates_capacity = STARTING_CAPACITY;
-    // Allocate memory for plates array
-    job->plates = (plate_t**) calloc(job->plates_capacity, sizeof(plate_t*));
+    job->options = options;
 
-    // Check if plates memory allocation failed
-    if (!job->plates) {
-      perror("Error: Memory for plates could not be allocated\n");
-      destroy_job(job);
-      return NULL;
+    // Plates repeated in the job are read once, within the memory budget
+    if (options->plate_cache_mib > 0) {
+      job->plate_cache = init_plate_cache(options->plate_cache_mib << 20);
+      if (!job->plate_cache) {
+        perror("Error: Memory for plate cache could not be allocated\n");
+        destroy_job(job);
+        return NULL;
+      }
+    }
+
+    // Checkpoints are written by a background thread of each process
+    if (options->checkpoint_states > 0 || options->checkpoint_seconds > 0) {
+      job->checkpoint_writer = (checkpoint_writer_t*)
+          malloc(sizeof(checkpoint_writer_t));
+      if (!job->checkpoint_writer
+          || init_checkpoint_writer(job->checkpoint_writer) != EXIT_SUCCESS) {
+        fprintf(stderr, "Error: Could not start checkpoint writer\n");
+        free(job->checkpoint_writer);
+        job->checkpoint_writer = NULL;
+        destroy_job(job);
+        return NULL;
+      }
     }
   } else {
     perror("Error: Memory for job could not be allocated\n");
@@ -32,110 +144,167 @@ job_t* init_job(char* job_file_name) {
   return job;
 }
 
-int set_job(job_t* job) {
-  // Open the job file for reading
-  FILE* job_file = fopen(job->file_name, "rt");
-
-  if (!job_file) {
-    perror("Error: Job file could not be opened\n");
+int set_job(job_t* job, int process_number) {
+  // Only the first process reads the job file and its plate headers
+  job_file_t* job_file = &job->job_file;
+  int error = EXIT_SUCCESS;
+  if (process_number == FIRST_PROCESS) {
+    error = read_job_file(job_file, job->file_name);
+    if (error == EXIT_SUCCESS) {
+      error = validate_job_plates(job_file, job->source_directory
+          , job->options->thread_count);
+    }
+    if (error == EXIT_SUCCESS) {
+      job->plates_count = job_file->header->plates_count;
+      error = set_epsilon_ladders(job);
+    }
+  }
+  // Other processes receive the ladders along with the plates
+  error = broadcast_job_file(job_file, process_number, error);
+  if (error != EXIT_SUCCESS) {
     destroy_job(job);
-    return ERR_JOB_FILE_NOT_FOUND;
+    return error;
   }
-  // Variables to store plate properties
-  char plate_file_name[MAX_FILE_NAME_SIZE] = "\0";
-  uint64_t interval_duration = 0;
-  double thermal_diffusivity = 0;
-  double cells_dimension = 0;
-  double epsilon = 0;
 
-  // Read and parse each line from the job file
-  while (fscanf(job_file, "%s\t%" SCNu64 "\t%lg\t%lg\t%lg\n",
-    plate_file_name, &interval_duration, &thermal_diffusivity,
-    &cells_dimension, &epsilon) == 5) {
-    // Allocate memory for a new plate
-    plate_t* curr_plate = (plate_t*) calloc(1, sizeof(plate_t));
-
-    if (!curr_plate) {
-      perror("Error: Memory for new plate could not be allocated\n");
-      destroy_job(job);
-      return ERR_PLATE_ALLOC;
-    }
+  job->plates_count = job_file->header->plates_count;
+  job->ladders_count = job_file->header->ladders_count;
+  job->ladder_plates = job_file->ladder_plates;
+  job->ladder_starts = job_file->ladder_starts;
+  return EXIT_SUCCESS;
+}
 
-    // Allocate memory for plate file name
-    curr_plate->file_name = (char*) calloc(1, strlen(plate_file_name) + 1);
-    if (!curr_plate->file_name) {
-      perror("Error: Memory for plate file name could not be allocated\n");
-      free(curr_plate);  // Free allocated memory before returning
-      destroy_job(job);
-      return ERR_PLATE_FILE_NAME_ALLOC;
-    }
+void set_plate_parameters(const job_t* job, size_t plate_number
+    , plate_t* plate) {
+  const job_file_t* job_file = &job->job_file;
+  plate->file_name = get_plate_name(job_file, plate_number);
+  plate->interval_duration = job_file->interval_durations[plate_number];
+  plate->thermal_diffusivity = job_file->thermal_diffusivities[plate_number];
+  plate->cells_dimension = job_file->cells_dimensions[plate_number];
+  plate->epsilon = job_file->epsilons[plate_number];
+}
 
-    // Copy file name and set plate properties
-    snprintf(curr_plate->file_name, strlen(plate_file_name) + 1, "%s",
-        plate_file_name);
+int set_epsilon_ladders(job_t* job) {
+  job_file_t* job_file = &job->job_file;
+  const size_t count = job->plates_count;
+  ladder_rung_t* rungs = (ladder_rung_t*) calloc(count + 1
+      , sizeof(ladder_rung_t));
+  ladder_span_t* spans = (ladder_span_t*) calloc(count + 1
+      , sizeof(ladder_span_t));
+
+  if (!rungs || !spans) {
+    perror("Error: Memory for epsilon ladders could not be allocated\n");
+    free(rungs);
+    free(spans);
+    return ERR_LADDER_ALLOC;
+  }
 
-    curr_plate->interval_duration = interval_duration;
-    curr_plate->thermal_diffusivity = thermal_diffusivity;
-    curr_plate->cells_dimension = cells_dimension;
-    curr_plate->epsilon = epsilon;
+  for (size_t plate_number = 0; plate_number < count; ++plate_number) {
+    rungs[plate_number].job_file = job_file;
+    rungs[plate_number].plate_number = plate_number;
+  }
+  // Plates of the same ladder become contiguous, by decreasing epsilon
+  if (job->options->epsilon_ladder) {
+    qsort(rungs, count, sizeof(ladder_rung_t), compare_ladder_rungs);
+  }
 
-    // Add plate to job's plates array
-    job->plates[job->plates_count] = curr_plate;
-    job->plates_count += 1;
+  // Find where each ladder starts and its first plate in the job
+  size_t ladders_count = 0;
+  for (size_t rung = 0; rung < count; ++rung) {
+    if (rung == 0 || !job->options->epsilon_ladder
+        || compare_plate_parameters(job_file, rungs[rung - 1].plate_number
+        , rungs[rung].plate_number) != 0) {
+      spans[ladders_count].first_rung = rung;
+      spans[ladders_count].first_plate = rungs[rung].plate_number;
+      ++ladders_count;
+    }
+    ladder_span_t* span = &spans[ladders_count - 1];
+    ++span->rungs_count;
+    if (rungs[rung].plate_number < span->first_plate) {
+      span->first_plate = rungs[rung].plate_number;
+    }
+  }
 
-    // Check if capacity needs to be expanded
-    if (check_capacity(job) != EXIT_SUCCESS) {
-      perror("Error: Could not expand plates array");
-      free(curr_plate);  // Free allocated memory before returning
-      destroy_job(job);
-      return ERR_JOB_EXPANSION;
+  // Ladders are simulated in the order their first plates have in the job
+  qsort(spans, ladders_count, sizeof(ladder_span_t), compare_ladder_spans);
+  size_t position = 0;
+  for (size_t ladder = 0; ladder < ladders_count; ++ladder) {
+    job_file->ladder_starts[ladder] = position;
+    for (size_t rung = 0; rung < spans[ladder].rungs_count; ++rung) {
+      job_file->ladder_plates[position++] =
+          rungs[spans[ladder].first_rung + rung].plate_number;
     }
   }
+  job_file->ladder_starts[ladders_count] = position;
+  job_file->header->ladders_count = ladders_count;
 
-  fclose(job_file);
+  free(rungs);
+  free(spans);
   return EXIT_SUCCESS;
 }
 
-
-int check_capacity(job_t* job) {
-  // If we've reached capacity for storage
-  if (job->plates_count == job->plates_capacity) {
-    // Call array expanding function
-    return expand_job(job);
+int compare_plate_parameters(const job_file_t* job_file, size_t first
+    , size_t second) {
+  int comparison = strcmp(get_plate_name(job_file, first)
+      , get_plate_name(job_file, second));
+  if (comparison != 0) return comparison;
+  const uint64_t* durations = job_file->interval_durations;
+  if (durations[first] != durations[second]) {
+    return durations[first] < durations[second] ? -1 : 1;
   }
-  return EXIT_SUCCESS;
+  const double* diffusivities = job_file->thermal_diffusivities;
+  if (diffusivities[first] != diffusivities[second]) {
+    return diffusivities[first] < diffusivities[second] ? -1 : 1;
+  }
+  const double* dimensions = job_file->cells_dimensions;
+  if (dimensions[first] != dimensions[second]) {
+    return dimensions[first] < dimensions[second] ? -1 : 1;
+  }
+  return 0;
 }
 
-
-
-int expand_job(job_t* job) {
-  job->plates_capacity *= 2;
-
-  // Use realloc to move plates to bigger array
-  plate_t** temp = (plate_t**) realloc(job->plates, sizeof(plate_t*)
-      * job->plates_capacity);
-
-  // If allocation is unsuccessful, destroy job and return failure
-  if (!temp) {
-    destroy_job(job);
-    return EXIT_FAILURE;
+int compare_ladder_rungs(const void* first, const void* second) {
+  const ladder_rung_t* first_rung = (const ladder_rung_t*) first;
+  const ladder_rung_t* second_rung = (const ladder_rung_t*) second;
+  const job_file_t* job_file = first_rung->job_file;
+  int comparison = compare_plate_parameters(job_file
+      , first_rung->plate_number, second_rung->plate_number);
+  if (comparison != 0) return comparison;
+  // Greater epsilons are reached first
+  const double first_epsilon = job_file->epsilons[first_rung->plate_number];
+  const double second_epsilon = job_file->epsilons[second_rung->plate_number];
+  if (first_epsilon != second_epsilon) {
+    return first_epsilon > second_epsilon ? -1 : 1;
   }
-
-  job->plates = temp;
-  return EXIT_SUCCESS;
+  return first_rung->plate_number < second_rung->plate_number ? -1 : 1;
 }
 
-
+int compare_ladder_spans(const void* first, const void* second) {
+  const size_t first_plate = ((const ladder_span_t*) first)->first_plate;
+  const size_t second_plate = ((const ladder_span_t*) second)->first_plate;
+  return first_plate < second_plate ? -1 : first_plate > second_plate;
+}
 
 
 void destroy_job(job_t* job) {
-  // Free memory allocated for each plate
-  for (size_t i = 0; i < job->plates_count; ++i) {
-    free(job->plates[i]->file_name);
-    free(job->plates[i]);
+  // Plates, their names, states and ladders are in a single buffer
+  destroy_job_file(&job->job_file);
+  // Free pristine copies of plates
+  destroy_plate_cache(job->plate_cache);
+  // Write pending checkpoint and stop its writer
+  if (job->checkpoint_writer) {
+    destroy_checkpoint_writer(job->checkpoint_writer);
+    free(job->checkpoint_writer);
+  }
+  // Stop the report writer of a job that did not finish
+  if (job->report_writer) {
+    destroy_report_writer(job->report_writer);
+    free(job->report_writer);
+  }
+  if (job->trace) {
+    destroy_trace(job->trace);
+    free(job->trace);
   }
-  // Free memory allocated for plates array
-  free(job->plates);
+  if (job->trace_file) fclose(job->trace_file);
   // Free job properties
   free(job->source_directory);
   free(job);
@@ -143,18 +312,46 @@ void destroy_job(job_t* job) {
 
 // ***[SIMULATION RELATED]***
 
-int simulate(char* job_file_path, uint64_t thread_count) {
+int simulate(char* job_file_path, const options_t* options) {
   mpi_t mpi;
   int error = mpiwrapper_init(&mpi);
   if (error != EXIT_SUCCESS) return error;
 
   // Create job struct
-  job_t* job = init_job(job_file_path);
+  job_t* job = init_job(job_file_path, options);
   if (!job) return ERR_JOB_INIT;
 
   // Set the struct with necessary information
-  error = set_job(job);
+  struct timespec load_start_time, load_finish_time;
+  clock_gettime(CLOCK_MONOTONIC, &load_start_time);
+  error = set_job(job, mpi.process_number);
   if (error != EXIT_SUCCESS) return error;
+  clock_gettime(CLOCK_MONOTONIC, &load_finish_time);
+  if (options->stats && mpi.process_number == FIRST_PROCESS) {
+    printf("Loaded job of %zu plates in %zu ladders in: %.9lfs\n"
+        , job->plates_count, job->ladders_count
+        , get_elapsed_seconds(&load_start_time, &load_finish_time));
+  }
+
+  // Every process simulates its rows of each plate, instead of whole plates
+  decomposition_t decomposition;
+  if (options->decompose && mpi.process_count > 1) {
+    init_decomposition(&decomposition, mpi.process_number, mpi.process_count);
+    job->decomposition = &decomposition;
+    // Checkpoints hold whole plates, so split plates are not checkpointed
+    if (job->checkpoint_writer) {
+      destroy_checkpoint_writer(job->checkpoint_writer);
+      free(job->checkpoint_writer);
+      job->checkpoint_writer = NULL;
+    }
+  }
+
+  // Each process samples the plates it simulates, and only the first one the
+  // plates split among processes. A job runs without a trace it cannot write
+  if (options->trace_states > 0 && (!job->decomposition
+      || mpi.process_number == FIRST_PROCESS)) {
+    start_trace_file(job, mpi.process_number);
+  }
 
   // If process is first
   if (mpi.process_number == FIRST_PROCESS) {
@@ -162,12 +359,17 @@ int simulate(char* job_file_path, uint64_t thread_count) {
     struct timespec start_time, finish_time;
     clock_gettime(CLOCK_MONOTONIC, &start_time);
 
+    // Lines of the report are written as plates finish
+    error = start_report(job);
+
     // If there is more than one process involved
-    if (mpi.process_count > 1) {
+    if (error != EXIT_SUCCESS) {
+      // Without a report file, the job is not simulated
+    } else if (mpi.process_count > 1 && !job->decomposition) {
       error = job_master_process(job, &mpi);
     } else {
       // Process plates by itself
-      error = process_plates(job, thread_count);
+      error = process_plates(job);
     }
 
     if (error != EXIT_SUCCESS) {
@@ -186,10 +388,36 @@ int simulate(char* job_file_path, uint64_t thread_count) {
     printf("Completed job in: %.9lfs\n", elapsed_time);
 
     // Report final results of the simulation
-    report_results(job);
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    error = report_results(job);
+    clock_gettime(CLOCK_MONOTONIC, &finish_time);
+    if (options->stats) {
+      printf("Reported job in: %.9lfs\n"
+          , get_elapsed_seconds(&start_time, &finish_time));
+    }
+    if (error == EXIT_SUCCESS
+        && (job->checkpoint_writer || options->resume)) {
+      // Job is complete, so its checkpoints are no longer needed
+      remove_checkpoints(job);
+    }
+  } else if (job->decomposition) {
+    // Simulate the rows of every plate along with the first process
+    process_plates(job);
   } else {
     // If process is not master, then run worker procedure
-    job_worker_process(job, thread_count);
+    job_worker_process(job);
+  }
+
+  // Report how many plate files were not read thanks to the cache
+  if (options->stats && job->plate_cache) {
+    printf("[PROCESS %d] plate cache: %" PRIu64 " hits, %" PRIu64 " misses, %"
+        PRIu64 " evictions\n", mpi.process_number, job->plate_cache->hits
+        , job->plate_cache->misses, job->plate_cache->evictions);
+  }
+  if (options->stats && job->checkpoint_writer) {
+    printf("[PROCESS %d] checkpoints: %" PRIu64 " written, %" PRIu64
+        " skipped\n", mpi.process_number, job->checkpoint_writer->written
+        , job->checkpoint_writer->skipped);
   }
 
   printf("[PROCESS %d] done\n", mpi.process_number);
@@ -199,194 +427,1143 @@ int simulate(char* job_file_path, uint64_t thread_count) {
 }
 
 int job_master_process(job_t* job, mpi_t* mpi) {
+  // Without enough MPI thread support, the first process only dispatches
+  int thread_support = MPI_THREAD_SINGLE;
+  MPI_Query_thread(&thread_support);
+  if (!job->options->master_works || thread_support < MPI_THREAD_SERIALIZED) {
+    return dispatch_ladders(job, mpi, NULL);
+  }
+
+  local_worker_t local_worker;
+  memset(&local_worker, 0, sizeof(local_worker_t));
+  local_worker.job = job;
+  local_worker.mpi = mpi;
+  local_worker.progress_ladder = -1;
+  local_worker.ladders = (int*) calloc(job->options->prefetch + 1
+      , sizeof(int));
+  local_worker.results = (local_result_t*) calloc(job->options->prefetch + 1
+      , sizeof(local_result_t));
+  if (!local_worker.ladders || !local_worker.results
+      || mtx_init(&local_worker.mutex, mtx_plain) != thrd_success) {
+    perror("Error: Memory for local worker could not be allocated");
+    free(local_worker.ladders);
+    free(local_worker.results);
+    return ERR_LADDER_ALLOC;
+  }
+  cnd_init(&local_worker.changed);
+
+  // Dispatcher thread is the only one calling MPI until it is joined
   int error = EXIT_SUCCESS;
-  // Keep record of current index
-  int current_plate_idx = 0;
-  // Determine if there are more worker processes than plates to simulate
-  // If so, then there will be one plate assigned to one process
-  // The rest would leave. If not, the worker processes are the ones available
-  int working_processes = (size_t) mpi->process_count - 1 < job->plates_count ?
-      mpi->process_count - 1 : (int) job->plates_count;
-  // Intialize workers controller with available worker processes
-  int available_workers = working_processes;
-  // Initial distribution of work, one plate for each available worker
-  for (int process_number = FIRST_PROCESS + 1;
-      process_number < working_processes; ++process_number) {
-    // Send the index of the plate to work in
-    error = mpiwrapper_send(&current_plate_idx, 1, MPI_INT, process_number);
-    if (error != EXIT_SUCCESS) return error;
-    ++current_plate_idx;  // Move on to next plate
-    --available_workers;  // One less available worker
+  thrd_t dispatcher;
+  if (thrd_create(&dispatcher, run_dispatcher, &local_worker)
+      != thrd_success) {
+    fprintf(stderr, "Error: Could not start dispatcher thread\n");
+    error = ERR_LADDER_ALLOC;
+  } else {
+    run_local_worker(&local_worker);
+    thrd_join(dispatcher, NULL);
+    error = local_worker.error;
+  }
+
+  cnd_destroy(&local_worker.changed);
+  mtx_destroy(&local_worker.mutex);
+  free(local_worker.ladders);
+  free(local_worker.results);
+  return error;
+}
+
+int run_dispatcher(void* data) {
+  local_worker_t* local_worker = (local_worker_t*) data;
+  local_worker->error = dispatch_ladders(local_worker->job, local_worker->mpi
+      , local_worker);
+  // Local worker stops once its queue is empty, even after an error
+  mtx_lock(&local_worker->mutex);
+  local_worker->stopping = true;
+  cnd_broadcast(&local_worker->changed);
+  mtx_unlock(&local_worker->mutex);
+  return EXIT_SUCCESS;
+}
+
+void run_local_worker(local_worker_t* local_worker) {
+  // Remaining threads simulate, next to the dispatcher thread
+  options_t local_options = *local_worker->job->options;
+  if (local_options.thread_count > 1) --local_options.thread_count;
+  job_t local_job = *local_worker->job;
+  local_job.options = &local_options;
+  // Estimates of its ladders go to the dispatcher thread through memory
+  if (local_job.trace) {
+    local_job.trace->progress = post_local_progress;
+    local_job.trace->progress_data = local_worker;
   }
+
   while (true) {
-    MPI_Status status;
-    int received_plate_idx = -1;
-    // Wait for any process to finish their plate and send the index
-    if (MPI_Recv(&received_plate_idx, 1, MPI_INT, MPI_ANY_SOURCE, 0
-        , MPI_COMM_WORLD, &status) != MPI_SUCCESS) {
-      perror("Error: could not get plate index from other processes");
-      error = ERR_MPI_RECV;
+    mtx_lock(&local_worker->mutex);
+    while (local_worker->queued == 0 && !local_worker->stopping) {
+      cnd_wait(&local_worker->changed, &local_worker->mutex);
+    }
+    if (local_worker->queued == 0) {
+      mtx_unlock(&local_worker->mutex);
       break;
     }
-    uint64_t k_states = 0;
-    // Obtain k_states simulated from source
-    error = mpiwrapper_recv(&k_states, 1, MPI_INT, status.MPI_SOURCE);
-    if (error != EXIT_SUCCESS) break;  // Break to stop the processes
-
-    // Update in own record
-    if (received_plate_idx < job->plates_count)
-      job->plates[received_plate_idx]->k_states = k_states;
-    ++available_workers;  // One worker became available
-
-    // If plates have not been fully processed
-    if (current_plate_idx < job->plates_count) {
-      // Send the next plate index back to sender
-      error = mpiwrapper_send(&current_plate_idx, 1, MPI_INT
-          , status.MPI_SOURCE);
-      ++current_plate_idx;  // Move on to next plate
-      --available_workers;  // One worker got sent to do work
+    const int ladder_idx = local_worker->ladders[0];
+    memmove(local_worker->ladders, local_worker->ladders + 1
+        , --local_worker->queued * sizeof(int));
+    const int next_ladder_idx = local_worker->queued > 0 ?
+        local_worker->ladders[0] : -1;
+    mtx_unlock(&local_worker->mutex);
+
+    // The plate file of the next ladder is read by the kernel meanwhile
+    if (next_ladder_idx >= 0) prefetch_ladder(&local_job, next_ladder_idx);
+    struct timespec start_time, finish_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    process_ladder(&local_job, ladder_idx);
+    clock_gettime(CLOCK_MONOTONIC, &finish_time);
+
+    // States are already in the shared plates, only the time is reported
+    mtx_lock(&local_worker->mutex);
+    local_result_t* result = &local_worker->results[local_worker->finished++];
+    result->ladder_idx = ladder_idx;
+    result->seconds = get_elapsed_seconds(&start_time, &finish_time);
+    mtx_unlock(&local_worker->mutex);
+  }
+}
+
+int dispatch_ladders(job_t* job, mpi_t* mpi, local_worker_t* local_worker) {
+  // Ladders are handed out longest expected first
+  schedule_t schedule;
+  int error = init_schedule(&schedule, job);
+  if (error != EXIT_SUCCESS) return error;
+
+  // Arrays are indexed by process number, the first one is the local worker
+  const int process_count = mpi->process_count;
+  const int first_worker = local_worker ? FIRST_PROCESS : FIRST_PROCESS + 1;
+  const int result_size = get_result_size(job);
+  const bool tracing = job->options->trace_states > 0;
+  // One pending result receive per worker process, completed in any order,
+  // then one pending progress receive per worker process if tracing
+  MPI_Request* requests = (MPI_Request*) malloc(2 * process_count
+      * sizeof(MPI_Request));
+  int* completed_requests = (int*) malloc(2 * process_count * sizeof(int));
+  char* results = (char*) malloc((size_t) process_count * result_size);
+  double* progress = (double*) malloc(2 * process_count * sizeof(double));
+  uint64_t* k_states = (uint64_t*) calloc(job->plates_count + 1
+      , sizeof(uint64_t));
+  dispatch_t dispatch;
+  const int dispatch_error = init_dispatch(&dispatch, process_count
+      , job->options->prefetch);
+  if (!requests || !completed_requests || !results || !progress || !k_states
+      || dispatch_error != EXIT_SUCCESS) {
+    perror("Error: Memory for worker results could not be allocated");
+    error = ERR_LADDER_ALLOC;
+  }
+  for (int index = 0; error == EXIT_SUCCESS && index < 2 * process_count;
+      ++index) {
+    requests[index] = MPI_REQUEST_NULL;
+  }
+
+  // Every worker gets one ladder per round, so the largest ladders start at
+  // once, and later rounds fill the prefetch queue of each worker
+  for (uint64_t round = 0; error == EXIT_SUCCESS
+      && round < job->options->prefetch; ++round) {
+    for (int worker = first_worker; error == EXIT_SUCCESS
+        && worker < process_count; ++worker) {
+      if (dispatch.queued[worker] == round
+          && should_send_ahead(job, &schedule, &dispatch, worker)) {
+        error = send_next_ladder(&schedule, &dispatch, local_worker, worker);
+      }
+    }
+  }
+  for (int worker = FIRST_PROCESS + 1; error == EXIT_SUCCESS
+      && worker < process_count; ++worker) {
+    if (dispatch.queued[worker] > 0 && MPI_Irecv(results + (size_t) worker
+        * result_size, result_size, MPI_PACKED, worker, RESULT_TAG
+        , MPI_COMM_WORLD, &requests[worker]) != MPI_SUCCESS) {
+      error = ERR_MPI_RECV;
+    }
+    if (error == EXIT_SUCCESS && tracing && MPI_Irecv(progress + 2 * worker
+        , 2, MPI_DOUBLE, worker, PROGRESS_TAG, MPI_COMM_WORLD
+        , &requests[process_count + worker]) != MPI_SUCCESS) {
+      error = ERR_MPI_RECV;
+    }
+  }
+
+  // A slow worker never delays replies to the others
+  size_t completed = 0;
+  while (error == EXIT_SUCCESS && completed < job->ladders_count) {
+    int completed_count = 0;
+    int result_code = MPI_SUCCESS;
+    if (local_worker) {
+      // Polled, so the local worker is answered too. Sleeping between polls
+      // leaves the processor to the simulating threads
+      result_code = MPI_Testsome(2 * process_count, requests
+          , &completed_count, completed_requests, MPI_STATUSES_IGNORE);
     } else {
-      // Check if all workers finished and are on standby again
-      if (available_workers == working_processes) break;
+      result_code = MPI_Waitany(2 * process_count, requests
+          , &completed_requests[0], MPI_STATUS_IGNORE);
+      completed_count = completed_requests[0] == MPI_UNDEFINED ? 0 : 1;
+    }
+    if (result_code != MPI_SUCCESS || (!local_worker && completed_count == 0)) {
+      perror("Error: could not get ladder results from other processes");
+      error = ERR_MPI_RECV;
+      break;
+    }
+    if (completed_count == MPI_UNDEFINED) completed_count = 0;
+
+    for (int index = 0; error == EXIT_SUCCESS && index < completed_count;
+        ++index) {
+      if (completed_requests[index] >= process_count) {
+        // An estimate of a worker, wait for its next one
+        const int worker = completed_requests[index] - process_count;
+        error = update_progress(job, &schedule, &dispatch, local_worker
+            , worker, (size_t) progress[2 * worker], progress[2 * worker + 1]);
+        if (error == EXIT_SUCCESS && MPI_Irecv(progress + 2 * worker, 2
+            , MPI_DOUBLE, worker, PROGRESS_TAG, MPI_COMM_WORLD
+            , &requests[process_count + worker]) != MPI_SUCCESS) {
+          error = ERR_MPI_RECV;
+        }
+        continue;
+      }
+      const int worker = completed_requests[index];
+      // Update in own record
+      double seconds = 0;
+      const size_t ladder_idx = unpack_result(job, results + (size_t) worker
+          * result_size, result_size, k_states, &seconds);
+      report_ladder(job, ladder_idx);
+      error = finish_dispatched_ladder(job, &schedule, &dispatch
+          , local_worker, worker, ladder_idx, seconds);
+      ++completed;
+      // Wait for the next result of the worker
+      if (error == EXIT_SUCCESS && dispatch.queued[worker] > 0
+          && MPI_Irecv(results + (size_t) worker * result_size, result_size
+          , MPI_PACKED, worker, RESULT_TAG, MPI_COMM_WORLD
+          , &requests[worker]) != MPI_SUCCESS) {
+        error = ERR_MPI_RECV;
+      }
+    }
+
+    // Results of the local worker are taken from its queue
+    int local_count = 0;
+    while (local_worker && error == EXIT_SUCCESS) {
+      mtx_lock(&local_worker->mutex);
+      const bool finished = local_worker->finished > 0;
+      local_result_t result = local_worker->results[0];
+      if (finished) {
+        memmove(local_worker->results, local_worker->results + 1
+            , --local_worker->finished * sizeof(local_result_t));
+      }
+      mtx_unlock(&local_worker->mutex);
+      if (!finished) break;
+      error = finish_dispatched_ladder(job, &schedule, &dispatch
+          , local_worker, FIRST_PROCESS, result.ladder_idx, result.seconds);
+      ++completed;
+      ++local_count;
+    }
+    if (local_worker && error == EXIT_SUCCESS) {
+      mtx_lock(&local_worker->mutex);
+      const int progress_ladder = local_worker->progress_ladder;
+      const double progress_seconds = local_worker->progress_seconds;
+      local_worker->progress_ladder = -1;
+      mtx_unlock(&local_worker->mutex);
+      if (progress_ladder >= 0) {
+        error = update_progress(job, &schedule, &dispatch, local_worker
+            , FIRST_PROCESS, (size_t) progress_ladder, progress_seconds);
+      }
+    }
+    if (local_worker && completed_count == 0 && local_count == 0) {
+      const struct timespec poll_interval = {0, DISPATCH_POLL_NANOSECONDS};
+      nanosleep(&poll_interval, NULL);
+    }
+  }
+  // Estimates still pending are no longer needed
+  for (int index = process_count; requests && index < 2 * process_count;
+      ++index) {
+    if (requests[index] != MPI_REQUEST_NULL) {
+      MPI_Cancel(&requests[index]);
+      MPI_Request_free(&requests[index]);
     }
   }
+  free(requests);
+  free(completed_requests);
+  free(results);
+  free(progress);
+  free(k_states);
+  destroy_dispatch(&dispatch);
+  destroy_schedule(&schedule);
+  if (error != EXIT_SUCCESS) return error;
 
   // Stop workers
   error = job_master_stop_workers(job, mpi);
   return error;
 }
 
+int init_dispatch(dispatch_t* dispatch, int process_count, uint64_t prefetch) {
+  dispatch->prefetch = prefetch;
+  dispatch->queued = (uint64_t*) calloc(process_count, sizeof(uint64_t));
+  dispatch->ladders = (int*) calloc((size_t) process_count * prefetch
+      , sizeof(int));
+  dispatch->finish_times = (double*) calloc(process_count, sizeof(double));
+  dispatch->sent_ladders = 0;
+  clock_gettime(CLOCK_MONOTONIC, &dispatch->start_time);
+  if (!dispatch->queued || !dispatch->ladders || !dispatch->finish_times) {
+    destroy_dispatch(dispatch);
+    return ERR_LADDER_ALLOC;
+  }
+  return EXIT_SUCCESS;
+}
+
+void destroy_dispatch(dispatch_t* dispatch) {
+  free(dispatch->queued);
+  free(dispatch->ladders);
+  free(dispatch->finish_times);
+  dispatch->queued = NULL;
+  dispatch->ladders = NULL;
+  dispatch->finish_times = NULL;
+}
+
+double get_dispatch_seconds(const dispatch_t* dispatch) {
+  struct timespec start_time = dispatch->start_time, now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return get_elapsed_seconds(&start_time, &now);
+}
+
+int send_ladder(local_worker_t* local_worker, int worker, int ladder_idx) {
+  if (worker != FIRST_PROCESS) {
+    return mpiwrapper_send(&ladder_idx, 1, MPI_INT, worker);
+  }
+  mtx_lock(&local_worker->mutex);
+  local_worker->ladders[local_worker->queued++] = ladder_idx;
+  cnd_broadcast(&local_worker->changed);
+  mtx_unlock(&local_worker->mutex);
+  return EXIT_SUCCESS;
+}
+
+bool should_send_ahead(const job_t* job, const schedule_t* schedule
+    , const dispatch_t* dispatch, int worker) {
+  const uint64_t queued = dispatch->queued[worker];
+  if (dispatch->sent_ladders >= job->ladders_count) return false;
+  if (queued == 0) return true;
+  if (queued >= dispatch->prefetch) return false;
+  // Without estimates of the workers, their queues are kept full
+  if (job->options->trace_states == 0) return true;
+
+  // Ladders behind the first one are predicted from the schedule
+  const int* ladders = dispatch->ladders + (size_t) worker
+      * dispatch->prefetch;
+  double busy_seconds = dispatch->finish_times[worker]
+      - get_dispatch_seconds(dispatch);
+  for (uint64_t position = 1; position < queued; ++position) {
+    busy_seconds += predict_ladder_seconds(schedule, ladders[position]);
+  }
+  return busy_seconds <= PREFETCH_HORIZON_SECONDS;
+}
+
+int send_next_ladder(schedule_t* schedule, dispatch_t* dispatch
+    , local_worker_t* local_worker, int worker) {
+  const int ladder_idx = (int) take_next_ladder(schedule);
+  ++dispatch->sent_ladders;
+  uint64_t* queued = &dispatch->queued[worker];
+  // An idle worker starts the ladder at once
+  if (*queued == 0) {
+    dispatch->finish_times[worker] = get_dispatch_seconds(dispatch)
+        + predict_ladder_seconds(schedule, ladder_idx);
+  }
+  dispatch->ladders[(size_t) worker * dispatch->prefetch + (*queued)++]
+      = ladder_idx;
+  return send_ladder(local_worker, worker, ladder_idx);
+}
+
+int refill_worker(const job_t* job, schedule_t* schedule
+    , dispatch_t* dispatch, local_worker_t* local_worker, int worker) {
+  int error = EXIT_SUCCESS;
+  while (error == EXIT_SUCCESS
+      && should_send_ahead(job, schedule, dispatch, worker)) {
+    error = send_next_ladder(schedule, dispatch, local_worker, worker);
+  }
+  return error;
+}
+
+int finish_dispatched_ladder(job_t* job, schedule_t* schedule
+    , dispatch_t* dispatch, local_worker_t* local_worker, int worker
+    , size_t ladder_idx, double seconds) {
+  // Workers finish their ladders in the order they were sent
+  int* ladders = dispatch->ladders + (size_t) worker * dispatch->prefetch;
+  memmove(ladders, ladders + 1, --dispatch->queued[worker] * sizeof(int));
+  finish_scheduled_ladder(schedule, job, ladder_idx, worker, seconds
+      , job->options->stats);
+  if (dispatch->queued[worker] > 0) {
+    dispatch->finish_times[worker] = get_dispatch_seconds(dispatch)
+        + predict_ladder_seconds(schedule, ladders[0]);
+  }
+  // Refill the queue of the worker
+  return refill_worker(job, schedule, dispatch, local_worker, worker);
+}
+
+int update_progress(const job_t* job, schedule_t* schedule
+    , dispatch_t* dispatch, local_worker_t* local_worker, int worker
+    , size_t ladder_idx, double seconds) {
+  // Estimates sent before the result of an earlier ladder are stale
+  if (dispatch->queued[worker] == 0 || (size_t) dispatch->ladders[
+      (size_t) worker * dispatch->prefetch] != ladder_idx) {
+    return EXIT_SUCCESS;
+  }
+  dispatch->finish_times[worker] = get_dispatch_seconds(dispatch) + seconds;
+  return refill_worker(job, schedule, dispatch, local_worker, worker);
+}
+
+int get_result_size(const job_t* job) {
+  int index_size = 0, seconds_size = 0, states_size = 0;
+  MPI_Pack_size(1, MPI_INT, MPI_COMM_WORLD, &index_size);
+  MPI_Pack_size(1, MPI_DOUBLE, MPI_COMM_WORLD, &seconds_size);
+  MPI_Pack_size((int) job->plates_count, MPI_UINT64_T, MPI_COMM_WORLD
+      , &states_size);
+  int plate_seconds_size = 0;
+  MPI_Pack_size((int) job->plates_count, MPI_DOUBLE, MPI_COMM_WORLD
+      , &plate_seconds_size);
+  return index_size + seconds_size + states_size + plate_seconds_size;
+}
+
+int pack_result(const job_t* job, int ladder_idx, double seconds
+    , uint64_t* k_states, char* result, int result_size) {
+  const size_t first = job->ladder_starts[ladder_idx];
+  const size_t rungs_count = job->ladder_starts[ladder_idx + 1] - first;
+  for (size_t rung = 0; rung < rungs_count; ++rung) {
+    k_states[rung] = job->job_file.k_states[job->ladder_plates[first + rung]];
+  }
+  int position = 0;
+  MPI_Pack(&ladder_idx, 1, MPI_INT, result, result_size, &position
+      , MPI_COMM_WORLD);
+  MPI_Pack(&seconds, 1, MPI_DOUBLE, result, result_size, &position
+      , MPI_COMM_WORLD);
+  MPI_Pack(k_states, (int) rungs_count, MPI_UINT64_T, result, result_size
+      , &position, MPI_COMM_WORLD);
+  for (size_t rung = 0; rung < rungs_count; ++rung) {
+    MPI_Pack(&job->job_file.seconds[job->ladder_plates[first + rung]], 1
+        , MPI_DOUBLE, result, result_size, &position, MPI_COMM_WORLD);
+  }
+  return position;
+}
+
+size_t unpack_result(job_t* job, char* result, int result_size
+    , uint64_t* k_states, double* seconds) {
+  int ladder_idx = 0, position = 0;
+  MPI_Unpack(result, result_size, &position, &ladder_idx, 1, MPI_INT
+      , MPI_COMM_WORLD);
+  MPI_Unpack(result, result_size, &position, seconds, 1, MPI_DOUBLE
+      , MPI_COMM_WORLD);
+  const size_t first = job->ladder_starts[ladder_idx];
+  const size_t rungs_count = job->ladder_starts[ladder_idx + 1] - first;
+  MPI_Unpack(result, result_size, &position, k_states, (int) rungs_count
+      , MPI_UINT64_T, MPI_COMM_WORLD);
+  for (size_t rung = 0; rung < rungs_count; ++rung) {
+    const size_t plate_number = job->ladder_plates[first + rung];
+    job->job_file.k_states[plate_number] = k_states[rung];
+    MPI_Unpack(result, result_size, &position
+        , &job->job_file.seconds[plate_number], 1, MPI_DOUBLE
+        , MPI_COMM_WORLD);
+  }
+  return (size_t) ladder_idx;
+}
+
+void send_progress(void* data, size_t ladder_number, double seconds) {
+  (void) data;
+  const double progress[2] = {(double) ladder_number, seconds};
+  MPI_Send(progress, 2, MPI_DOUBLE, FIRST_PROCESS, PROGRESS_TAG
+      , MPI_COMM_WORLD);
+}
+
+void post_local_progress(void* data, size_t ladder_number, double seconds) {
+  local_worker_t* local_worker = (local_worker_t*) data;
+  mtx_lock(&local_worker->mutex);
+  local_worker->progress_ladder = (int) ladder_number;
+  local_worker->progress_seconds = seconds;
+  mtx_unlock(&local_worker->mutex);
+}
+
 int job_master_stop_workers(job_t* job, mpi_t* mpi) {
   int error = EXIT_SUCCESS;
   // Send stop signals to the other processes
   for (int process_number = FIRST_PROCESS + 1;
       process_number < mpi->process_count; ++process_number) {
     // Sending count indicates it has to end
-    error = mpiwrapper_send(&job->plates_count, 1, MPI_INT, process_number);
+    error = mpiwrapper_send(&job->ladders_count, 1, MPI_INT, process_number);
     if (error != EXIT_SUCCESS) return error;
   }
   return error;
 }
 
-int job_worker_process(job_t* job, uint64_t thread_count) {
+int job_worker_process(job_t* job) {
   int error = EXIT_SUCCESS;
-  // Keep waiting for plate to be assigned
-  while (true) {
-    // Obtain index to work on
-    int working_plate_idx = 0;
-    error = mpiwrapper_recv(&working_plate_idx, 1, MPI_INT, FIRST_PROCESS);
-    // If receive failed or the index sent is one out of range, return error
-    if (error != EXIT_SUCCESS || working_plate_idx >= job->plates_count) break;
+  const int result_size = get_result_size(job);
+  // Ladders sent ahead by the master, in the order they must be simulated
+  int* queue = (int*) calloc(job->options->prefetch + 1, sizeof(int));
+  char* result = (char*) malloc(result_size);
+  uint64_t* k_states = (uint64_t*) calloc(job->plates_count + 1
+      , sizeof(uint64_t));
+  if (!queue || !result || !k_states) {
+    perror("Error: Memory for epsilon ladders could not be allocated");
+    free(queue);
+    free(result);
+    free(k_states);
+    return ERR_LADDER_ALLOC;
+  }
 
-    // Process the plate
-    process_plate(job, working_plate_idx, thread_count);
+  // Estimates are sent by a simulating thread, while this one waits for it
+  int thread_support = MPI_THREAD_SINGLE;
+  MPI_Query_thread(&thread_support);
+  if (job->trace && thread_support >= MPI_THREAD_SERIALIZED) {
+    job->trace->progress = send_progress;
+  }
 
-    // First send index so the master process knows which one it is
-    error = mpiwrapper_send(&working_plate_idx, 1, MPI_INT, FIRST_PROCESS);
-    if (error != EXIT_SUCCESS) break;
+  int incoming_ladder_idx = 0;
+  MPI_Request request = MPI_REQUEST_NULL;
+  MPI_Irecv(&incoming_ladder_idx, 1, MPI_INT, FIRST_PROCESS, /*tag*/ 0
+      , MPI_COMM_WORLD, &request);
+  size_t queued = 0;
+  bool stopping = false;
+  while (error == EXIT_SUCCESS) {
+    // Take every ladder already sent, waiting only if there is none
+    while (!stopping) {
+      int received = 0;
+      const int result_code = queued == 0 ?
+          MPI_Wait(&request, MPI_STATUS_IGNORE)
+          : MPI_Test(&request, &received, MPI_STATUS_IGNORE);
+      if (result_code != MPI_SUCCESS) {
+        perror("Error: could not receive data");
+        error = ERR_MPI_RECV;
+        break;
+      }
+      if (queued > 0 && !received) break;
+      // An index out of range means it has to end
+      if (incoming_ladder_idx < 0
+          || (size_t) incoming_ladder_idx >= job->ladders_count) {
+        stopping = true;
+        break;
+      }
+      queue[queued++] = incoming_ladder_idx;
+      MPI_Irecv(&incoming_ladder_idx, 1, MPI_INT, FIRST_PROCESS, /*tag*/ 0
+          , MPI_COMM_WORLD, &request);
+    }
+    if (error != EXIT_SUCCESS || queued == 0) break;
 
-    // Send k states simulated for the assigned plate.
-    uint64_t k_states = job->plates[working_plate_idx]->k_states;
-    error = mpiwrapper_send(&k_states, 1, MPI_INT, FIRST_PROCESS);
-    if (error != EXIT_SUCCESS) break;
+    const int working_ladder_idx = queue[0];
+    memmove(queue, queue + 1, --queued * sizeof(int));
+    // The plate file of the next ladder is read by the kernel meanwhile
+    if (queued > 0) prefetch_ladder(job, queue[0]);
+
+    // Process the plates of the ladder
+    struct timespec start_time, finish_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    process_ladder(job, working_ladder_idx);
+    clock_gettime(CLOCK_MONOTONIC, &finish_time);
+
+    // Index, seconds and states of every plate travel in a single message
+    const int packed_size = pack_result(job, working_ladder_idx
+        , get_elapsed_seconds(&start_time, &finish_time), k_states, result
+        , result_size);
+    if (MPI_Send(result, packed_size, MPI_PACKED, FIRST_PROCESS, RESULT_TAG
+        , MPI_COMM_WORLD) != MPI_SUCCESS) {
+      perror("Error: could not send data");
+      error = ERR_MPI_SEND;
+    }
   }
+  if (request != MPI_REQUEST_NULL) {
+    MPI_Cancel(&request);
+    MPI_Request_free(&request);
+  }
+  free(queue);
+  free(result);
+  free(k_states);
   return error;
 }
 
-int process_plates(job_t* job, uint64_t thread_count) {
-  // Process every single plate registered. Do this when only one process is
+void prefetch_ladder(job_t* job, size_t ladder_number) {
+  char* plate_file_path = build_file_path(job->source_directory
+      , get_plate_name(&job->job_file, job->ladder_plates[
+      job->ladder_starts[ladder_number]]));
+  if (plate_file_path) prefetch_plate_file(plate_file_path);
+  free(plate_file_path);
+}
+
+int process_plates(job_t* job) {
+  // Process every single ladder registered. Do this when only one process is
   // running
-  for (uint64_t plate_number = 0; plate_number < job->plates_count;
-       ++plate_number) {
-    process_plate(job, plate_number, thread_count);
+  for (size_t ladder_number = 0; ladder_number < job->ladders_count;
+       ++ladder_number) {
+    process_ladder(job, ladder_number);
   }
   return EXIT_SUCCESS;
 }
 
-int process_plate(job_t* job, uint64_t plate_number, uint64_t thread_count) {
+int process_ladder(job_t* job, size_t ladder_number) {
+  int error = EXIT_SUCCESS;
+  // Each plate continues from the matrix and states of the previous one
+  plate_t plate;
+  memset(&plate, 0, sizeof(plate_t));
+  plate.trace = job->trace;
+  // Threads add up their time in every plate of the ladder, as its states
+  if (job->options->stats && job->options->balance == BALANCE_STEAL
+      && !job->decomposition) {
+    plate.balance = (thread_balance_t*) calloc(job->options->thread_count
+        , sizeof(thread_balance_t));
+    if (!plate.balance) {
+      fprintf(stderr, "Error: Could not allocate balance statistics\n");
+      return ERR_KERNEL_ALLOC;
+    }
+  }
+  if (job->trace) {
+    // Estimates are made for the last rung, the smallest epsilon
+    job->trace->ladder_number = ladder_number;
+    job->trace->target_epsilon = job->job_file.epsilons[job->ladder_plates[
+        job->ladder_starts[ladder_number + 1] - 1]];
+  }
+  bool continued = false;
+  for (size_t position = job->ladder_starts[ladder_number];
+      position < job->ladder_starts[ladder_number + 1]; ++position) {
+    const size_t plate_number = job->ladder_plates[position];
+    set_plate_parameters(job, plate_number, &plate);
+    // Plates finished before an interruption are not simulated again, the
+    // next one continues from their plate file
+    if (job->options->resume && !job->decomposition
+        && resume_finished_plate(job, plate_number, &plate)) {
+      if (plate.plate_matrix) {
+        destroy_plate_matrix(plate.plate_matrix);
+        plate.plate_matrix = NULL;
+      }
+    } else {
+      error = job->decomposition ?
+          process_plate_decomposed(job, plate_number, &plate, continued)
+          : process_plate(job, plate_number, &plate, continued);
+    }
+    job->job_file.k_states[plate_number] = plate.k_states;
+    continued = true;
+    if (error != EXIT_SUCCESS) break;
+    // Its line is written while the next plates are simulated
+    if (job->report_writer) report_plate(job->report_writer, plate_number);
+  }
+
+  // Deallocate memory so other ladders have space for their matrices
+  if (plate.plate_matrix) destroy_plate_matrix(plate.plate_matrix);
+  free(plate.balance);
+  return error;
+}
+
+int process_plate(job_t* job, uint64_t plate_number, plate_t* curr_plate
+    , bool continued) {
   int error = EXIT_SUCCESS;
-  // Get current plate
-  plate_t* curr_plate = job->plates[plate_number];
+  // Plate files are timed to compare io modes
+  struct timespec io_start_time, io_finish_time;
+  double read_time = 0;
+  clock_gettime(CLOCK_MONOTONIC, &io_start_time);
+
+  // Matrix is taken over at the state where the greater epsilon stopped, but
+  // previous plates finished before an interruption only left their file
+  bool loaded = !curr_plate->plate_matrix;
+  if (loaded) {
+    // Create plate's plate matrix: read plate file and store temperatures
+    error = continued ?
+        read_plate_output(curr_plate, job->source_directory, job->options->io)
+        : set_plate_matrix(curr_plate, job->source_directory
+        , job->plate_cache, job->options->io);
+    if (error != EXIT_SUCCESS) {
+      if (curr_plate->plate_matrix) {
+        destroy_plate_matrix(curr_plate->plate_matrix);
+      }
+      curr_plate->plate_matrix = NULL;
+      return error;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &io_finish_time);
+    read_time = get_elapsed_seconds(&io_start_time, &io_finish_time);
+  }
 
-  // Create plate's plate matrix: read plate file and store temperatures
-  error = set_plate_matrix(curr_plate, job->source_directory);
-  if (error != EXIT_SUCCESS) {
-    destroy_plate_matrix(curr_plate->plate_matrix);
-    return error;
+  // Checkpoint of an interrupted run may be ahead of the current state
+  if (job->options->resume && resume_checkpoint(job, plate_number
+      , curr_plate)) {
+    loaded = true;
+  }
+
+  // Rows are moved to pages first touched by the threads that update them
+  if (loaded && job->options->numa
+      && place_plate_matrix(curr_plate->plate_matrix, job->options
+      , job->options->kernel != KERNEL_INPLACE
+      && job->options->solver == SOLVER_JACOBI) != EXIT_SUCCESS) {
+    fprintf(stderr, "Error: Could not place plate matrix\n");
+    return ERR_KERNEL_ALLOC;
   }
 
   // Record start time
   struct timespec start_time, finish_time;
   clock_gettime(CLOCK_MONOTONIC, &start_time);
+  const uint64_t first_state = curr_plate->k_states;
+  begin_plate_trace(job, plate_number, curr_plate);
 
-  equilibrate_plate(curr_plate, thread_count);
+  // The state where the greater epsilon stopped may already be equilibrated
+  // for this one, since equilibrium is the first state within epsilon
+  if (!continued || curr_plate->max_delta > curr_plate->epsilon) {
+    error = equilibrate_checkpointed(job, plate_number, curr_plate);
+    if (error != EXIT_SUCCESS) return error;
+  }
 
   // Record end time
   clock_gettime(CLOCK_MONOTONIC, &finish_time);
 
   // Set elapsed time
   double elapsed_time = get_elapsed_seconds(&start_time, &finish_time);
+  end_plate_trace(job, curr_plate);
 
   // Report elapsed time
   printf("Equilibrated plate %zu in: %.9lfs\n", plate_number, elapsed_time);
+  job->job_file.seconds[plate_number] = elapsed_time;
+
+  // Report memory traffic of the kernel, to compare kernels
+  if (job->options->stats && job->options->solver != SOLVER_JACOBI) {
+    const plate_matrix_t* plate_matrix = curr_plate->plate_matrix;
+    printf("Plate %zu: %s solver, %" PRIu64 " iterations, residual %.3g, %.1lf"
+        " bytes/iteration", plate_number
+        , get_solver_name(job->options->solver), curr_plate->k_states
+        , curr_plate->max_delta
+        , (double) curr_plate->moved_bytes / curr_plate->k_states);
+    if (job->options->solver == SOLVER_SOR) {
+      printf(", omega %.6f\n", job->options->omega > 0 ? job->options->omega
+          : get_sor_omega(plate_matrix->rows, plate_matrix->cols));
+    } else {
+      printf(", %" PRIu64 " levels\n"
+          , count_multigrid_levels(plate_matrix->rows, plate_matrix->cols));
+    }
+  } else if (job->options->stats) {
+    printf("Plate %zu: %s kernel, %" PRIu64 " states, %.1lf bytes/state\n"
+        , plate_number, get_kernel_name(job->options->kernel)
+        , curr_plate->k_states
+        , (double) curr_plate->moved_bytes / curr_plate->k_states);
+    if (job->options->numa) {
+      report_numa_bandwidth(plate_number, curr_plate->plate_matrix
+          , curr_plate->k_states - first_state, elapsed_time);
+    }
+    if (job->options->precision != PRECISION_DOUBLE) {
+      printf("Plate %zu: %s precision, %" PRIu64 " float states, %" PRIu64
+          " double states\n", plate_number
+          , get_precision_name(job->options->precision)
+          , curr_plate->float_states
+          , curr_plate->k_states - curr_plate->float_states);
+    }
+    if (job->options->kernel == KERNEL_ACTIVE) {
+      report_skipped_tiles(plate_number, curr_plate);
+    }
+    if (curr_plate->balance && job->options->kernel == KERNEL_SWEEP) {
+      report_balance(plate_number, curr_plate, job->options->thread_count);
+    }
+    if (job->options->check_states != 1
+        && job->options->kernel == KERNEL_SWEEP
+        && job->options->balance == BALANCE_STATIC) {
+      printf("Plate %zu: %" PRIu64 " states checked, %" PRIu64
+          " states simulated again\n", plate_number, curr_plate->checks
+          , curr_plate->replayed_states);
+    }
+  }
+
+  if (job->options->solver == SOLVER_JACOBI
+      && job->options->precision != PRECISION_DOUBLE
+      && job->options->precision_reference) {
+    error = report_precision_reference(job, plate_number, curr_plate);
+    if (error != EXIT_SUCCESS) return error;
+  }
+  if (job->options->solver != SOLVER_JACOBI
+      && job->options->solver_reference) {
+    error = report_solver_reference(job, plate_number, curr_plate);
+    if (error != EXIT_SUCCESS) return error;
+  }
+
+  // Create an updated plate file with final temperatures
+  clock_gettime(CLOCK_MONOTONIC, &io_start_time);
+  error = update_plate_file(curr_plate, job->source_directory
+      , job->options->io);
+  clock_gettime(CLOCK_MONOTONIC, &io_finish_time);
+
+  // Plate file is complete, an interrupted run no longer simulates the plate
+  if (job->checkpoint_writer && error == EXIT_SUCCESS) {
+    record_finished_plate(job, plate_number, curr_plate);
+  }
 
-  clean_plate(job, plate_number);
+  if (job->options->stats && error == EXIT_SUCCESS) {
+    printf("Plate %zu: %s io, read in %.9lfs, written in %.9lfs\n"
+        , plate_number, get_io_name(job->options->io), read_time
+        , get_elapsed_seconds(&io_start_time, &io_finish_time));
+  }
   return error;
 }
 
 
-int clean_plate(job_t* job, size_t plate_number) {
-  plate_t* curr_plate = job->plates[plate_number];
-  // Create an updated plate file with final temperatures
-  int error = update_plate_file(curr_plate, job->source_directory);
-  if (error != EXIT_SUCCESS) {
-    destroy_job(job);
-    return error;
+int process_plate_decomposed(job_t* job, uint64_t plate_number
+    , plate_t* curr_plate, bool continued) {
+  int error = EXIT_SUCCESS;
+  decomposition_t* decomposition = job->decomposition;
+  const bool reporting = decomposition->process_number == FIRST_PROCESS;
+
+  // Each process continues its own rows at the state of the greater epsilon
+  if (!continued) {
+    error = read_plate_block(curr_plate, job->source_directory
+        , decomposition);
+    if (error != EXIT_SUCCESS) return error;
   }
 
-  // Deallocate memory so other plates have space for their matrices
-  destroy_plate_matrix(curr_plate->plate_matrix);
-  return EXIT_SUCCESS;
+  struct timespec start_time, finish_time;
+  clock_gettime(CLOCK_MONOTONIC, &start_time);
+  const double first_exchange_seconds = decomposition->exchange_seconds;
+  begin_plate_trace(job, plate_number, curr_plate);
+
+  // Maximum change is reduced among processes, so all of them agree here
+  if (!continued || curr_plate->max_delta > curr_plate->epsilon) {
+    error = equilibrate_plate_decomposed(curr_plate, job->options
+        , decomposition);
+    if (error != EXIT_SUCCESS) return error;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &finish_time);
+  const double elapsed_time = get_elapsed_seconds(&start_time, &finish_time);
+  job->job_file.seconds[plate_number] = elapsed_time;
+  end_plate_trace(job, curr_plate);
+  if (reporting) {
+    printf("Equilibrated plate %zu in: %.9lfs\n", plate_number, elapsed_time);
+  }
+  if (reporting && job->options->stats) {
+    printf("Plate %zu: split among %d processes, %" PRIu64 " states, %.9lfs"
+        " exchanging halos\n", plate_number, decomposition->active_count
+        , curr_plate->k_states
+        , decomposition->exchange_seconds - first_exchange_seconds);
+  }
+
+  return write_plate_decomposed(curr_plate, job->source_directory
+      , job->options->io, decomposition);
 }
 
+int report_precision_reference(job_t* job, uint64_t plate_number
+    , const plate_t* curr_plate) {
+  // Same plate and parameters, simulated from its initial temperatures
+  plate_t reference = *curr_plate;
+  reference.plate_matrix = NULL;
+  reference.k_states = 0;
+  reference.moved_bytes = 0;
+  reference.max_delta = 0;
+  reference.float_states = 0;
+  reference.checks = 0;
+  reference.replayed_states = 0;
+  reference.trace = NULL;
+  reference.balance = NULL;
+
+  options_t double_options = *job->options;
+  double_options.precision = PRECISION_DOUBLE;
+
+  int error = set_plate_matrix(&reference, job->source_directory
+      , job->plate_cache, job->options->io);
+  if (error == EXIT_SUCCESS) {
+    error = equilibrate_plate(&reference, &double_options);
+  }
+  if (error == EXIT_SUCCESS) {
+    printf("Plate %zu: %s precision, %" PRIu64 " states, double reference %"
+        PRIu64 " states, difference %+" PRId64 "\n", plate_number
+        , get_precision_name(job->options->precision), curr_plate->k_states
+        , reference.k_states
+        , (int64_t) (curr_plate->k_states - reference.k_states));
+  }
+  if (reference.plate_matrix) destroy_plate_matrix(reference.plate_matrix);
+  return error;
+}
 
-int report_results(job_t* job) {
-  int error = EXIT_SUCCESS;
-  char* results_file_path = build_report_file_path(job);
+int report_solver_reference(job_t* job, uint64_t plate_number
+    , const plate_t* curr_plate) {
+  // Same plate and parameters, simulated from its initial temperatures
+  plate_t reference = *curr_plate;
+  reference.plate_matrix = NULL;
+  reference.k_states = 0;
+  reference.moved_bytes = 0;
+  reference.max_delta = 0;
+  reference.float_states = 0;
+  reference.checks = 0;
+  reference.replayed_states = 0;
+  reference.trace = NULL;
+  reference.balance = NULL;
+
+  options_t jacobi_options = *job->options;
+  jacobi_options.solver = SOLVER_JACOBI;
+  jacobi_options.precision = PRECISION_DOUBLE;
 
-  if (!results_file_path) {
-    perror("Error: Results file path could not be built");
-    return ERR_RESULTS_FILE_PATH;
+  struct timespec start_time, finish_time;
+  int error = set_plate_matrix(&reference, job->source_directory
+      , job->plate_cache, job->options->io);
+  clock_gettime(CLOCK_MONOTONIC, &start_time);
+  if (error == EXIT_SUCCESS) {
+    error = equilibrate_plate(&reference, &jacobi_options);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &finish_time);
+  if (error == EXIT_SUCCESS) {
+    printf("Plate %zu: %s solver, %" PRIu64 " iterations in %.9lfs, residual"
+        " %.3g; jacobi %" PRIu64 " states in %.9lfs, residual %.3g; largest"
+        " difference %.3g\n", plate_number
+        , get_solver_name(job->options->solver), curr_plate->k_states
+        , job->job_file.seconds[plate_number], curr_plate->max_delta
+        , reference.k_states, get_elapsed_seconds(&start_time, &finish_time)
+        , get_plate_residual(&reference, job->options)
+        , get_largest_difference(curr_plate->plate_matrix
+        , reference.plate_matrix));
   }
+  if (reference.plate_matrix) destroy_plate_matrix(reference.plate_matrix);
+  return error;
+}
+
+int equilibrate_checkpointed(job_t* job, uint64_t plate_number
+    , plate_t* plate) {
+  const options_t* options = job->options;
+  if (!job->checkpoint_writer) return equilibrate_plate(plate, options);
+
+  char* checkpoint_path = build_checkpoint_path(job->file_name, plate_number);
+  if (!checkpoint_path) {
+    perror("Error: Could not build checkpoint path");
+    return ERR_BUILD_OUTPUT_FILE_NAME;
+  }
+
+  struct timespec checkpoint_time, chunk_start_time, now;
+  clock_gettime(CLOCK_MONOTONIC, &checkpoint_time);
+  uint64_t checkpoint_state = plate->k_states;
+  // Timed checkpoints measure the speed of the kernel with a single state
+  uint64_t chunk_states = options->checkpoint_states > 0 ?
+      options->checkpoint_states : 1;
 
-  // Open results file for writing
-  FILE* results_file = fopen(results_file_path, "w");
+  int error = EXIT_SUCCESS;
+  while (true) {
+    const uint64_t chunk_start = plate->k_states;
+    clock_gettime(CLOCK_MONOTONIC, &chunk_start_time);
+    plate->stop_state = chunk_start + chunk_states;
+    error = equilibrate_plate(plate, options);
+    plate->stop_state = 0;
+    // Kernels stop before the stop state only when equilibrated
+    if (error != EXIT_SUCCESS || plate->max_delta <= plate->epsilon) break;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const uint64_t pending_states = plate->k_states - checkpoint_state;
+    double pending_seconds = get_elapsed_seconds(&checkpoint_time, &now);
+    if ((options->checkpoint_states > 0
+        && pending_states >= options->checkpoint_states)
+        || (options->checkpoint_seconds > 0
+        && pending_seconds >= options->checkpoint_seconds)) {
+      checkpoint_header_t header;
+      set_checkpoint_header(plate, plate_number, &header);
+      submit_checkpoint(job->checkpoint_writer, checkpoint_path, &header
+          , plate->plate_matrix->matrix);
+      checkpoint_time = now;
+      checkpoint_state = plate->k_states;
+      pending_seconds = 0;
+    }
 
-  if (results_file) {
-    for (size_t plate_number = 0; plate_number < job->plates_count;
-       ++plate_number) {
-      write_result(job, results_file, plate_number);
+    // Next chunk ends at the next checkpoint, whichever comes first
+    chunk_states = options->checkpoint_states > 0 ? options->checkpoint_states
+        - (plate->k_states - checkpoint_state) : UINT64_MAX;
+    if (options->checkpoint_seconds > 0) {
+      const double chunk_seconds = get_elapsed_seconds(&chunk_start_time
+          , &now);
+      const double states_per_second = chunk_seconds > 0 ?
+          (plate->k_states - chunk_start) / chunk_seconds : 1;
+      const double timed_states = (options->checkpoint_seconds
+          - pending_seconds) * states_per_second;
+      if (timed_states < chunk_states) {
+        chunk_states = timed_states >= 1 ? (uint64_t) timed_states : 1;
+      }
     }
+  }
+  free(checkpoint_path);
+  return error;
+}
 
-    printf("Results stored in: %s\n", results_file_path);
-    fclose(results_file);
-  } else {
-    perror("Error: Could not open results file");
-    error = ERR_OPEN_RESULTS_FILE;
+bool resume_checkpoint(job_t* job, uint64_t plate_number, plate_t* plate) {
+  plate_matrix_t* plate_matrix = plate->plate_matrix;
+  char* checkpoint_path = build_checkpoint_path(job->file_name, plate_number);
+  if (!checkpoint_path) return false;
+
+  checkpoint_header_t header;
+  double* temperatures = NULL;
+  const bool resumed = read_checkpoint(checkpoint_path, plate_number
+      , plate->epsilon, &header, &temperatures) && !header.finished
+      && header.k_states > plate->k_states && header.rows == plate_matrix->rows
+      && header.cols == plate_matrix->cols;
+  if (resumed) {
+    memcpy(plate_matrix->matrix, temperatures
+        , header.rows * header.cols * sizeof(double));
+    plate->k_states = header.k_states;
+    plate->moved_bytes = header.moved_bytes;
+    plate->float_states = header.float_states;
+    plate->max_delta = header.max_delta;
+    printf("Plate %zu: resumed from checkpoint at state %" PRIu64 "\n"
+        , plate_number, plate->k_states);
+  }
+  free(temperatures);
+  free(checkpoint_path);
+  return resumed;
+}
+
+bool resume_finished_plate(job_t* job, uint64_t plate_number
+    , plate_t* plate) {
+  char* checkpoint_path = build_checkpoint_path(job->file_name, plate_number);
+  if (!checkpoint_path) return false;
+
+  checkpoint_header_t header;
+  double* temperatures = NULL;
+  const bool finished = read_checkpoint(checkpoint_path, plate_number
+      , plate->epsilon, &header, &temperatures) && header.finished;
+  if (finished) {
+    plate->k_states = header.k_states;
+    plate->moved_bytes = header.moved_bytes;
+    plate->float_states = header.float_states;
+    plate->max_delta = header.max_delta;
+    printf("Plate %zu: finished before interruption at state %" PRIu64 "\n"
+        , plate_number, plate->k_states);
+  }
+  free(temperatures);
+  free(checkpoint_path);
+  return finished;
+}
+
+void record_finished_plate(job_t* job, uint64_t plate_number
+    , const plate_t* plate) {
+  char* checkpoint_path = build_checkpoint_path(job->file_name, plate_number);
+  if (!checkpoint_path) return;
+
+  checkpoint_header_t header;
+  set_checkpoint_header(plate, plate_number, &header);
+  header.finished = 1;
+  header.rows = 0;
+  header.cols = 0;
+  // A checkpoint of the plate still being written would replace the record
+  wait_checkpoint_writer(job->checkpoint_writer);
+  write_checkpoint(checkpoint_path, &header, NULL);
+  free(checkpoint_path);
+}
+
+void set_checkpoint_header(const plate_t* plate, uint64_t plate_number
+    , checkpoint_header_t* header) {
+  memset(header, 0, sizeof(checkpoint_header_t));
+  memcpy(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic));
+  header->plate_number = plate_number;
+  header->k_states = plate->k_states;
+  header->moved_bytes = plate->moved_bytes;
+  header->float_states = plate->float_states;
+  header->max_delta = plate->max_delta;
+  header->epsilon = plate->epsilon;
+  header->rows = plate->plate_matrix ? plate->plate_matrix->rows : 0;
+  header->cols = plate->plate_matrix ? plate->plate_matrix->cols : 0;
+}
+
+void remove_checkpoints(job_t* job) {
+  for (size_t plate_number = 0; plate_number < job->plates_count;
+      ++plate_number) {
+    char* checkpoint_path = build_checkpoint_path(job->file_name
+        , plate_number);
+    if (!checkpoint_path) continue;
+    // Plates of other processes, or never checkpointed, have no file
+    remove(checkpoint_path);
+    free(checkpoint_path);
+  }
+}
+
+int start_report(job_t* job) {
+  char* results_file_path = build_report_file_path(job, "tsv");
+  char* sidecar_file_path = job->options->sidecar ?
+      build_report_file_path(job, "csv") : NULL;
+
+  int error = EXIT_SUCCESS;
+  if (!results_file_path || (job->options->sidecar && !sidecar_file_path)) {
+    perror("Error: Results file path could not be built");
+    error = ERR_RESULTS_FILE_PATH;
+  }
+  if (error == EXIT_SUCCESS) {
+    job->report_writer = (report_writer_t*) malloc(sizeof(report_writer_t));
+    error = job->report_writer ? init_report_writer(job->report_writer
+        , &job->job_file, results_file_path, sidecar_file_path)
+        : ERR_OPEN_RESULTS_FILE;
+    if (error != EXIT_SUCCESS) {
+      free(job->report_writer);
+      job->report_writer = NULL;
+    }
   }
 
   free(results_file_path);
+  free(sidecar_file_path);
   return error;
 }
 
-char* build_report_file_path(job_t* job) {
+void report_ladder(job_t* job, size_t ladder_number) {
+  for (size_t position = job->ladder_starts[ladder_number];
+      position < job->ladder_starts[ladder_number + 1]; ++position) {
+    report_plate(job->report_writer, job->ladder_plates[position]);
+  }
+}
+
+int report_results(job_t* job) {
+  // Lines of every plate were written while the job ran
+  const int error = destroy_report_writer(job->report_writer);
+  free(job->report_writer);
+  job->report_writer = NULL;
+  if (error != EXIT_SUCCESS) {
+    perror("Error: Could not write results file");
+    return ERR_OPEN_RESULTS_FILE;
+  }
+
+  char* results_file_path = build_report_file_path(job, "tsv");
+  if (results_file_path) {
+    printf("Results stored in: %s\n", results_file_path);
+  }
+  free(results_file_path);
+  return EXIT_SUCCESS;
+}
+
+int start_trace_file(job_t* job, int process_number) {
+  char extension[32];
+  snprintf(extension, sizeof(extension), "%d.trace.tsv", process_number);
+  char* trace_file_path = build_report_file_path(job, extension);
+  job->trace = (trace_t*) malloc(sizeof(trace_t));
+  if (!trace_file_path || !job->trace
+      || init_trace(job->trace, job->options->trace_states) != EXIT_SUCCESS) {
+    fprintf(stderr, "Error: Memory for trace could not be allocated\n");
+    free(trace_file_path);
+    free(job->trace);
+    job->trace = NULL;
+    return ERR_LADDER_ALLOC;
+  }
+
+  job->trace_file = fopen(trace_file_path, "w");
+  if (!job->trace_file
+      || fprintf(job->trace_file, "plate\tstate\tmax_delta\tseconds\n") < 0) {
+    fprintf(stderr, "Error: Could not open trace file %s\n", trace_file_path);
+    if (job->trace_file) fclose(job->trace_file);
+    job->trace_file = NULL;
+    destroy_trace(job->trace);
+    free(job->trace);
+    job->trace = NULL;
+    free(trace_file_path);
+    return ERR_OPEN_RESULTS_FILE;
+  }
+  free(trace_file_path);
+  return EXIT_SUCCESS;
+}
+
+void begin_plate_trace(job_t* job, size_t plate_number, const plate_t* plate) {
+  if (job->trace) start_trace(job->trace, plate_number, plate->k_states);
+}
+
+void end_plate_trace(job_t* job, const plate_t* plate) {
+  if (!job->trace) return;
+  finish_trace(job->trace, plate->k_states, plate->max_delta);
+  if (write_trace(job->trace_file, job->trace) != EXIT_SUCCESS) {
+    fprintf(stderr, "Error: Could not write trace of plate %zu\n"
+        , job->trace->plate_number);
+  }
+}
+
+char* build_report_file_path(job_t* job, const char* extension) {
   // Extract file name from job file path
   char* file_name = extract_file_name(job->file_name);
 
   if (!file_name) return NULL;
 
-  // Modify file extension to .tsv
-  char* file_name_tsv = modify_extension(file_name, "tsv");
+  // Modify file extension to the one of the report
+  char* file_name_tsv = modify_extension(file_name, extension);
 
   if (!file_name_tsv) {
     free(file_name);
@@ -400,35 +1577,3 @@ char* build_report_file_path(job_t* job) {
   free(file_name_tsv);
   return results_file_path;
 }
-
-void write_result(job_t* job, FILE* results_file, int plate_number) {
-  plate_t* plate = job->plates[plate_number];  // Obtain plate
-  // Calculate the time
-  time_t simulated_seconds = plate->k_states * plate->interval_duration;
-  char formatted_time[50];
-  format_time(simulated_seconds, formatted_time, 50);
-  // Print the results into the file
-  fprintf(results_file, "%-10s\t%9" PRIu64 "\t%8.6lg\t%6.6lg\t%6.6lg\t%6"
-      PRIu64 "\t%-48s\n",
-      plate->file_name,
-      plate->interval_duration,
-      plate->thermal_diffusivity,
-      plate->cells_dimension,
-      plate->epsilon,
-      plate->k_states,
-      formatted_time);
-}
-
-// CODE PROVIDED IN HOMEWORK DETAILS, MODIFIED TO APPEAL TO LINTER
-// Modifications credits to Albin Monge (gmtime_r part)
-// Return parameter text must have at least 48 chars (YYYY/MM/DD hh:mm:ss)
-char* format_time(const time_t seconds, char* text, const size_t capacity) {
-  // Convert seconds to UTC time
-  struct tm gmt_r;  // For gmtime_r usage, which is threadsafe
-  struct tm* gmt = gmtime_r(&seconds, &gmt_r);
-  // Format time as string
-  snprintf(text, capacity, "%04d/%02d/%02d\t%02d:%02d:%02d", gmt->tm_year
-    - 70, gmt->tm_mon, gmt->tm_mday - 1, gmt->tm_hour,
-    gmt->tm_min, gmt->tm_sec);
-  return text;
-}
@@ -11,25 +11,39 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include "checkpoint.h"
 #include "common.h"
+#include "decomposition.h"
 #include "errors.h"
+#include "job_file.h"
+#include "options.h"
+#include "placement.h"
 #include "plate.h"
+#include "report_writer.h"
 #include "threads.h"
+#include "trace.h"
 
 #include "mpi_wrapper.h"
 
-/** @brief Initial capacity for plates allocation. */
-#define STARTING_CAPACITY 50
-
-/** @brief Maximum file name size. */
-#define MAX_FILE_NAME_SIZE 256
-
 /** @brief Folder name for report files. */
 #define REPORTS_DIRECTORY "reports"
 
 /** @brief First process ID */
 #define FIRST_PROCESS 0
 
+/** @brief Tag of the results sent by workers to the master */
+#define RESULT_TAG 2
+
+/** @brief Tag of the estimates workers send while they simulate a ladder */
+#define PROGRESS_TAG 3
+
+/** @brief With a trace, ladders are sent ahead to a worker only if the ones
+ * it has are expected to finish within these seconds */
+#define PREFETCH_HORIZON_SECONDS (2 * TRACE_PROGRESS_SECONDS)
+
+/** @brief Nanoseconds the dispatcher sleeps when no worker has finished */
+#define DISPATCH_POLL_NANOSECONDS 200000
+
 /**
  * @struct job_t
  * @brief Represents a job containing multiple plates.
@@ -38,37 +52,98 @@ typedef struct {
     char* file_name;        /**< Job file name. */
     char* source_directory; /**< Directory containing job files. */
     size_t plates_count;    /**< Number of plates. */
-    size_t plates_capacity; /**< Capacity of plates array. */
-    plate_t** plates;       /**< Array of plate pointers. */
+    job_file_t job_file;    /**< Parameters, states and names of plates. */
+    const options_t* options; /**< Options given in the command line. */
+    plate_cache_t* plate_cache; /**< Plate files read, NULL if disabled. */
+    size_t ladders_count;   /**< Number of epsilon ladders. */
+    uint64_t* ladder_plates; /**< Plate numbers of each ladder, by epsilon. */
+    uint64_t* ladder_starts; /**< Start of each ladder in ladder_plates. */
+    checkpoint_writer_t* checkpoint_writer; /**< NULL if disabled. */
+    decomposition_t* decomposition; /**< NULL if plates are not split. */
+    report_writer_t* report_writer; /**< NULL except in the first process. */
+    trace_t* trace;         /**< Maximum change samples, NULL if disabled. */
+    FILE* trace_file;       /**< Samples of the plates of this process. */
 } job_t;
 
+/**
+ * @struct local_result_t
+ * @brief Ladder simulated by the local worker of the first process.
+ */
+typedef struct {
+  int ladder_idx;  ///< Ladder simulated
+  double seconds;  ///< Seconds the ladder took
+} local_result_t;
+
+/**
+ * @struct local_worker_t
+ * @brief Queues between the dispatcher thread of the first process and the
+ * threads of the same process that simulate ladders as another worker.
+ */
+typedef struct {
+  job_t* job;                ///< Job being simulated
+  mpi_t* mpi;                ///< Processes of the job
+  mtx_t mutex;               ///< Protects both queues and stopping
+  cnd_t changed;             ///< Signaled when ladders are queued or stopping
+  int* ladders;              ///< Ladders sent to the local worker, in order
+  size_t queued;             ///< Ladders in the ladders queue
+  local_result_t* results;   ///< Ladders finished, not yet dispatched
+  size_t finished;           ///< Results in the results queue
+  bool stopping;             ///< True when no more ladders will be queued
+  int error;                 ///< Error of the dispatcher
+  int progress_ladder;       ///< Ladder of a new estimate, -1 if none
+  double progress_seconds;   ///< Seconds the ladder is expected to take yet
+} local_worker_t;
+
 /**
  * @brief Initializes a job from a given job file name.
  * @param job_file_name Name of the job file.
+ * @param options Options used to simulate the job's plates.
  * @return Pointer to the initialized job, or NULL on failure.
  */
-job_t* init_job(char* job_file_name);
+job_t* init_job(char* job_file_name, const options_t* options);
 
 /**
  * @brief Sets up a job by reading plates from a file.
+ *
+ * The first process parses the job file, validates the plate files it
+ * refers to and builds the epsilon ladders, then sends the table of plates
+ * to the other processes. Plates have no allocation of their own, their
+ * parameters and states are in the table.
+ *
  * @param job Pointer to the job structure.
+ * @param process_number Number of this process.
  * @return EXIT_SUCCESS on success, error code on failure.
  */
-int set_job(job_t* job);
+int set_job(job_t* job, int process_number);
 
 /**
- * @brief Checks if job needs expansion and expands if necessary.
- * @param job Pointer to the job structure.
- * @return EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ * @brief Sets the parameters of a plate from the table of the job, keeping
+ * its matrix and states.
+ *
+ * Plates of a ladder are simulated with a single plate_t, so each one
+ * continues from the matrix and states of the previous one.
+ *
+ * @param job Job with the table of plates
+ * @param plate_number Number of the plate in the job
+ * @param plate Plate to set
  */
-int check_capacity(job_t* job);
+void set_plate_parameters(const job_t* job, size_t plate_number
+    , plate_t* plate);
 
 /**
- * @brief Expands the job's plate capacity.
- * @param job Pointer to the job structure.
- * @return EXIT_SUCCESS on success, EXIT_FAILURE on failure.
+ * @brief Groups the job's plates into epsilon ladders.
+ *
+ * Plates with the same file, interval duration, thermal diffusivity and cells
+ * dimension only differ in epsilon, so they share the states simulated until
+ * the greater epsilons are reached. Each ladder has those plates sorted by
+ * decreasing epsilon, and ladders are sorted by their first plate in the job.
+ * If the epsilon ladder option is off, each plate is a ladder by itself.
+ * Ladders are stored in the table of plates.
+ *
+ * @param job Pointer to the job structure, with all of its plates.
+ * @return EXIT_SUCCESS on success, ERR_LADDER_ALLOC otherwise.
  */
-int expand_job(job_t* job);
+int set_epsilon_ladders(job_t* job);
 
 /**
  * @brief Destroys a job and frees allocated memory.
@@ -81,14 +156,19 @@ void destroy_job(job_t* job);
  * @brief Carries out simulation of each plate in an indicated job.
  * 
  * @param job_file_path path of job to simulate
- * @param thread_count amount of threads used to simulate
+ * @param options Options of the simulation, including the amount of threads
  * @return Success or failure of procedure
  */
-int simulate(char* job_file_path, uint64_t thread_count);
+int simulate(char* job_file_path, const options_t* options);
 
 /**
  * @brief First process' is job master, delegates work to workers in this 
  * procedure, until all plates are simulated
+ *
+ * If the master works option is on and MPI supports serialized threads, a
+ * dispatcher thread distributes ladders while the remaining threads of the
+ * first process simulate ladders from the same queue as one more worker.
+ * Otherwise, the first process only distributes ladders.
  * 
  * @param job Job with info for master to distribute work
  * @param mpi Mpi struct with process info
@@ -96,71 +176,261 @@ int simulate(char* job_file_path, uint64_t thread_count);
  */
 int job_master_process(job_t* job, mpi_t* mpi);
 
+/**
+ * @brief Distributes ladders among workers until all of them are simulated.
+ *
+ * Each worker is kept with up to the prefetch option of ladders sent. A
+ * receive of the packed result of every worker is kept pending, and the
+ * master replies to whichever completes first with MPI_Waitany. With a local
+ * worker, pending receives are polled with MPI_Testsome along with the local
+ * results queue instead, sleeping between polls while nothing finished.
+ *
+ * With a trace, workers also send the seconds their ladder is expected to
+ * take yet, estimated from the decay of its maximum change, and a ladder is
+ * only sent ahead to a worker expected to finish the ones it has within
+ * PREFETCH_HORIZON_SECONDS. So the last ladders of a job go to the workers
+ * that finish first, instead of waiting behind a long ladder.
+ *
+ * @param job Job with info for master to distribute work
+ * @param mpi Mpi struct with process info
+ * @param local_worker Local worker of the first process, NULL if none
+ * @return Success or failure of procedure
+ */
+int dispatch_ladders(job_t* job, mpi_t* mpi, local_worker_t* local_worker);
+
+/// @brief Runs dispatch_ladders in the dispatcher thread, then stops the
+/// local worker. Used with thrd_create
+int run_dispatcher(void* data);
+
+/// @brief Simulates the ladders queued to the local worker with all threads
+/// but the dispatcher one, until the dispatcher stops it
+void run_local_worker(local_worker_t* local_worker);
+
+/// @brief Sends the master the seconds the ladder of a worker process is
+/// expected to take yet. Progress function of its trace
+void send_progress(void* data, size_t ladder_number, double seconds);
+
+/// @brief Hands the dispatcher the seconds the ladder of the local worker is
+/// expected to take yet. Progress function of its trace
+void post_local_progress(void* data, size_t ladder_number, double seconds);
+
 /// @brief Iterates through worker processes' IDs and signals each to stop.
 /// @see job_master_process
 int job_master_stop_workers(job_t* job, mpi_t* mpi);
 
 /**
- * @brief Receives plate indexes to process and report back to master.
+ * @brief Receives ladder indexes to process and report back to master.
+ *
+ * Indexes sent ahead by the master are queued, and the plate file of the
+ * next queued ladder is prefetched while the current one is simulated.
  * 
  * @param job Job with info for worker to simulate plate
- * @param thread_count Amount of threads used to simulate the plate
  * @return Success or failure of procedure
  */
-int job_worker_process(job_t* job, uint64_t thread_count);
+int job_worker_process(job_t* job);
+
+/// @brief Returns the bytes of a packed result of the largest ladder
+int get_result_size(const job_t* job);
+
+/**
+ * @brief Packs the result of a ladder in a single message: its index, the
+ * seconds it took and the states of each of its plates.
+ *
+ * @param job Job with the states of the ladder
+ * @param ladder_idx Ladder simulated
+ * @param seconds Seconds the ladder took
+ * @param k_states Buffer for the states of the ladder
+ * @param result Buffer of get_result_size() bytes for the message
+ * @param result_size Bytes of the buffer
+ * @return Bytes of the packed message
+ */
+int pack_result(const job_t* job, int ladder_idx, double seconds
+    , uint64_t* k_states, char* result, int result_size);
+
+/**
+ * @brief Unpacks a result message, storing the states of its plates.
+ * @see pack_result
+ * @return Number of the ladder of the result
+ */
+size_t unpack_result(job_t* job, char* result, int result_size
+    , uint64_t* k_states, double* seconds);
+
+/// @brief Prefetches the plate file of the first plate of a ladder
+void prefetch_ladder(job_t* job, size_t ladder_number);
+
+/**
+ * @brief Loops through all of the epsilon ladders recorded to simulate.
+ * 
+ * @param job current working job
+ * @return Success or failure of processing
+ */
+int process_plates(job_t* job);
 
 /**
- * @brief Loops through all of the plates recorded to simulate.
+ * @brief Simulates the plates of an epsilon ladder in one continuous
+ * simulation, from the greatest epsilon to the smallest.
  * 
  * @param job current working job
- * @param thread_count Amount of threads available for use
+ * @param ladder_number Number of ladder to process
  * @return Success or failure of processing
  */
-int process_plates(job_t* job, uint64_t thread_count);
+int process_ladder(job_t* job, size_t ladder_number);
 
 /**
- * @brief Simulates heat transfer of one plate and reports duration
+ * @brief Simulates heat transfer of one plate, reports duration and records
+ * the updated plate file.
  * 
  * @param job current working job
  * @param plate_number Number of plate to process
- * @param thread_count Amount of threads available for simulation
+ * @param plate Plate with the parameters of the plate number. Its matrix
+ * and states are continued if it comes from a greater epsilon of the ladder
+ * @param continued True if the plate comes from a greater epsilon, false to
+ * read the plate
  * @return Success or failure of processing
  */
-int process_plate(job_t* job, uint64_t plate_number, uint64_t thread_count);
+int process_plate(job_t* job, uint64_t plate_number, plate_t* plate
+    , bool continued);
 
-/// @brief Carries out recording of updated plate and freeing of memory.
-/// @see equilibrate_plates
-/// @return if clean up if successful
-int clean_plate(job_t* job, size_t plate_number);
+/**
+ * @brief Simulates a plate again from its plate file in double precision,
+ * with the same kernel, to report how many states float or mixed precision
+ * differ from it.
+ *
+ * @param job current working job
+ * @param plate_number Number of plate already simulated
+ * @param plate Plate already simulated
+ * @return Success or failure of the reference simulation
+ */
+int report_precision_reference(job_t* job, uint64_t plate_number
+    , const plate_t* plate);
+
+/**
+ * @brief Simulates a plate again from its plate file with Jacobi states, to
+ * report the iterations, seconds and residual of the solver against them,
+ * and the largest difference between their temperatures.
+ *
+ * @param job current working job
+ * @param plate_number Number of plate already solved
+ * @param plate Plate already solved
+ * @return Success or failure of the reference simulation
+ */
+int report_solver_reference(job_t* job, uint64_t plate_number
+    , const plate_t* plate);
+
+/**
+ * @brief Processes a plate split by rows among all processes: every process
+ * reads its rows, all of them simulate the plate together, and the first
+ * process writes the plate file and reports it.
+ *
+ * @param job current working job, with the decomposition of this process
+ * @param plate_number Number of plate to process
+ * @param plate Plate with the parameters of the plate number
+ * @param continued True if the rows and states of the plate come from a
+ * greater epsilon of the ladder
+ * @return Success or failure of the simulation, the same in every process
+ */
+int process_plate_decomposed(job_t* job, uint64_t plate_number
+    , plate_t* plate, bool continued);
 
 /**
- * @brief Generates a report file from the job's simulation results.
+ * @brief Equilibrates a plate, handing a copy of its state to the checkpoint
+ * writer every N states or T seconds, as given in the options.
+ *
+ * The kernel is run in chunks that end at the next checkpoint. Timed
+ * checkpoints size chunks with the states per second of the previous chunk.
+ * Chunks continue exactly where the previous one stopped, so states and
+ * temperatures are the same as a single run of the kernel.
+ *
+ * @param job current working job
+ * @param plate_number Number of plate to equilibrate
+ * @param plate Plate to equilibrate
+ * @return Success or failure of the simulation
+ */
+int equilibrate_checkpointed(job_t* job, uint64_t plate_number
+    , plate_t* plate);
+
+/**
+ * @brief Continues a plate from its checkpoint, if it has a valid one of a
+ * later state than the current one.
+ *
+ * @param job current working job
+ * @param plate_number Number of plate
+ * @param plate Plate with its matrix already loaded
+ * @return True if the plate was moved to the state of its checkpoint
+ */
+bool resume_checkpoint(job_t* job, uint64_t plate_number, plate_t* plate);
+
+/**
+ * @brief Takes the states of a plate from its checkpoint if it was already
+ * equilibrated and written before the run was interrupted.
+ *
+ * @param job current working job
+ * @param plate_number Number of plate to check
+ * @param plate Plate whose states are set if it was finished
+ * @return True if the plate was finished, so it must not be simulated
+ */
+bool resume_finished_plate(job_t* job, uint64_t plate_number
+    , plate_t* plate);
+
+/**
+ * @brief Records that a plate was equilibrated and its plate file written,
+ * replacing its checkpoint with one without temperatures.
+ *
+ * @param job current working job
+ * @param plate_number Number of plate finished
+ * @param plate Plate finished
+ */
+void record_finished_plate(job_t* job, uint64_t plate_number
+    , const plate_t* plate);
+
+/// @brief Fills the header of a checkpoint with the state of a plate
+void set_checkpoint_header(const plate_t* plate, uint64_t plate_number
+    , checkpoint_header_t* header);
+
+/// @brief Removes the checkpoint files of every plate of a completed job
+void remove_checkpoints(job_t* job);
+
+/**
+ * @brief Starts the writer of the report of the job, and of its sidecar with
+ * the wall time of each plate if requested. Called by the first process.
+ * @param job Pointer to the job structure.
+ * @return EXIT_SUCCESS on success, error code otherwise.
+ */
+int start_report(job_t* job);
+
+/// @brief Reports every plate of a finished ladder to the report writer
+void report_ladder(job_t* job, size_t ladder_number);
+
+/**
+ * @brief Finishes the report file of the job, whose lines were written while
+ * its plates finished, and flushes it to disk.
  * @param job Pointer to the job structure.
  * @return EXIT_SUCCESS on success, EXIT_FAILURE on failure.
  */
 int report_results(job_t* job);
 
 /**
- * @brief Calls upon common functions to build the report file's paths.
+ * @brief Opens the trace file of a process, reports/job###.N.trace.tsv where
+ * N is the process number, and allocates the trace its plates share.
  * @param job Pointer to the job structure.
- * @return Report file path built.
+ * @param process_number Number of this process.
+ * @return EXIT_SUCCESS on success, error code otherwise.
  */
-char* build_report_file_path(job_t* job);
+int start_trace_file(job_t* job, int process_number);
 
-/// @brief Writes the results of a plate's simulation into a file
-/// @param job Pointer to job struct with the plates
-/// @param results_file Results file to report to
-/// @param plate_number Number of plate to extract data from
-void write_result(job_t* job, FILE* results_file, int plate_number);
+/// @brief Starts the trace of a plate about to be simulated, if enabled
+void begin_plate_trace(job_t* job, size_t plate_number, const plate_t* plate);
+
+/// @brief Samples the last state of a plate, and writes the samples of the
+/// plate to the trace file, if enabled
+void end_plate_trace(job_t* job, const plate_t* plate);
 
 /**
- * @brief Formats a time value into a human-readable string.
- * @param seconds Time in seconds.
- * @param text Buffer to store formatted time.
- * @param capacity Size of the buffer.
- * @return Pointer to formatted time string.
+ * @brief Calls upon common functions to build the report file's paths.
+ * @param job Pointer to the job structure.
+ * @param extension Extension of the report file, without its dot
+ * @return Report file path built.
  */
-char* format_time(const time_t seconds, char* text, const size_t capacity);
-
+char* build_report_file_path(job_t* job, const char* extension);
 
 #endif  // JOB_H
@@ -0,0 +1,344 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "job_file.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <mpi.h>
+#include <omp.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** @brief Longest number accepted in a job file */
+#define MAX_NUMBER_SIZE 64
+
+/** @brief Bytes broadcast at a time, below the int count of MPI_Bcast */
+#define BROADCAST_CHUNK_SIZE (1 << 30)
+
+/**
+ * @brief Allocates the buffer of a job file and points its arrays into it.
+ * @param job_file Job file to allocate
+ * @param plates_capacity Plates the arrays can hold
+ * @param names_capacity Bytes the names arena can hold
+ * @return EXIT_SUCCESS on success, ERR_PLATE_ALLOC otherwise.
+ */
+int allocate_job_file(job_file_t* job_file, uint64_t plates_capacity
+    , uint64_t names_capacity);
+
+/// @brief Returns the bytes of the buffer before the names arena
+size_t get_arrays_size(uint64_t plates_capacity);
+
+/**
+ * @brief Parses the plates of a mapped job file into its arrays.
+ * @param job_file Job file allocated for the lines of the file
+ * @param text Mapped job file
+ * @param size Bytes of the job file
+ * @return EXIT_SUCCESS on success, ERR_JOB_FILE_FORMAT otherwise.
+ */
+int parse_job_text(job_file_t* job_file, const char* text, size_t size);
+
+/**
+ * @brief Finds the next token of a line.
+ * @param text Mapped job file
+ * @param size Bytes of the job file
+ * @param position Where to start, updated to the end of the token
+ * @param skip_lines True to also skip line ends before the token
+ * @return Start of the token, its end is the updated position. Equal to the
+ * updated position if there are no more tokens in the line (or file).
+ */
+size_t find_token(const char* text, size_t size, size_t* position
+    , bool skip_lines);
+
+/// @brief Parses a token as an unsigned integer. Returns false if it is not
+bool parse_token_uint64(const char* token, size_t length, uint64_t* value);
+
+/// @brief Parses a token as a floating point number. Returns false if it is
+/// not
+bool parse_token_double(const char* token, size_t length, double* value);
+
+/**
+ * @brief Reads the rows and columns of a plate file.
+ * @param source_directory Directory containing the plate file
+ * @param file_name Name of the plate file
+ * @param rows Where the rows are stored
+ * @param cols Where the columns are stored
+ * @return EXIT_SUCCESS if the file holds all of its temperatures, error code
+ * otherwise.
+ */
+int read_plate_header(const char* source_directory, const char* file_name
+    , uint64_t* rows, uint64_t* cols);
+
+/// @brief Broadcasts bytes from the first process in chunks that fit MPI_Bcast
+int broadcast_bytes(char* bytes, size_t size);
+
+int read_job_file(job_file_t* job_file, const char* job_file_path) {
+  memset(job_file, 0, sizeof(job_file_t));
+  const int file = open(job_file_path, O_RDONLY);
+  struct stat file_stat;
+  if (file < 0 || fstat(file, &file_stat) != 0) {
+    perror("Error: Job file could not be opened");
+    if (file >= 0) close(file);
+    return ERR_JOB_FILE_NOT_FOUND;
+  }
+
+  const size_t size = (size_t) file_stat.st_size;
+  // Empty files cannot be mapped, and have no plates
+  const char* text = size > 0 ? (const char*) mmap(NULL, size, PROT_READ
+      , MAP_PRIVATE, file, 0) : NULL;
+  close(file);
+  if (text == MAP_FAILED) {
+    perror("Error: Job file could not be mapped");
+    return ERR_JOB_FILE_NOT_FOUND;
+  }
+  if (text) madvise((void*) text, size, MADV_SEQUENTIAL);
+
+  // Every plate takes a line, and its name is shorter than the file
+  uint64_t lines = 1;
+  const char* line_end = text;
+  while (line_end && (line_end = (const char*) memchr(line_end, '\n'
+      , size - (line_end - text)))) {
+    ++lines;
+    ++line_end;
+  }
+  int error = allocate_job_file(job_file, lines, size + 1);
+  if (error == EXIT_SUCCESS) error = parse_job_text(job_file, text, size);
+  if (text) munmap((void*) text, size);
+  if (error != EXIT_SUCCESS) destroy_job_file(job_file);
+  return error;
+}
+
+size_t get_arrays_size(uint64_t plates_capacity) {
+  // Header, then 10 arrays of 8 bytes values, and the ladder starts
+  return sizeof(job_file_header_t) + (plates_capacity * 11 + 1)
+      * sizeof(uint64_t);
+}
+
+int allocate_job_file(job_file_t* job_file, uint64_t plates_capacity
+    , uint64_t names_capacity) {
+  job_file->buffer = (char*) calloc(1, get_arrays_size(plates_capacity)
+      + names_capacity);
+  if (!job_file->buffer) {
+    perror("Error: Memory for job file could not be allocated");
+    return ERR_PLATE_ALLOC;
+  }
+
+  // Every array holds 8 bytes values, so all of them are aligned
+  job_file->header = (job_file_header_t*) job_file->buffer;
+  uint64_t* arrays = (uint64_t*) (job_file->buffer
+      + sizeof(job_file_header_t));
+  job_file->interval_durations = arrays;
+  job_file->thermal_diffusivities = (double*) (arrays + plates_capacity);
+  job_file->cells_dimensions = (double*) (arrays + 2 * plates_capacity);
+  job_file->epsilons = (double*) (arrays + 3 * plates_capacity);
+  job_file->rows = arrays + 4 * plates_capacity;
+  job_file->cols = arrays + 5 * plates_capacity;
+  job_file->name_offsets = arrays + 6 * plates_capacity;
+  job_file->k_states = arrays + 7 * plates_capacity;
+  job_file->seconds = (double*) (arrays + 8 * plates_capacity);
+  job_file->ladder_plates = arrays + 9 * plates_capacity;
+  job_file->ladder_starts = arrays + 10 * plates_capacity;
+  job_file->names = job_file->buffer + get_arrays_size(plates_capacity);
+  job_file->header->plates_capacity = plates_capacity;
+  job_file->header->names_capacity = names_capacity;
+  return EXIT_SUCCESS;
+}
+
+int parse_job_text(job_file_t* job_file, const char* text, size_t size) {
+  job_file_header_t* header = job_file->header;
+  size_t position = 0;
+  while (true) {
+    // Plates start with their file name, after any blank lines
+    const size_t name_start = find_token(text, size, &position, true);
+    if (name_start == position) break;
+    const size_t plate = header->plates_count;
+    const size_t name_length = position - name_start;
+    job_file->name_offsets[plate] = header->names_size;
+    memcpy(job_file->names + header->names_size, text + name_start
+        , name_length);
+    header->names_size += name_length + 1;
+
+    // Then its parameters, in the same line
+    bool valid = true;
+    for (int field = 0; field < 4 && valid; ++field) {
+      const size_t start = find_token(text, size, &position, false);
+      const size_t length = position - start;
+      if (field == 0) {
+        valid = parse_token_uint64(text + start, length
+            , &job_file->interval_durations[plate]);
+      } else {
+        double* values[] = {job_file->thermal_diffusivities
+            , job_file->cells_dimensions, job_file->epsilons};
+        valid = parse_token_double(text + start, length
+            , &values[field - 1][plate]);
+      }
+    }
+    // Nothing else is expected in the line
+    const size_t extra_start = find_token(text, size, &position, false);
+    if (!valid || extra_start != position) {
+      fprintf(stderr, "Error: Invalid line for plate %s in job file\n"
+          , get_plate_name(job_file, plate));
+      return ERR_JOB_FILE_FORMAT;
+    }
+    ++header->plates_count;
+  }
+  return EXIT_SUCCESS;
+}
+
+size_t find_token(const char* text, size_t size, size_t* position
+    , bool skip_lines) {
+  size_t start = *position;
+  while (start < size && (text[start] == ' ' || text[start] == '\t'
+      || text[start] == '\r' || (skip_lines && text[start] == '\n'))) {
+    ++start;
+  }
+  size_t end = start;
+  while (end < size && text[end] != ' ' && text[end] != '\t'
+      && text[end] != '\r' && text[end] != '\n') {
+    ++end;
+  }
+  *position = end;
+  return start;
+}
+
+bool parse_token_uint64(const char* token, size_t length, uint64_t* value) {
+  // Mapped text is not null terminated, so numbers are copied first
+  char number[MAX_NUMBER_SIZE];
+  if (length == 0 || length >= MAX_NUMBER_SIZE || token[0] < '0'
+      || token[0] > '9') {
+    return false;
+  }
+  memcpy(number, token, length);
+  number[length] = '\0';
+  char* end = NULL;
+  *value = strtoull(number, &end, 10);
+  return *end == '\0';
+}
+
+bool parse_token_double(const char* token, size_t length, double* value) {
+  char number[MAX_NUMBER_SIZE];
+  if (length == 0 || length >= MAX_NUMBER_SIZE) return false;
+  memcpy(number, token, length);
+  number[length] = '\0';
+  char* end = NULL;
+  *value = strtod(number, &end);
+  return *end == '\0';
+}
+
+int validate_job_plates(job_file_t* job_file, const char* source_directory
+    , uint64_t thread_count) {
+  const size_t count = job_file->header->plates_count;
+  int error = EXIT_SUCCESS;
+
+  // Plates of a ladder usually share their file in consecutive lines
+  #pragma omp parallel for num_threads(thread_count) default(none) \
+      shared(job_file, source_directory, count) reduction(max:error) \
+      schedule(dynamic, VALIDATION_CHUNK)
+  for (size_t plate = 0; plate < count; ++plate) {
+    if (plate == 0 || strcmp(get_plate_name(job_file, plate)
+        , get_plate_name(job_file, plate - 1)) != 0) {
+      const int plate_error = read_plate_header(source_directory
+          , get_plate_name(job_file, plate), &job_file->rows[plate]
+          , &job_file->cols[plate]);
+      if (plate_error > error) error = plate_error;
+    }
+  }
+
+  for (size_t plate = 1; plate < count; ++plate) {
+    if (strcmp(get_plate_name(job_file, plate)
+        , get_plate_name(job_file, plate - 1)) == 0) {
+      job_file->rows[plate] = job_file->rows[plate - 1];
+      job_file->cols[plate] = job_file->cols[plate - 1];
+    }
+  }
+  return error;
+}
+
+int read_plate_header(const char* source_directory, const char* file_name
+    , uint64_t* rows, uint64_t* cols) {
+  char* plate_file_path = build_file_path(source_directory, file_name);
+  const int plate_file = plate_file_path ? open(plate_file_path, O_RDONLY)
+      : -1;
+  free(plate_file_path);
+  if (plate_file < 0) {
+    fprintf(stderr, "Error: Plate file %s could not be opened\n", file_name);
+    return ERR_OPEN_PLATE_FILE;
+  }
+
+  uint64_t dimensions[2] = {0, 0};
+  struct stat file_stat;
+  const bool read = pread(plate_file, dimensions, sizeof(dimensions), 0)
+      == (ssize_t) sizeof(dimensions) && fstat(plate_file, &file_stat) == 0;
+  close(plate_file);
+  // Temperatures must be in the file, or reading them would fail later
+  const size_t cells = read ? ((size_t) file_stat.st_size
+      - sizeof(dimensions)) / sizeof(double) : 0;
+  if (!read || dimensions[0] == 0 || dimensions[1] == 0
+      || cells / dimensions[1] < dimensions[0]) {
+    fprintf(stderr, "Error: Rows and cols of plate file %s could not be"
+        " read\n", file_name);
+    return ERR_ROWS_COLS;
+  }
+  *rows = dimensions[0];
+  *cols = dimensions[1];
+  return EXIT_SUCCESS;
+}
+
+int broadcast_job_file(job_file_t* job_file, int process_number, int error) {
+  // Other processes stop too if the first one could not parse the job file
+  if (MPI_Bcast(&error, 1, MPI_INT, 0, MPI_COMM_WORLD) != MPI_SUCCESS) {
+    perror("Error: could not broadcast job file");
+    return ERR_MPI_RECV;
+  }
+  if (error != EXIT_SUCCESS) return error;
+
+  job_file_header_t header;
+  if (process_number == 0) header = *job_file->header;
+  if (MPI_Bcast(&header, sizeof(job_file_header_t), MPI_BYTE, 0
+      , MPI_COMM_WORLD) != MPI_SUCCESS) {
+    perror("Error: could not broadcast job file");
+    return ERR_MPI_RECV;
+  }
+
+  // Other processes only need room for the names used
+  if (process_number != 0) {
+    memset(job_file, 0, sizeof(job_file_t));
+    error = allocate_job_file(job_file, header.plates_capacity
+        , header.names_size);
+    if (error == EXIT_SUCCESS) *job_file->header = header;
+  }
+  // Every process must take part in the broadcast, even if it failed
+  int failed = error != EXIT_SUCCESS;
+  MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  if (failed) {
+    destroy_job_file(job_file);
+    return error != EXIT_SUCCESS ? error : ERR_PLATE_ALLOC;
+  }
+
+  const size_t used_size = get_arrays_size(header.plates_capacity)
+      + header.names_size;
+  error = broadcast_bytes(job_file->buffer + sizeof(job_file_header_t)
+      , used_size - sizeof(job_file_header_t));
+  if (error != EXIT_SUCCESS) destroy_job_file(job_file);
+  return error;
+}
+
+int broadcast_bytes(char* bytes, size_t size) {
+  for (size_t sent = 0; sent < size; sent += BROADCAST_CHUNK_SIZE) {
+    const size_t chunk = size - sent < BROADCAST_CHUNK_SIZE ? size - sent
+        : BROADCAST_CHUNK_SIZE;
+    if (MPI_Bcast(bytes + sent, (int) chunk, MPI_BYTE, 0, MPI_COMM_WORLD)
+        != MPI_SUCCESS) {
+      perror("Error: could not broadcast job file");
+      return ERR_MPI_RECV;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+void destroy_job_file(job_file_t* job_file) {
+  free(job_file->buffer);
+  memset(job_file, 0, sizeof(job_file_t));
+}
@@ -0,0 +1,107 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef JOB_FILE_H
+#define JOB_FILE_H
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+#include "errors.h"
+
+/** @brief Plates validated by a thread at a time, plate headers are small */
+#define VALIDATION_CHUNK 64
+
+/**
+ * @struct job_file_header_t
+ * @brief Sizes of a parsed job file, first in its buffer.
+ */
+typedef struct {
+  uint64_t plates_count;     ///< Plates of the job
+  uint64_t plates_capacity;  ///< Plates the parameter arrays can hold
+  uint64_t names_size;       ///< Bytes of names used, with their terminators
+  uint64_t names_capacity;   ///< Bytes the names arena can hold
+  uint64_t ladders_count;    ///< Epsilon ladders of the plates
+} job_file_header_t;
+
+/**
+ * @struct job_file_t
+ * @brief Table of the plates of a job file, parsed into a single buffer.
+ *
+ * The buffer is the arena of every plate of the job: it holds the header, one
+ * array per plate parameter and result, the epsilon ladders, and the file
+ * names of every plate, in that order. Since names are last, the used part of
+ * the buffer is contiguous, and it is sent to other processes as it is.
+ */
+typedef struct {
+  char* buffer;                   ///< Single allocation holding all below
+  job_file_header_t* header;      ///< Sizes of the arrays and the arena
+  uint64_t* interval_durations;   ///< Interval duration of each plate
+  double* thermal_diffusivities;  ///< Thermal diffusivity of each plate
+  double* cells_dimensions;       ///< Cells dimension of each plate
+  double* epsilons;               ///< Epsilon of each plate
+  uint64_t* rows;                 ///< Rows of the plate file of each plate
+  uint64_t* cols;                 ///< Columns of the plate file of each plate
+  uint64_t* name_offsets;         ///< Start of each file name in the arena
+  uint64_t* k_states;             ///< States each plate took to equilibrate
+  double* seconds;                ///< Seconds each plate was simulated
+  uint64_t* ladder_plates;        ///< Plate numbers of each ladder
+  uint64_t* ladder_starts;        ///< Start of each ladder in ladder_plates
+  char* names;                    ///< Null terminated file names
+} job_file_t;
+
+/**
+ * @brief Parses a job file in a single pass over its memory mapping.
+ *
+ * Each line has the plate file name, interval duration, thermal diffusivity,
+ * cells dimension and epsilon of a plate, separated by spaces or tabs. Blank
+ * lines are skipped. Arrays are sized by the lines of the file, and the
+ * names arena by its size, so everything is allocated once before parsing.
+ *
+ * @param job_file Job file to initialize
+ * @param job_file_path Path of the job file
+ * @return EXIT_SUCCESS on success, error code otherwise.
+ */
+int read_job_file(job_file_t* job_file, const char* job_file_path);
+
+/**
+ * @brief Reads the rows and columns of the plate file of every plate with
+ * OpenMP, checking the file holds all of its temperatures.
+ *
+ * Consecutive plates with the same file name are checked once.
+ *
+ * @param job_file Job file whose rows and cols are set
+ * @param source_directory Directory containing the plate files
+ * @param thread_count Threads reading plate headers
+ * @return EXIT_SUCCESS if every plate file is valid, error code otherwise.
+ */
+int validate_job_plates(job_file_t* job_file, const char* source_directory
+    , uint64_t thread_count);
+
+/**
+ * @brief Sends the job file parsed by the first process to every process.
+ *
+ * Every process must call it. The error of the first process is sent first,
+ * so all processes stop if it could not parse the job file. Then the header
+ * and the used part of the buffer are sent with MPI_Bcast.
+ *
+ * @param job_file Parsed job file in the first process, initialized in the
+ * other ones
+ * @param process_number Number of this process
+ * @param error Error of the first process parsing the job file, or building
+ * its epsilon ladders
+ * @return EXIT_SUCCESS on success, error code otherwise.
+ */
+int broadcast_job_file(job_file_t* job_file, int process_number, int error);
+
+/// @brief Returns the file name of a plate of a job file
+static inline char* get_plate_name(const job_file_t* job_file
+    , size_t plate_number) {
+  return job_file->names + job_file->name_offsets[plate_number];
+}
+
+/// @brief Frees the buffer of a job file
+void destroy_job_file(job_file_t* job_file);
+
+#endif  // JOB_FILE_H
@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include "job.h"
@@ -13,10 +14,10 @@
  * @brief Checks whether arguments were valid.
  * @param argc Argument count.
  * @param argv Arguments vector.
- * @param *thread_count POinter to thread_count in main to set.
+ * @param options Options in main to set (thread count and `--` options).
  * @return Success or failure of arguments analysis.
  */
-int analyze_arguments(int argc, char* argv[], uint64_t* thread_count);
+int analyze_arguments(int argc, char* argv[], options_t* options);
 
 /**
  * @brief Processes execution command to set thread count and 
@@ -26,19 +27,22 @@ int analyze_arguments(int argc, char* argv[], uint64_t* thread_count);
  * @return Status code to the operating system, 0 means success.
  */
 int main(int argc, char* argv[]) {
-  // Initialize MPI
-  if (MPI_Init(&argc, &argv) != MPI_SUCCESS) {
+  // Initialize MPI, the first process calls it from its dispatcher thread
+  int thread_support = MPI_THREAD_SINGLE;
+  if (MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &thread_support)
+      != MPI_SUCCESS) {
     perror("Error: could not initialize MPI");
     return ERR_INIT_MPI;
   }
   // double start_time = MPI_Wtime();  // Record MPI start time
 
-  // Assume default amount of threads first
-  uint64_t thread_count = sysconf(_SC_NPROCESSORS_ONLN);
+  // Assume default amount of threads and options first
+  options_t options;
+  init_options(&options, sysconf(_SC_NPROCESSORS_ONLN));
 
-  int error = analyze_arguments(argc, argv, &thread_count);
+  int error = analyze_arguments(argc, argv, &options);
 
-  if (error == EXIT_SUCCESS) error = simulate(argv[1], thread_count);
+  if (error == EXIT_SUCCESS) error = simulate(argv[1], &options);
 
   // double end_time = MPI_Wtime();  // Record MPI end time
   // printf("Elapsed time MPI: %lf seconds\n", end_time - start_time);
@@ -48,22 +52,27 @@ int main(int argc, char* argv[]) {
   return error;
 }
 
-int analyze_arguments(int argc, char* argv[], uint64_t* thread_count) {
+int analyze_arguments(int argc, char* argv[], options_t* options) {
   int error = EXIT_SUCCESS;
   // Must at least include job directory
-  if (argc == 3) {
-    if (sscanf(argv[2], "%zu", thread_count) != 1
-        || *thread_count <= 0 || *thread_count > 32000) {
+  if (argc < 2) {
+    // Inform usage to user
+    fprintf(stderr,
+        "usage: bin/omp_mpi job_file_path thread_count (count optional)"
+        " [--option=value ...]\n");
+    error = ERR_NO_JOB_FILE;
+  }
+  // Remaining arguments are either options or the thread count
+  for (int index = 2; error == EXIT_SUCCESS && index < argc; ++index) {
+    if (strncmp(argv[index], "--", 2) == 0) {
+      error = set_option(options, argv[index]);
+    } else if (sscanf(argv[index], "%zu", &options->thread_count) != 1
+        || options->thread_count <= 0 || options->thread_count > 32000) {
       // Inform usage to user
       fprintf(stderr,
         "Error: Invalid thread count (0 < thread_count <= 32000)\n");
       error = ERR_INVALID_THREAD_COUNT;
     }
-  } else if (argc < 2) {
-    // Inform usage to user
-    fprintf(stderr,
-        "usage: bin/omp_mpi job_file_path thread_count (count optional)\n");
-    error = ERR_NO_JOB_FILE;
   }
   return error;
 }
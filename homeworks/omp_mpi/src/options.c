@@ -0,0 +1,392 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "options.h"
+
+/**
+ * @brief Checks if the name of an argument matches an option's name.
+ * @param argument Argument as given in the command line.
+ * @param name_length Length of the name part of the argument (before '=').
+ * @param name Option name to compare with, e.g "--kernel".
+ * @return True if both names are the same.
+ */
+bool is_option(const char* argument, size_t name_length, const char* name);
+
+/**
+ * @brief Parses a positive integer value of an option.
+ * @param value Text to parse.
+ * @param result Where the parsed value is stored.
+ * @return EXIT_SUCCESS if value was a positive integer, ERR_INVALID_OPTION
+ * otherwise.
+ */
+int parse_positive(const char* value, uint64_t* result);
+
+/// @brief Parses an unsigned integer value of an option, zero included
+/// @see parse_positive
+int parse_unsigned(const char* value, uint64_t* result);
+
+/// @brief Parses a kernel name (sweep|wavefront|inplace|active) into a
+/// kernel_t
+/// @see parse_positive
+int parse_kernel(const char* value, kernel_t* kernel);
+
+/// @brief Parses an on|off value into a boolean
+/// @see parse_positive
+int parse_switch(const char* value, bool* result);
+
+/// @brief Parses an io mode (stdio|mmap|direct) into an io_t
+/// @see parse_positive
+int parse_io(const char* value, io_t* io);
+
+/// @brief Parses a precision (double|float|mixed) into a precision_t
+/// @see parse_positive
+int parse_precision(const char* value, precision_t* precision);
+
+/// @brief Parses a solver (jacobi|sor|multigrid) into a solver_t
+/// @see parse_positive
+int parse_solver(const char* value, solver_t* solver);
+
+/// @brief Parses a balance (static|steal) into a balance_t
+/// @see parse_positive
+int parse_balance(const char* value, balance_t* balance);
+
+/// @brief Parses a relaxation factor between 0 and 2 (both excluded), or
+/// auto, stored as 0
+/// @see parse_positive
+int parse_omega(const char* value, double* omega);
+
+/// @brief Parses the states between convergence checks, a positive amount
+/// or auto
+/// @see parse_positive
+int parse_check_states(const char* value, uint64_t* check_states);
+
+/// @brief Parses a list of CPUs and ranges of CPUs, e.g. 0-3,8,10-11
+/// @see parse_positive
+int parse_affinity(const char* value, options_t* options);
+
+/// @brief Parses an instruction set (auto|scalar|sse2|avx2|avx512), which
+/// must be supported by the CPU
+/// @see parse_positive
+int parse_simd(const char* value, simd_t* simd);
+
+void init_options(options_t* options, uint64_t thread_count) {
+  options->thread_count = thread_count;
+  options->kernel = KERNEL_SWEEP;
+  options->tile_rows = DEFAULT_TILE_SIZE;
+  options->tile_cols = DEFAULT_TILE_SIZE;
+  options->tile_states = DEFAULT_TILE_STATES;
+  options->simd = SIMD_AUTO;
+  options->stats = false;
+  options->plate_cache_mib = DEFAULT_PLATE_CACHE_MIB;
+  options->epsilon_ladder = true;
+  options->io = IO_STDIO;
+  options->numa = false;
+  options->affinity_count = 0;
+  options->precision = PRECISION_DOUBLE;
+  options->precision_reference = false;
+  options->checkpoint_states = 0;
+  options->checkpoint_seconds = 0;
+  options->resume = false;
+  options->decompose = false;
+  options->prefetch = 2;
+  options->master_works = true;
+  options->sidecar = false;
+  options->check_states = 1;
+  options->trace_states = 0;
+  options->solver = SOLVER_JACOBI;
+  options->omega = 0;
+  options->solver_reference = false;
+  options->balance = BALANCE_STATIC;
+}
+
+int set_option(options_t* options, const char* argument) {
+  // Split option name from its value, if there is one
+  const char* equals = strchr(argument, '=');
+  const char* value = equals ? equals + 1 : "";
+  size_t name_length = equals ? (size_t) (equals - argument)
+      : strlen(argument);
+
+  int error = ERR_INVALID_OPTION;
+  if (is_option(argument, name_length, "--kernel")) {
+    error = parse_kernel(value, &options->kernel);
+  } else if (is_option(argument, name_length, "--tile-rows")) {
+    error = parse_positive(value, &options->tile_rows);
+  } else if (is_option(argument, name_length, "--tile-cols")) {
+    error = parse_positive(value, &options->tile_cols);
+  } else if (is_option(argument, name_length, "--tile-states")) {
+    error = parse_positive(value, &options->tile_states);
+  } else if (is_option(argument, name_length, "--simd")) {
+    error = parse_simd(value, &options->simd);
+  } else if (is_option(argument, name_length, "--stats") && !equals) {
+    options->stats = true;
+    error = EXIT_SUCCESS;
+  } else if (is_option(argument, name_length, "--plate-cache")) {
+    error = parse_unsigned(value, &options->plate_cache_mib);
+  } else if (is_option(argument, name_length, "--epsilon-ladder")) {
+    error = parse_switch(value, &options->epsilon_ladder);
+  } else if (is_option(argument, name_length, "--io")) {
+    error = parse_io(value, &options->io);
+  } else if (is_option(argument, name_length, "--numa") && !equals) {
+    options->numa = true;
+    error = EXIT_SUCCESS;
+  } else if (is_option(argument, name_length, "--affinity")) {
+    error = parse_affinity(value, options);
+  } else if (is_option(argument, name_length, "--precision")) {
+    error = parse_precision(value, &options->precision);
+  } else if (is_option(argument, name_length, "--precision-reference")
+      && !equals) {
+    options->precision_reference = true;
+    error = EXIT_SUCCESS;
+  } else if (is_option(argument, name_length, "--checkpoint-states")) {
+    error = parse_unsigned(value, &options->checkpoint_states);
+  } else if (is_option(argument, name_length, "--checkpoint-seconds")) {
+    error = parse_unsigned(value, &options->checkpoint_seconds);
+  } else if (is_option(argument, name_length, "--resume") && !equals) {
+    options->resume = true;
+    error = EXIT_SUCCESS;
+  } else if (is_option(argument, name_length, "--prefetch")) {
+    error = parse_positive(value, &options->prefetch);
+  } else if (is_option(argument, name_length, "--master-works")) {
+    error = parse_switch(value, &options->master_works);
+  } else if (is_option(argument, name_length, "--decompose") && !equals) {
+    options->decompose = true;
+    error = EXIT_SUCCESS;
+  } else if (is_option(argument, name_length, "--check-states")) {
+    error = parse_check_states(value, &options->check_states);
+  } else if (is_option(argument, name_length, "--trace")) {
+    error = parse_unsigned(value, &options->trace_states);
+  } else if (is_option(argument, name_length, "--sidecar") && !equals) {
+    options->sidecar = true;
+    error = EXIT_SUCCESS;
+  } else if (is_option(argument, name_length, "--solver")) {
+    error = parse_solver(value, &options->solver);
+  } else if (is_option(argument, name_length, "--omega")) {
+    error = parse_omega(value, &options->omega);
+  } else if (is_option(argument, name_length, "--solver-reference")
+      && !equals) {
+    options->solver_reference = true;
+    error = EXIT_SUCCESS;
+  } else if (is_option(argument, name_length, "--balance")) {
+    error = parse_balance(value, &options->balance);
+  }
+
+  if (error != EXIT_SUCCESS) {
+    fprintf(stderr, "Error: Invalid option %s\n", argument);
+  }
+  return error;
+}
+
+const char* get_kernel_name(kernel_t kernel) {
+  switch (kernel) {
+    case KERNEL_WAVEFRONT: return "wavefront";
+    case KERNEL_INPLACE: return "inplace";
+    case KERNEL_ACTIVE: return "active";
+    default: return "sweep";
+  }
+}
+
+const char* get_precision_name(precision_t precision) {
+  switch (precision) {
+    case PRECISION_FLOAT: return "float";
+    case PRECISION_MIXED: return "mixed";
+    default: return "double";
+  }
+}
+
+const char* get_solver_name(solver_t solver) {
+  switch (solver) {
+    case SOLVER_SOR: return "sor";
+    case SOLVER_MULTIGRID: return "multigrid";
+    default: return "jacobi";
+  }
+}
+
+const char* get_balance_name(balance_t balance) {
+  switch (balance) {
+    case BALANCE_STEAL: return "steal";
+    default: return "static";
+  }
+}
+
+bool is_option(const char* argument, size_t name_length, const char* name) {
+  return strlen(name) == name_length
+      && strncmp(argument, name, name_length) == 0;
+}
+
+int parse_positive(const char* value, uint64_t* result) {
+  uint64_t parsed = 0;
+  // Reject zero as well
+  if (parse_unsigned(value, &parsed) != EXIT_SUCCESS || parsed == 0) {
+    return ERR_INVALID_OPTION;
+  }
+  *result = parsed;
+  return EXIT_SUCCESS;
+}
+
+int parse_unsigned(const char* value, uint64_t* result) {
+  uint64_t parsed = 0;
+  char extra = '\0';
+  // Reject empty or signed values, and trailing characters
+  if (value[0] < '0' || value[0] > '9'
+      || sscanf(value, "%" SCNu64 "%c", &parsed, &extra) != 1) {
+    return ERR_INVALID_OPTION;
+  }
+  *result = parsed;
+  return EXIT_SUCCESS;
+}
+
+int parse_kernel(const char* value, kernel_t* kernel) {
+  if (strcmp(value, "sweep") == 0) {
+    *kernel = KERNEL_SWEEP;
+  } else if (strcmp(value, "wavefront") == 0) {
+    *kernel = KERNEL_WAVEFRONT;
+  } else if (strcmp(value, "inplace") == 0) {
+    *kernel = KERNEL_INPLACE;
+  } else if (strcmp(value, "active") == 0) {
+    *kernel = KERNEL_ACTIVE;
+  } else {
+    return ERR_INVALID_OPTION;
+  }
+  return EXIT_SUCCESS;
+}
+
+int parse_switch(const char* value, bool* result) {
+  if (strcmp(value, "on") == 0) {
+    *result = true;
+  } else if (strcmp(value, "off") == 0) {
+    *result = false;
+  } else {
+    return ERR_INVALID_OPTION;
+  }
+  return EXIT_SUCCESS;
+}
+
+int parse_io(const char* value, io_t* io) {
+  const io_t candidates[] = {IO_STDIO, IO_MMAP, IO_DIRECT};
+  for (size_t index = 0; index < sizeof(candidates) / sizeof(io_t);
+      ++index) {
+    if (strcmp(value, get_io_name(candidates[index])) == 0) {
+      *io = candidates[index];
+      return EXIT_SUCCESS;
+    }
+  }
+  return ERR_INVALID_OPTION;
+}
+
+int parse_precision(const char* value, precision_t* precision) {
+  const precision_t candidates[] = {PRECISION_DOUBLE, PRECISION_FLOAT
+      , PRECISION_MIXED};
+  for (size_t index = 0; index < sizeof(candidates) / sizeof(precision_t);
+      ++index) {
+    if (strcmp(value, get_precision_name(candidates[index])) == 0) {
+      *precision = candidates[index];
+      return EXIT_SUCCESS;
+    }
+  }
+  return ERR_INVALID_OPTION;
+}
+
+int parse_solver(const char* value, solver_t* solver) {
+  const solver_t candidates[] = {SOLVER_JACOBI, SOLVER_SOR
+      , SOLVER_MULTIGRID};
+  for (size_t index = 0; index < sizeof(candidates) / sizeof(solver_t);
+      ++index) {
+    if (strcmp(value, get_solver_name(candidates[index])) == 0) {
+      *solver = candidates[index];
+      return EXIT_SUCCESS;
+    }
+  }
+  return ERR_INVALID_OPTION;
+}
+
+int parse_balance(const char* value, balance_t* balance) {
+  const balance_t candidates[] = {BALANCE_STATIC, BALANCE_STEAL};
+  for (size_t index = 0; index < sizeof(candidates) / sizeof(balance_t);
+      ++index) {
+    if (strcmp(value, get_balance_name(candidates[index])) == 0) {
+      *balance = candidates[index];
+      return EXIT_SUCCESS;
+    }
+  }
+  return ERR_INVALID_OPTION;
+}
+
+int parse_omega(const char* value, double* omega) {
+  // The relaxation factor of each plate is chosen from its size
+  if (strcmp(value, "auto") == 0) {
+    *omega = 0;
+    return EXIT_SUCCESS;
+  }
+  double parsed = 0;
+  char extra = '\0';
+  // SOR only converges with factors strictly between 0 and 2
+  if (value[0] < '0' || value[0] > '9'
+      || sscanf(value, "%lf%c", &parsed, &extra) != 1 || parsed <= 0
+      || parsed >= 2) {
+    return ERR_INVALID_OPTION;
+  }
+  *omega = parsed;
+  return EXIT_SUCCESS;
+}
+
+int parse_check_states(const char* value, uint64_t* check_states) {
+  // Adaptive states between checks are stored as 0
+  if (strcmp(value, "auto") == 0) {
+    *check_states = 0;
+    return EXIT_SUCCESS;
+  }
+  return parse_positive(value, check_states);
+}
+
+int parse_affinity(const char* value, options_t* options) {
+  uint64_t count = 0;
+  const char* range = value;
+  // Each range is either a CPU or first-last, separated by commas
+  while (*range) {
+    unsigned first = 0, last = 0;
+    int length = 0;
+    if (sscanf(range, "%u-%u%n", &first, &last, &length) != 2) {
+      if (sscanf(range, "%u%n", &first, &length) != 1) {
+        return ERR_INVALID_OPTION;
+      }
+      last = first;
+    }
+    if (range[0] < '0' || range[0] > '9' || first > last
+        || last >= UINT16_MAX) {
+      return ERR_INVALID_OPTION;
+    }
+    for (unsigned cpu = first; cpu <= last; ++cpu) {
+      if (count == MAX_AFFINITY_CPUS) return ERR_INVALID_OPTION;
+      options->affinity_cpus[count++] = (uint16_t) cpu;
+    }
+
+    range += length;
+    if (*range == ',') {
+      ++range;
+      if (*range == '\0') return ERR_INVALID_OPTION;
+    } else if (*range != '\0') {
+      return ERR_INVALID_OPTION;
+    }
+  }
+  if (count == 0) return ERR_INVALID_OPTION;
+  options->affinity_count = count;
+  return EXIT_SUCCESS;
+}
+
+int parse_simd(const char* value, simd_t* simd) {
+  const simd_t candidates[] = {SIMD_AUTO, SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2
+      , SIMD_AVX512};
+  for (size_t index = 0; index < sizeof(candidates) / sizeof(simd_t);
+      ++index) {
+    const bool is_auto = candidates[index] == SIMD_AUTO;
+    if (strcmp(value, is_auto ? "auto" : get_simd_name(candidates[index]))
+        == 0) {
+      if (!is_simd_supported(candidates[index])) {
+        fprintf(stderr, "Error: %s is not supported by this CPU\n", value);
+        return ERR_INVALID_OPTION;
+      }
+      *simd = candidates[index];
+      return EXIT_SUCCESS;
+    }
+  }
+  return ERR_INVALID_OPTION;
+}
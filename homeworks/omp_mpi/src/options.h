@@ -0,0 +1,130 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "errors.h"
+#include "plate_cache.h"
+#include "plate_io.h"
+#include "row_kernel.h"
+
+/** @brief Default amount of states a wavefront tile advances per block. */
+#define DEFAULT_TILE_STATES 16
+
+/** @brief Default rows and columns of a wavefront or active tile. */
+#define DEFAULT_TILE_SIZE 128
+
+/** @brief Maximum amount of CPUs in an affinity list. */
+#define MAX_AFFINITY_CPUS 1024
+
+/**
+ * @enum kernel_t
+ * @brief Stencil kernels available to equilibrate a plate.
+ */
+typedef enum {
+  KERNEL_SWEEP,      ///< Whole matrix swept once per state
+  KERNEL_WAVEFRONT,  ///< Tiles advanced several states while in cache
+  KERNEL_INPLACE,    ///< Single matrix updated in place, rows saved aside
+  KERNEL_ACTIVE      ///< Only tiles whose temperatures may change updated
+} kernel_t;
+
+/**
+ * @enum precision_t
+ * @brief Floating point precision plates are simulated in.
+ */
+typedef enum {
+  PRECISION_DOUBLE,  ///< Every state in double
+  PRECISION_FLOAT,   ///< Every state in float, unless epsilon is too small
+  PRECISION_MIXED    ///< Float until max delta nears epsilon, then double
+} precision_t;
+
+/**
+ * @enum solver_t
+ * @brief Methods that find the equilibrium of a plate.
+ */
+typedef enum {
+  SOLVER_JACOBI,    ///< States simulated in time until equilibrium
+  SOLVER_SOR,       ///< Red-black successive over-relaxation, in place
+  SOLVER_MULTIGRID  ///< Multigrid V-cycles with red-black smoothing
+} solver_t;
+
+/**
+ * @enum balance_t
+ * @brief Ways the rows of the sweep kernel are balanced among threads.
+ */
+typedef enum {
+  BALANCE_STATIC,  ///< Static map by blocks, the same every state
+  BALANCE_STEAL    ///< Blocks kept, idle threads steal their neighbors' tails
+} balance_t;
+
+/**
+ * @struct options_t
+ * @brief Execution options given in the command line.
+ */
+typedef struct {
+  uint64_t thread_count;     ///< Threads used to simulate each plate
+  kernel_t kernel;           ///< Kernel used to equilibrate plates
+  uint64_t tile_rows;        ///< Rows of each wavefront or active tile
+  uint64_t tile_cols;        ///< Columns of each wavefront or active tile
+  uint64_t tile_states;      ///< States each wavefront tile advances per block
+  simd_t simd;               ///< Instruction set of the row kernel
+  bool stats;                ///< True to report kernel statistics per plate
+  uint64_t plate_cache_mib;  ///< Memory budget of the plate cache, 0 disables
+  bool epsilon_ladder;       ///< True to share states among epsilons
+  io_t io;                   ///< Way to read and write plate files
+  bool numa;                 ///< True to place rows on their threads' nodes
+  uint64_t affinity_count;   ///< CPUs in the affinity list, 0 to not pin
+  uint16_t affinity_cpus[MAX_AFFINITY_CPUS];  ///< CPU of each thread, cyclic
+  precision_t precision;     ///< Precision plates are simulated in
+  bool precision_reference;  ///< True to compare states with double ones
+  uint64_t checkpoint_states;   ///< States between checkpoints, 0 disables
+  uint64_t checkpoint_seconds;  ///< Seconds between checkpoints, 0 disables
+  bool resume;               ///< True to continue from checkpoints
+  bool decompose;            ///< True to split each plate among processes
+  uint64_t prefetch;         ///< Ladders queued in each worker, 1 for none
+  bool master_works;         ///< True if the first process simulates too
+  bool sidecar;              ///< True to write the timing of each plate
+  uint64_t check_states;     ///< States between convergence checks, 0 adapts
+  uint64_t trace_states;     ///< States between maximum change samples, 0
+                             ///< disables the trace
+  solver_t solver;           ///< Method that finds the equilibrium
+  double omega;              ///< Relaxation factor of SOR, 0 to choose it
+  bool solver_reference;     ///< True to compare solvers with Jacobi states
+  balance_t balance;         ///< Balance of the rows of the sweep kernel
+} options_t;
+
+/**
+ * @brief Sets the default options, used when not given in the command line.
+ * @param options Options to initialize.
+ * @param thread_count Default amount of threads.
+ */
+void init_options(options_t* options, uint64_t thread_count);
+
+/**
+ * @brief Parses one `--name=value` (or `--name`) command line option.
+ *
+ * @param options Options to update.
+ * @param argument Argument as given in the command line.
+ * @return EXIT_SUCCESS on success, ERR_INVALID_OPTION otherwise.
+ */
+int set_option(options_t* options, const char* argument);
+
+/// @brief Returns the name used in the command line for a kernel.
+const char* get_kernel_name(kernel_t kernel);
+
+/// @brief Returns the name used in the command line for a precision.
+const char* get_precision_name(precision_t precision);
+
+/// @brief Returns the name used in the command line for a solver.
+const char* get_solver_name(solver_t solver);
+
+/// @brief Returns the name used in the command line for a balance.
+const char* get_balance_name(balance_t balance);
+
+#endif  // OPTIONS_H
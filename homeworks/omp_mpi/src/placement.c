@@ -0,0 +1,156 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "placement.h"
+
+#include <omp.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/** @brief Pages whose node is queried at once. */
+#define QUERIED_PAGES 1024
+
+/// @brief CPU the calling thread was pinned to, -1 if it was not pinned
+static __thread int pinned_cpu = -1;
+
+/**
+ * @brief Adds the bytes of a memory area resident on each NUMA node.
+ * @param area Start of the memory area
+ * @param size Bytes of the memory area
+ * @param node_bytes Bytes per node, increased by the pages on each node
+ * @return True on success, false if the kernel does not report page nodes
+ */
+bool count_node_bytes(const void* area, size_t size, uint64_t* node_bytes);
+
+void get_block_rows(uint64_t thread, uint64_t team, uint64_t rows
+    , uint64_t* first_row, uint64_t* last_row) {
+  const uint64_t interior_rows = rows > 2 ? rows - 2 : 0;
+  const uint64_t block_rows = interior_rows / team;
+  const uint64_t extra_rows = interior_rows % team;
+  *first_row = 1 + thread * block_rows
+      + (thread < extra_rows ? thread : extra_rows);
+  *last_row = *first_row + block_rows + (thread < extra_rows ? 1 : 0);
+}
+
+void pin_thread(const options_t* options, uint64_t thread) {
+  if (options->affinity_count == 0) return;
+  const int cpu = options->affinity_cpus[thread % options->affinity_count];
+  if (cpu == pinned_cpu || cpu >= CPU_SETSIZE) return;
+
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu, &cpus);
+  if (sched_setaffinity(/*calling thread*/ 0, sizeof(cpu_set_t), &cpus)
+      != 0) {
+    fprintf(stderr, "Error: Could not pin thread %" PRIu64 " to CPU %d\n"
+        , thread, cpu);
+  }
+  // Not retried if it failed, the thread simply runs unpinned
+  pinned_cpu = cpu;
+}
+
+int place_plate_matrix(plate_matrix_t* plate_matrix, const options_t* options
+    , bool with_auxiliary) {
+  const uint64_t rows = plate_matrix->rows;
+  const uint64_t cols = plate_matrix->cols;
+  // Large allocations are mapped without being touched until copied below
+  double* matrix = (double*) malloc(rows * cols * sizeof(double));
+  double* auxiliary_matrix = with_auxiliary ?
+      (double*) malloc(rows * cols * sizeof(double)) : NULL;
+  if (!matrix || (with_auxiliary && !auxiliary_matrix)) {
+    free(matrix);
+    free(auxiliary_matrix);
+    return EXIT_FAILURE;
+  }
+
+  const double* loaded_matrix = plate_matrix->matrix;
+  #pragma omp parallel num_threads(options->thread_count) default(none) \
+      shared(options, rows, cols, matrix, auxiliary_matrix, loaded_matrix)
+  {  // NOLINT (whitespace/braces)
+    const uint64_t thread = omp_get_thread_num();
+    const uint64_t team = omp_get_num_threads();
+    pin_thread(options, thread);
+
+    uint64_t first_row = 0, last_row = 0;
+    get_block_rows(thread, team, rows, &first_row, &last_row);
+    // Border rows are placed with the first and last blocks
+    if (thread == 0) first_row = 0;
+    if (thread == team - 1) last_row = rows;
+
+    // Auxiliary matrix is a copy too, only its borders must be the same
+    if (last_row > first_row) {
+      const size_t first_cell = first_row * cols;
+      const size_t size = (last_row - first_row) * cols * sizeof(double);
+      memcpy(matrix + first_cell, loaded_matrix + first_cell, size);
+      if (auxiliary_matrix) {
+        memcpy(auxiliary_matrix + first_cell, loaded_matrix + first_cell
+            , size);
+      }
+    }
+  }
+
+  free(plate_matrix->matrix);
+  free(plate_matrix->auxiliary_matrix);
+  plate_matrix->matrix = matrix;
+  plate_matrix->auxiliary_matrix = auxiliary_matrix;
+  return EXIT_SUCCESS;
+}
+
+void report_numa_bandwidth(size_t plate_number
+    , const plate_matrix_t* plate_matrix, uint64_t states, double seconds) {
+  uint64_t node_bytes[MAX_NUMA_NODES] = {0};
+  const size_t size = plate_matrix->rows * plate_matrix->cols
+      * sizeof(double);
+  bool counted = count_node_bytes(plate_matrix->matrix, size, node_bytes);
+  if (counted && plate_matrix->auxiliary_matrix) {
+    counted = count_node_bytes(plate_matrix->auxiliary_matrix, size
+        , node_bytes);
+  }
+  if (!counted) {
+    printf("Plate %zu: NUMA placement is not available\n", plate_number);
+    return;
+  }
+
+  uint64_t resident_bytes = 0;
+  for (size_t node = 0; node < MAX_NUMA_NODES; ++node) {
+    resident_bytes += node_bytes[node];
+  }
+  // Every state reads and writes one matrix, split by the pages of each node
+  const double moved_bytes = (double) states * 2 * size;
+  for (size_t node = 0; node < MAX_NUMA_NODES && resident_bytes > 0;
+      ++node) {
+    if (node_bytes[node] == 0) continue;
+    const double fraction = (double) node_bytes[node] / resident_bytes;
+    printf("Plate %zu: node %zu, %.1lf%% of pages, %.3lf GB/s modeled\n"
+        , plate_number, node, 100 * fraction
+        , seconds > 0 ? moved_bytes * fraction / seconds / 1e9 : 0);
+  }
+}
+
+bool count_node_bytes(const void* area, size_t size, uint64_t* node_bytes) {
+  const uintptr_t page_size = (uintptr_t) sysconf(_SC_PAGESIZE);
+  uintptr_t page = (uintptr_t) area & ~(page_size - 1);
+  const uintptr_t end = (uintptr_t) area + size;
+
+  void* pages[QUERIED_PAGES];
+  int nodes[QUERIED_PAGES];
+  while (page < end) {
+    unsigned long count = 0;
+    for (; count < QUERIED_PAGES && page < end; ++count, page += page_size) {
+      pages[count] = (void*) page;
+    }
+    // Without target nodes, move_pages only reports the node of each page
+    if (syscall(SYS_move_pages, /*this process*/ 0, count, pages, NULL, nodes
+        , 0) != 0) {
+      return false;
+    }
+    for (unsigned long index = 0; index < count; ++index) {
+      // Pages not touched yet report a negative error instead of a node
+      if (nodes[index] >= 0 && nodes[index] < MAX_NUMA_NODES) {
+        node_bytes[nodes[index]] += page_size;
+      }
+    }
+  }
+  return true;
+}
@@ -0,0 +1,83 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "options.h"
+#include "plate_matrix.h"
+
+/** @brief Maximum amount of NUMA nodes reported. */
+#define MAX_NUMA_NODES 64
+
+/**
+ * @brief Finds the interior rows of a thread in the static map by blocks.
+ *
+ * Interior rows (all but the first and last ones) are split evenly, and the
+ * first threads get one more row if the split is not even. This is the same
+ * map of `schedule(static)` loops over the interior rows, so the rows placed
+ * on a thread's node are the ones the thread updates.
+ *
+ * @param thread Number of the thread in its team
+ * @param team Amount of threads in the team
+ * @param rows Rows of the plate, including borders
+ * @param first_row Where the first row of the thread is stored
+ * @param last_row Where the row after the last one of the thread is stored
+ */
+void get_block_rows(uint64_t thread, uint64_t team, uint64_t rows
+    , uint64_t* first_row, uint64_t* last_row);
+
+/**
+ * @brief Pins the calling thread to its CPU of the affinity list.
+ *
+ * Thread i runs in CPU i of the list, wrapping around if the list is shorter
+ * than the team. Does nothing if there is no affinity list, or the thread
+ * is already pinned to that CPU.
+ *
+ * @param options Options with the affinity list
+ * @param thread Number of the thread in its team
+ */
+void pin_thread(const options_t* options, uint64_t thread);
+
+/**
+ * @brief Moves the matrices of a plate to memory first touched by the threads
+ * that update each row block.
+ *
+ * New matrices are allocated without being touched, and each thread of the
+ * team copies its block of rows into them, so the kernel pages them on the
+ * thread's NUMA node. The auxiliary matrix is also allocated and copied if
+ * the kernel needs it.
+ *
+ * @param plate_matrix Plate matrix loaded by a single thread
+ * @param options Options with the amount of threads and affinity list
+ * @param with_auxiliary True to also create the auxiliary matrix
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE if memory was not allocated
+ */
+int place_plate_matrix(plate_matrix_t* plate_matrix, const options_t* options
+    , bool with_auxiliary);
+
+/**
+ * @brief Prints the pages of the plate matrices on every NUMA node, and the
+ * bandwidth modeled for each node while equilibrating a plate.
+ *
+ * The bandwidth is not measured: the model traffic of the sweep kernel, a
+ * matrix read and one written per state, is split between nodes by the
+ * fraction of pages resident on each one, and divided by the duration.
+ *
+ * @param plate_number Number of the plate in the job
+ * @param plate_matrix Plate matrix equilibrated
+ * @param states States simulated
+ * @param seconds Duration of the simulation
+ */
+void report_numa_bandwidth(size_t plate_number
+    , const plate_matrix_t* plate_matrix, uint64_t states, double seconds);
+
+#endif  // PLACEMENT_H
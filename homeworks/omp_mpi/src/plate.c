@@ -2,23 +2,63 @@
 
 #include "plate.h"
 #include "threads.h"
+#include "convergence.h"
+#include "active.h"
+#include "balance.h"
+#include "inplace.h"
+#include "placement.h"
+#include "precision.h"
+#include "solver.h"
+#include "wavefront.h"
 #include <omp.h>
 
-/// @brief Computes the mult constant for the plate with the thermal diffusivity
-/// inteval duration, and cells' dimension
-/// @param plate Plate to use
-/// @return Mult constant
-double calculate_mult_constant(plate_t* plate);
-
-int set_plate_matrix(plate_t* plate, char* source_directory) {
+/**
+ * @brief Reads the dimensions and temperatures of a plate file into a new
+ * plate matrix, without initializing its auxiliary.
+ * @param plate Plate whose plate matrix is created.
+ * @param plate_file_path Path of the plate file.
+ * @return EXIT_SUCCESS on success, error code otherwise.
+ */
+int read_plate_file(plate_t* plate, const char* plate_file_path);
+
+int set_plate_matrix(plate_t* plate, char* source_directory
+    , plate_cache_t* plate_cache, io_t io) {
   // Concatenate plate file name with same directory specified for job
   char* plate_file_path = build_file_path(source_directory, plate->file_name);
 
   if (!plate_file_path) return EXIT_FAILURE;
 
+  // Plates repeated in the job are cloned from their pristine copy
+  int error = EXIT_SUCCESS;
+  plate->plate_matrix = plate_cache ?
+      clone_cached_plate(plate_cache, plate_file_path) : NULL;
+  if (!plate->plate_matrix) {
+    error = io == IO_STDIO ? read_plate_file(plate, plate_file_path)
+        : read_plate_mmap(plate_file_path, &plate->plate_matrix);
+    if (error == EXIT_SUCCESS && plate_cache) {
+      store_cached_plate(plate_cache, plate_file_path, plate->plate_matrix);
+    }
+  }
+  free(plate_file_path);
+  return error;
+}
+
+int read_plate_output(plate_t* plate, char* source_directory, io_t io) {
+  char* output_file_name = set_plate_file_name(plate);
+  if (!output_file_name) return ERR_UPDATE_OUTPUT_FILE_NAME;
+  char* output_file_path = build_file_path(source_directory, output_file_name);
+  free(output_file_name);
+  if (!output_file_path) return ERR_BUILD_OUTPUT_FILE_NAME;
+
+  const int error = io == IO_STDIO ? read_plate_file(plate, output_file_path)
+      : read_plate_mmap(output_file_path, &plate->plate_matrix);
+  free(output_file_path);
+  return error;
+}
+
+int read_plate_file(plate_t* plate, const char* plate_file_path) {
   // Open file to read from
   FILE* plate_file = fopen(plate_file_path, "rb");
-  free(plate_file_path);
 
   if (!plate_file) {
     printf("Error: Plate file %s could not be opened", plate->file_name);
@@ -47,61 +87,121 @@ int set_plate_matrix(plate_t* plate, char* source_directory) {
     row_start += plate->plate_matrix->cols;
   }
 
-  // Copy matrix's borders to auxiliary, to prepare for matrix switches
-  init_auxiliary(plate->plate_matrix);
-
   fclose(plate_file);
   return EXIT_SUCCESS;
 }
 
 
 
-void equilibrate_plate(plate_t* plate, uint64_t thread_count) {
-  bool equilibrated_plate = true;
+int equilibrate_plate(plate_t* plate, const options_t* options) {
+  // Steady-state solvers find the equilibrium without simulating states
+  if (options->solver != SOLVER_JACOBI) {
+    return equilibrate_plate_solver(plate, options);
+  }
+
+  int error = EXIT_SUCCESS;
+  if (options->precision != PRECISION_DOUBLE) {
+    error = equilibrate_plate_float(plate, options);
+    // Finished in float, unless epsilon was not reached
+    if (error != EXIT_SUCCESS || plate->max_delta <= plate->epsilon
+        || (plate->stop_state && plate->k_states >= plate->stop_state)) {
+      return error;
+    }
+  }
+
+  // Copy matrix's borders to auxiliary, to prepare for matrix switches. The
+  // in-place kernel does not need it, so the plate is stored once
+  if (options->kernel != KERNEL_INPLACE
+      && !plate->plate_matrix->auxiliary_matrix
+      && init_auxiliary(plate->plate_matrix) != EXIT_SUCCESS) {
+    fprintf(stderr, "Error: Could not allocate auxiliary matrix\n");
+    return ERR_KERNEL_ALLOC;
+  }
+
+  switch (options->kernel) {
+    case KERNEL_WAVEFRONT:
+      error = equilibrate_plate_wavefront(plate, options);
+      break;
+    case KERNEL_INPLACE:
+      error = equilibrate_plate_inplace(plate, options);
+      break;
+    case KERNEL_ACTIVE:
+      error = equilibrate_plate_active(plate, options);
+      break;
+    default:
+      if (options->balance == BALANCE_STEAL) {
+        error = equilibrate_plate_steal(plate, options);
+      } else if (options->check_states == 1) {
+        equilibrate_plate_sweep(plate, options);
+      } else {
+        error = equilibrate_plate_amortized(plate, options);
+      }
+      break;
+  }
+  return error;
+}
+
+
+
+void equilibrate_plate_sweep(plate_t* plate, const options_t* options) {
+  double max_delta = 0;
+  const uint64_t first_state = plate->k_states;
   // Precompute constant for temperature update calculations
   double mult_constant = calculate_mult_constant(plate);
+  // Row kernel of the widest instruction set available (or the one requested)
+  update_row_t update_row = get_update_row(options->simd);
+  // Plates with less than three columns have no interior cells
+  const uint64_t interior_cols = plate->plate_matrix->cols > 2 ?
+      plate->plate_matrix->cols - 2 : 0;
 
   // Create thread_count amount of threads
-  #pragma omp parallel num_threads(thread_count) default(none) \
-        shared(plate, equilibrated_plate, mult_constant)
+  #pragma omp parallel num_threads(options->thread_count) default(none) \
+        shared(plate, options, max_delta, mult_constant, update_row \
+        , interior_cols, first_state)
   {  // NOLINT (whitespace/braces)
     plate_matrix_t* plate_matrix = plate->plate_matrix;
+    pin_thread(options, omp_get_thread_num());
     // Each thread operates until finished with the equlibrium
     while (true) {
       // Only one thread must do this
       #pragma omp single
       {
+        // Maximum change of the previous state is still the reduced one
+        if (plate->k_states > first_state) {
+          trace_state(plate->trace, plate->k_states, max_delta);
+        }
         ++plate->k_states;  // Update iterations
         set_auxiliary(plate_matrix);  // Prepare matrices
-        equilibrated_plate = true;  // Reset shared equilibrated flag
+        max_delta = 0;  // Reset shared maximum temperature change
       }
 
-      // Distribute the threads to simulate state with static map by blocks
-      // which is the default map
-      #pragma omp for reduction(&:equilibrated_plate)
+      // Distribute the threads to simulate state with static map by blocks,
+      // the same map used to place rows in NUMA mode
+      #pragma omp for schedule(static) reduction(max:max_delta)
       for (size_t row = 1; row < plate_matrix->rows - 1; ++row) {
-        for (size_t col = 1; col < plate_matrix->cols - 1; ++col) {
-          // Update the cell temperature based on surrounding cells
-          update_cell(plate_matrix, row, col, mult_constant);
-          size_t accessed = row * plate_matrix->cols + col;
-          // Get the new and old temperatures for comparison
-          double new_temperature = plate_matrix->matrix[accessed];
-          double old_temperature = plate_matrix->auxiliary_matrix[accessed];
-
-          // Compute absolute difference
-          double difference = fabs(new_temperature - old_temperature);
-
-          // Track the maximum temperature change in this update step
-          if (difference > plate->epsilon) {
-            equilibrated_plate = false;
-          }
-        }
+        // Update the row and get its maximum temperature change in one pass
+        const size_t first_cell = row * plate_matrix->cols + 1;
+        double max_difference = update_row(
+            plate_matrix->auxiliary_matrix + first_cell
+            , plate_matrix->matrix + first_cell, interior_cols
+            , plate_matrix->cols, mult_constant);
+
+        if (max_difference > max_delta) max_delta = max_difference;
       }
 
-      if (equilibrated_plate) break;  // Break from work once finished
+      // Break from work once finished, or once the stop state is reached
+      if (max_delta <= plate->epsilon
+          || plate->k_states == plate->stop_state) {
+        break;
+      }
       #pragma omp barrier  // Make sure threads sync before next iteration
     }
   }
+
+  plate->max_delta = max_delta;
+  // Every state reads the whole current matrix and writes the whole new one
+  plate->moved_bytes += (plate->k_states - first_state) * 2 * sizeof(double)
+      * plate->plate_matrix->rows * plate->plate_matrix->cols;
 }
 
 
@@ -117,7 +217,7 @@ double calculate_mult_constant(plate_t* plate) {
 
 
 
-int update_plate_file(plate_t* plate, char* source_directory) {
+int update_plate_file(plate_t* plate, char* source_directory, io_t io) {
   int error = EXIT_SUCCESS;
 
   // Generate the updated file name based on the plate's state
@@ -133,6 +233,16 @@ int update_plate_file(plate_t* plate, char* source_directory) {
     return ERR_BUILD_OUTPUT_FILE_NAME;
   }
 
+  // Mapped and direct outputs write the whole matrix at once
+  if (io != IO_STDIO) {
+    error = io == IO_MMAP ?
+        write_plate_mmap(output_file_name, plate->plate_matrix)
+        : write_plate_direct(output_file_name, plate->plate_matrix);
+    free(updated_file_name);
+    free(output_file_name);
+    return error;
+  }
+
   // Open the file for writing in binary mode
   FILE* output_file = fopen(output_file_name, "wb");
 
@@ -16,7 +16,25 @@
 
 #include "common.h"
 #include "errors.h"
+#include "options.h"
+#include "plate_cache.h"
+#include "plate_io.h"
 #include "plate_matrix.h"
+#include "trace.h"
+
+/** @brief Ranges of states of the active kernel statistics, range i has the
+ * states from 2^i to 2^(i+1) - 1. */
+#define TILE_STATE_RANGES 64
+
+/**
+ * @struct thread_balance_t
+ * @brief Time a thread of the stealing sweep kernel spent in a plate.
+ */
+typedef struct {
+  double busy_seconds;   ///< Seconds updating rows, stolen ones included
+  double idle_seconds;   ///< Seconds waiting for the rest of the team
+  uint64_t stolen_rows;  ///< Rows taken from the tails of other blocks
+} thread_balance_t;
 
 /**
  * @struct plate_t
@@ -30,28 +48,87 @@ typedef struct {
   double cells_dimension;      ///< Cell size dimension
   double epsilon;                ///< Threshold for equilibrium check
   uint64_t k_states;             ///< Current simulation state
+  uint64_t moved_bytes;          ///< Matrix bytes read and written by kernel
+  double max_delta;              ///< Maximum temperature change in last state
+  uint64_t float_states;         ///< States simulated in single precision
+  uint64_t stop_state;           ///< State kernels stop at, 0 for none
+  uint64_t checks;               ///< States whose maximum change was measured
+  uint64_t replayed_states;      ///< States simulated again after a check
+  trace_t* trace;                ///< Samples of the maximum change, or NULL
+  uint64_t tile_updates[TILE_STATE_RANGES];   ///< Tiles of the active kernel
+                                              ///< in each range of states
+  uint64_t skipped_tiles[TILE_STATE_RANGES];  ///< Tiles it skipped in them
+  thread_balance_t* balance;     ///< Time of each thread when stealing rows,
+                                 ///< or NULL to not measure it
 } plate_t;
 
 /**
  * @brief Loads the plate matrix from a binary file.
  * 
  * Reads the matrix dimensions and data from the file into a plate structure.
+ * Plates already in the cache are cloned from their pristine copy instead,
+ * and plates read from their file are stored in it.
  * 
  * @param plate Pointer to the plate structure.
  * @param source_directory Directory containing the plate file.
+ * @param plate_cache Cache of plate files, or NULL to always read the file.
+ * @param io Way to read the plate file.
+ * @return EXIT_SUCCESS on success, error code otherwise.
+ */
+int set_plate_matrix(plate_t* plate, char* source_directory
+    , plate_cache_t* plate_cache, io_t io);
+
+/**
+ * @brief Loads the plate matrix from the plate file written for the current
+ * state of the plate, as named by set_plate_file_name.
+ *
+ * Used to continue a plate from the previous plate of its ladder when the
+ * previous one was finished by an interrupted run.
+ *
+ * @param plate Plate with the states of the written file.
+ * @param source_directory Directory containing the plate file.
+ * @param io Way to read the plate file.
  * @return EXIT_SUCCESS on success, error code otherwise.
  */
-int set_plate_matrix(plate_t* plate, char* source_directory);
+int read_plate_output(plate_t* plate, char* source_directory, io_t io);
 
 /**
  * @brief Simulates heat transfer of a plate until equilibrium
  * 
- * Distributes threads to equilibrate plate with omp.
+ * Runs the kernel selected in the options, all of them reach the same
+ * k_states and final temperatures. If the plate was already simulated some
+ * states (with a greater epsilon), it continues from its current state.
+ * With float or mixed precision, states are simulated in float first, and
+ * the kernel only finishes in double plates whose epsilon was not reached.
+ * If the plate has a stop state, kernels also stop once they reach it, with
+ * the plate not equilibrated yet (max delta greater than epsilon).
+ * With the sor or multigrid solvers, the equilibrium is found by the solver
+ * instead, and its iterations are counted as states.
  * 
  * @param plate Plate to equilibrate
- * @param thread_count amount of threads used for the simulation
+ * @param options Options with kernel and amount of threads to use
+ * @return EXIT_SUCCESS on success, error code otherwise.
  */
-void equilibrate_plate(plate_t* plate, uint64_t thread_count);
+int equilibrate_plate(plate_t* plate, const options_t* options);
+
+/**
+ * @brief Simulates heat transfer of a plate until equilibrium, sweeping the
+ * whole matrix once per state
+ * 
+ * Distributes rows among threads with omp. Each row is updated by the row
+ * kernel of the instruction set in the options, which also returns the
+ * row's maximum temperature change to check equilibrium in the same pass.
+ * 
+ * @param plate Plate to equilibrate
+ * @param options Options with amount of threads and instruction set
+ */
+void equilibrate_plate_sweep(plate_t* plate, const options_t* options);
+
+/// @brief Computes the mult constant for the plate with the thermal diffusivity
+/// inteval duration, and cells' dimension
+/// @param plate Plate to use
+/// @return Mult constant
+double calculate_mult_constant(plate_t* plate);
 
 /**
  * @brief Writes the updated plate matrix to a binary file.
@@ -60,9 +137,10 @@ void equilibrate_plate(plate_t* plate, uint64_t thread_count);
  * 
  * @param plate Pointer to the plate structure.
  * @param source_directory Directory where the file should be saved.
+ * @param io Way to write the plate file.
  * @return EXIT_SUCCESS on success, error code otherwise.
  */
-int update_plate_file(plate_t* plate, char* source_directory);
+int update_plate_file(plate_t* plate, char* source_directory, io_t io);
 
 /**
  * @brief Generates a filename for the updated plate state.
@@ -0,0 +1,152 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "plate_cache.h"
+
+/// @brief Returns the index of the entry of a file path, or count if the
+/// path is not cached
+size_t find_cached_plate(const plate_cache_t* plate_cache
+    , const char* file_path);
+
+/// @brief Frees the temperatures of an entry and removes it from the cache
+void evict_cached_plate(plate_cache_t* plate_cache, size_t index);
+
+/// @brief Checks if a cached entry still matches its file's metadata
+bool is_cached_plate_current(const cached_plate_t* cached_plate
+    , const struct stat* file_stat);
+
+plate_cache_t* init_plate_cache(size_t budget_bytes) {
+  plate_cache_t* plate_cache = (plate_cache_t*)
+      calloc(1, sizeof(plate_cache_t));
+  if (plate_cache) {
+    plate_cache->budget_bytes = budget_bytes;
+  }
+  return plate_cache;
+}
+
+plate_matrix_t* clone_cached_plate(plate_cache_t* plate_cache
+    , const char* file_path) {
+  const size_t index = find_cached_plate(plate_cache, file_path);
+  struct stat file_stat;
+
+  // A missing or outdated entry is a miss, outdated ones are also evicted
+  if (index == plate_cache->count) {
+    ++plate_cache->misses;
+    return NULL;
+  }
+  if (stat(file_path, &file_stat) != 0
+      || !is_cached_plate_current(&plate_cache->entries[index], &file_stat)) {
+    evict_cached_plate(plate_cache, index);
+    ++plate_cache->misses;
+    return NULL;
+  }
+
+  cached_plate_t* cached_plate = &plate_cache->entries[index];
+  plate_matrix_t* plate_matrix = init_plate_matrix(cached_plate->rows
+      , cached_plate->cols);
+  if (!plate_matrix) return NULL;
+
+  // Clone the pristine temperatures with a single copy
+  memcpy(plate_matrix->matrix, cached_plate->temperatures, sizeof(double)
+      * cached_plate->rows * cached_plate->cols);
+  cached_plate->last_use = ++plate_cache->clock;
+  ++plate_cache->hits;
+  return plate_matrix;
+}
+
+void store_cached_plate(plate_cache_t* plate_cache, const char* file_path
+    , const plate_matrix_t* plate_matrix) {
+  const size_t bytes = sizeof(double) * plate_matrix->rows
+      * plate_matrix->cols;
+  struct stat file_stat;
+  // Plates larger than the whole budget are never cached
+  if (bytes > plate_cache->budget_bytes || stat(file_path, &file_stat) != 0) {
+    return;
+  }
+
+  // Remove a previous version of the same file, if any
+  size_t index = find_cached_plate(plate_cache, file_path);
+  if (index < plate_cache->count) evict_cached_plate(plate_cache, index);
+
+  // Evict least recently used plates until the new one fits
+  while (plate_cache->used_bytes + bytes > plate_cache->budget_bytes) {
+    size_t oldest = 0;
+    for (index = 1; index < plate_cache->count; ++index) {
+      if (plate_cache->entries[index].last_use
+          < plate_cache->entries[oldest].last_use) {
+        oldest = index;
+      }
+    }
+    evict_cached_plate(plate_cache, oldest);
+    ++plate_cache->evictions;
+  }
+
+  // Expand entries array if needed
+  if (plate_cache->count == plate_cache->capacity) {
+    const size_t capacity = plate_cache->capacity ?
+        2 * plate_cache->capacity : 8;
+    cached_plate_t* entries = (cached_plate_t*) realloc(plate_cache->entries
+        , capacity * sizeof(cached_plate_t));
+    if (!entries) return;  // Plate simply is not cached
+    plate_cache->entries = entries;
+    plate_cache->capacity = capacity;
+  }
+
+  cached_plate_t* cached_plate = &plate_cache->entries[plate_cache->count];
+  cached_plate->file_path = (char*) calloc(1, strlen(file_path) + 1);
+  cached_plate->temperatures = (double*) malloc(bytes);
+  if (!cached_plate->file_path || !cached_plate->temperatures) {
+    free(cached_plate->file_path);
+    free(cached_plate->temperatures);
+    return;
+  }
+
+  snprintf(cached_plate->file_path, strlen(file_path) + 1, "%s", file_path);
+  cached_plate->modified_time = file_stat.st_mtim;
+  cached_plate->file_size = file_stat.st_size;
+  cached_plate->rows = plate_matrix->rows;
+  cached_plate->cols = plate_matrix->cols;
+  memcpy(cached_plate->temperatures, plate_matrix->matrix, bytes);
+  cached_plate->last_use = ++plate_cache->clock;
+
+  plate_cache->used_bytes += bytes;
+  ++plate_cache->count;
+}
+
+void destroy_plate_cache(plate_cache_t* plate_cache) {
+  if (!plate_cache) return;
+  for (size_t index = 0; index < plate_cache->count; ++index) {
+    free(plate_cache->entries[index].file_path);
+    free(plate_cache->entries[index].temperatures);
+  }
+  free(plate_cache->entries);
+  free(plate_cache);
+}
+
+size_t find_cached_plate(const plate_cache_t* plate_cache
+    , const char* file_path) {
+  for (size_t index = 0; index < plate_cache->count; ++index) {
+    if (strcmp(plate_cache->entries[index].file_path, file_path) == 0) {
+      return index;
+    }
+  }
+  return plate_cache->count;
+}
+
+void evict_cached_plate(plate_cache_t* plate_cache, size_t index) {
+  cached_plate_t* cached_plate = &plate_cache->entries[index];
+  plate_cache->used_bytes -= sizeof(double) * cached_plate->rows
+      * cached_plate->cols;
+  free(cached_plate->file_path);
+  free(cached_plate->temperatures);
+
+  // Last entry takes the place of the evicted one
+  --plate_cache->count;
+  plate_cache->entries[index] = plate_cache->entries[plate_cache->count];
+}
+
+bool is_cached_plate_current(const cached_plate_t* cached_plate
+    , const struct stat* file_stat) {
+  return cached_plate->file_size == file_stat->st_size
+      && cached_plate->modified_time.tv_sec == file_stat->st_mtim.tv_sec
+      && cached_plate->modified_time.tv_nsec == file_stat->st_mtim.tv_nsec;
+}
@@ -0,0 +1,87 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef PLATE_CACHE_H
+#define PLATE_CACHE_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "plate_matrix.h"
+
+/** @brief Default memory budget of the plate cache, in MiB. */
+#define DEFAULT_PLATE_CACHE_MIB 512
+
+/**
+ * @struct cached_plate_t
+ * @brief Pristine copy of the temperatures read from a plate file.
+ */
+typedef struct {
+  char* file_path;                ///< Path of the plate file
+  struct timespec modified_time;  ///< Modification time when it was read
+  off_t file_size;                ///< Size of the file when it was read
+  uint64_t rows;                  ///< Rows of the plate
+  uint64_t cols;                  ///< Columns of the plate
+  double* temperatures;           ///< Initial temperatures, never modified
+  uint64_t last_use;              ///< Cache clock on last hit, for LRU
+} cached_plate_t;
+
+/**
+ * @struct plate_cache_t
+ * @brief Job level cache of plate files, so plates repeated in a job are read
+ * once. Least recently used plates are evicted to respect a memory budget.
+ */
+typedef struct {
+  cached_plate_t* entries;  ///< Cached plates
+  size_t count;             ///< Amount of cached plates
+  size_t capacity;          ///< Capacity of the entries array
+  size_t used_bytes;        ///< Bytes of temperatures currently cached
+  size_t budget_bytes;      ///< Maximum bytes of temperatures to cache
+  uint64_t clock;           ///< Increases on every access
+  uint64_t hits;            ///< Plates cloned from the cache
+  uint64_t misses;          ///< Plates that had to be read from their file
+  uint64_t evictions;       ///< Plates evicted to respect the budget
+} plate_cache_t;
+
+/**
+ * @brief Creates an empty plate cache.
+ * @param budget_bytes Maximum bytes of temperatures to keep in memory.
+ * @return Pointer to the cache, or NULL on failure.
+ */
+plate_cache_t* init_plate_cache(size_t budget_bytes);
+
+/**
+ * @brief Creates a plate matrix with the temperatures cached for a file.
+ *
+ * The file is considered the same if its modification time and size did not
+ * change since it was cached. Temperatures are cloned with a single memcpy.
+ *
+ * @param plate_cache Cache to look in.
+ * @param file_path Path of the plate file.
+ * @return New plate matrix (auxiliary not initialized), or NULL if the plate
+ * is not cached, is outdated, or memory could not be allocated.
+ */
+plate_matrix_t* clone_cached_plate(plate_cache_t* plate_cache
+    , const char* file_path);
+
+/**
+ * @brief Keeps a pristine copy of a plate matrix just read from its file.
+ *
+ * Least recently used plates are evicted until the copy fits in the budget.
+ * Plates larger than the whole budget are not cached.
+ *
+ * @param plate_cache Cache to store the plate in.
+ * @param file_path Path of the plate file.
+ * @param plate_matrix Plate matrix with the temperatures of the file.
+ */
+void store_cached_plate(plate_cache_t* plate_cache, const char* file_path
+    , const plate_matrix_t* plate_matrix);
+
+/// @brief Frees every cached plate and the cache itself
+void destroy_plate_cache(plate_cache_t* plate_cache);
+
+#endif  // PLATE_CACHE_H
@@ -0,0 +1,197 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "plate_io.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Writes a whole buffer to a file descriptor, retrying short writes.
+ * @return EXIT_SUCCESS on success, ERR_WRITE_OUTPUT_FILE otherwise.
+ */
+int write_all(int file, const char* buffer, size_t size);
+
+int read_plate_mmap(const char* plate_file_path
+    , plate_matrix_t** plate_matrix) {
+  const int plate_file = open(plate_file_path, O_RDONLY);
+  if (plate_file < 0) {
+    fprintf(stderr, "Error: Plate file %s could not be opened\n"
+        , plate_file_path);
+    return ERR_OPEN_PLATE_FILE;
+  }
+
+  struct stat file_stat;
+  if (fstat(plate_file, &file_stat) != 0
+      || (size_t) file_stat.st_size < PLATE_HEADER_SIZE) {
+    fprintf(stderr, "Error: Rows and cols could not be read\n");
+    close(plate_file);
+    return ERR_ROWS_COLS;
+  }
+
+  const size_t file_size = (size_t) file_stat.st_size;
+  const char* mapping = (const char*) mmap(NULL, file_size, PROT_READ
+      , MAP_PRIVATE, plate_file, 0);
+  // Mapping stays valid after the file is closed
+  close(plate_file);
+  if (mapping == MAP_FAILED) {
+    perror("Error: Could not map plate file");
+    return ERR_MAP_PLATE_FILE;
+  }
+  // Pages are read ahead aggressively and dropped soon after being copied
+  madvise((void*) mapping, file_size, MADV_SEQUENTIAL);
+
+  uint64_t rows = 0, cols = 0;
+  memcpy(&rows, mapping, sizeof(uint64_t));
+  memcpy(&cols, mapping + sizeof(uint64_t), sizeof(uint64_t));
+
+  // Temperatures must be in the file, or reading them would fault
+  const size_t cells = (file_size - PLATE_HEADER_SIZE) / sizeof(double);
+  if (rows == 0 || cols == 0 || cells / cols < rows) {
+    fprintf(stderr, "Error: Rows and cols could not be read\n");
+    munmap((void*) mapping, file_size);
+    return ERR_ROWS_COLS;
+  }
+
+  *plate_matrix = init_plate_matrix(rows, cols);
+  if (*plate_matrix) {
+    memcpy((*plate_matrix)->matrix, mapping + PLATE_HEADER_SIZE
+        , rows * cols * sizeof(double));
+  }
+  munmap((void*) mapping, file_size);
+
+  if (!*plate_matrix) {
+    fprintf(stderr, "Error: Could not map plate file\n");
+    return ERR_MAP_PLATE_FILE;
+  }
+  return EXIT_SUCCESS;
+}
+
+int write_plate_mmap(const char* plate_file_path
+    , const plate_matrix_t* plate_matrix) {
+  const int output_file = open(plate_file_path, O_RDWR | O_CREAT | O_TRUNC
+      , 0644);
+  if (output_file < 0) {
+    perror("Error: Could not open output file");
+    return ERR_OPEN_OUTPUT_FILE;
+  }
+
+  const size_t matrix_size = plate_matrix->rows * plate_matrix->cols
+      * sizeof(double);
+  const size_t file_size = PLATE_HEADER_SIZE + matrix_size;
+  // The file is sized beforehand, so the whole mapping is backed by it
+  char* mapping = MAP_FAILED;
+  if (ftruncate(output_file, (off_t) file_size) == 0) {
+    mapping = (char*) mmap(NULL, file_size, PROT_WRITE, MAP_SHARED
+        , output_file, 0);
+  }
+  close(output_file);
+  if (mapping == MAP_FAILED) {
+    perror("Error: Could not write output file");
+    return ERR_WRITE_OUTPUT_FILE;
+  }
+
+  memcpy(mapping, &plate_matrix->rows, sizeof(uint64_t));
+  memcpy(mapping + sizeof(uint64_t), &plate_matrix->cols, sizeof(uint64_t));
+  memcpy(mapping + PLATE_HEADER_SIZE, plate_matrix->matrix, matrix_size);
+
+  // Dirty pages are written back by the kernel after unmapping
+  if (munmap(mapping, file_size) != 0) {
+    perror("Error: Could not write output file");
+    return ERR_WRITE_OUTPUT_FILE;
+  }
+  return EXIT_SUCCESS;
+}
+
+int write_plate_direct(const char* plate_file_path
+    , const plate_matrix_t* plate_matrix) {
+  const int output_file = open(plate_file_path
+      , O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+  if (output_file < 0) {
+    // File systems like tmpfs reject O_DIRECT
+    if (errno == EINVAL) {
+      return write_plate_mmap(plate_file_path, plate_matrix);
+    }
+    perror("Error: Could not open output file");
+    return ERR_OPEN_OUTPUT_FILE;
+  }
+
+  char* buffer = NULL;
+  if (posix_memalign((void**) &buffer, DIRECT_IO_ALIGNMENT
+      , DIRECT_IO_BUFFER_SIZE) != 0) {
+    fprintf(stderr, "Error: Could not write output file\n");
+    close(output_file);
+    return ERR_WRITE_OUTPUT_FILE;
+  }
+
+  // Header and temperatures are streamed through the staging buffer
+  memcpy(buffer, &plate_matrix->rows, sizeof(uint64_t));
+  memcpy(buffer + sizeof(uint64_t), &plate_matrix->cols, sizeof(uint64_t));
+  size_t used = PLATE_HEADER_SIZE;
+  const char* matrix = (const char*) plate_matrix->matrix;
+  size_t remaining = plate_matrix->rows * plate_matrix->cols
+      * sizeof(double);
+  const size_t file_size = PLATE_HEADER_SIZE + remaining;
+
+  int error = EXIT_SUCCESS;
+  while (error == EXIT_SUCCESS && (remaining > 0 || used > 0)) {
+    const size_t chunk = remaining < DIRECT_IO_BUFFER_SIZE - used ?
+        remaining : DIRECT_IO_BUFFER_SIZE - used;
+    memcpy(buffer + used, matrix, chunk);
+    matrix += chunk;
+    remaining -= chunk;
+    used += chunk;
+
+    if (used == DIRECT_IO_BUFFER_SIZE || remaining == 0) {
+      // Last block is padded with zeros to the alignment, truncated below
+      const size_t aligned = (used + DIRECT_IO_ALIGNMENT - 1)
+          / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+      memset(buffer + used, 0, aligned - used);
+      error = write_all(output_file, buffer, aligned);
+      used = 0;
+    }
+  }
+  free(buffer);
+
+  if (error == EXIT_SUCCESS && ftruncate(output_file, (off_t) file_size)
+      != 0) {
+    perror("Error: Could not write output file");
+    error = ERR_WRITE_OUTPUT_FILE;
+  }
+  close(output_file);
+  return error;
+}
+
+void prefetch_plate_file(const char* plate_file_path) {
+  const int file = open(plate_file_path, O_RDONLY);
+  if (file < 0) return;
+  // Readahead continues after the file is closed. Failures are ignored, the
+  // file is simply read from disk later
+  posix_fadvise(file, 0, 0, POSIX_FADV_WILLNEED);
+  close(file);
+}
+
+const char* get_io_name(io_t io) {
+  switch (io) {
+    case IO_MMAP: return "mmap";
+    case IO_DIRECT: return "direct";
+    default: return "stdio";
+  }
+}
+
+int write_all(int file, const char* buffer, size_t size) {
+  while (size > 0) {
+    const ssize_t written = write(file, buffer, size);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      perror("Error: Could not write output file");
+      return ERR_WRITE_OUTPUT_FILE;
+    }
+    buffer += written;
+    size -= (size_t) written;
+  }
+  return EXIT_SUCCESS;
+}
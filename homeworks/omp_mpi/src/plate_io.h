@@ -0,0 +1,85 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef PLATE_IO_H
+#define PLATE_IO_H
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "errors.h"
+#include "plate_matrix.h"
+
+/** @brief Bytes of the rows and cols header of plate files. */
+#define PLATE_HEADER_SIZE (2 * sizeof(uint64_t))
+
+/** @brief Alignment of buffers, offsets and sizes written with O_DIRECT. */
+#define DIRECT_IO_ALIGNMENT 4096
+
+/** @brief Bytes of the staging buffer used to write with O_DIRECT. */
+#define DIRECT_IO_BUFFER_SIZE (4 * 1024 * 1024)
+
+/**
+ * @enum io_t
+ * @brief Ways to read and write plate files.
+ */
+typedef enum {
+  IO_STDIO,   ///< Buffered fread and fwrite of each row
+  IO_MMAP,    ///< Files mapped in memory, copied with a single memcpy
+  IO_DIRECT   ///< Read like IO_MMAP, written with O_DIRECT bypassing cache
+} io_t;
+
+/**
+ * @brief Reads a plate file by mapping it in memory.
+ *
+ * The file is mapped read-only with sequential access advice, and its
+ * temperatures are copied into a new plate matrix with a single memcpy.
+ *
+ * @param plate_file_path Path of the plate file.
+ * @param plate_matrix Where the new plate matrix (auxiliary not initialized)
+ * is stored.
+ * @return EXIT_SUCCESS on success, error code otherwise.
+ */
+int read_plate_mmap(const char* plate_file_path
+    , plate_matrix_t** plate_matrix);
+
+/**
+ * @brief Writes a plate file through a memory mapping of the output file,
+ * sized beforehand to hold the header and the whole matrix.
+ *
+ * @param plate_file_path Path of the plate file to create.
+ * @param plate_matrix Plate matrix with the temperatures to write.
+ * @return EXIT_SUCCESS on success, error code otherwise.
+ */
+int write_plate_mmap(const char* plate_file_path
+    , const plate_matrix_t* plate_matrix);
+
+/**
+ * @brief Writes a plate file with O_DIRECT, through an aligned staging
+ * buffer, so the temperatures do not pollute the page cache.
+ *
+ * The last block is padded to the alignment, and the file is truncated to
+ * its real size afterwards. File systems that do not support O_DIRECT are
+ * written with write_plate_mmap instead.
+ *
+ * @see write_plate_mmap
+ */
+int write_plate_direct(const char* plate_file_path
+    , const plate_matrix_t* plate_matrix);
+
+/**
+ * @brief Asks the kernel to read a plate file into the page cache in the
+ * background, so reading it later does not wait for the disk.
+ *
+ * @param plate_file_path Path of the plate file.
+ */
+void prefetch_plate_file(const char* plate_file_path);
+
+/// @brief Returns the name used in the command line for an io mode.
+const char* get_io_name(io_t io);
+
+#endif  // PLATE_IO_H
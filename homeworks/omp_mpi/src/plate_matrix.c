@@ -22,22 +22,19 @@ plate_matrix_t* init_plate_matrix(uint64_t rows, uint64_t cols) {
     return NULL;
   }
 
-  // Allocate the auxiliary matrix
-  plate_matrix->auxiliary_matrix = (double*) calloc(rows*cols, sizeof(double));
-  if (!plate_matrix->auxiliary_matrix) {
-    free(plate_matrix->matrix);  // Free main matrix before returning
-    free(plate_matrix);
-    return NULL;
-  }
-
   return plate_matrix;
 }
 
 
 
-void init_auxiliary(plate_matrix_t* plate_matrix) {
+int init_auxiliary(plate_matrix_t* plate_matrix) {
   double* initial_matrix = plate_matrix->matrix;
 
+  // Allocate the auxiliary matrix
+  plate_matrix->auxiliary_matrix = (double*) calloc(plate_matrix->rows
+      * plate_matrix->cols, sizeof(double));
+  if (!plate_matrix->auxiliary_matrix) return EXIT_FAILURE;
+
   // Copy first row to auxiliary matrix
   for (uint64_t col = 0; col < plate_matrix->cols; ++col) {
     plate_matrix->auxiliary_matrix[/*0 * cols + */ col]
@@ -63,6 +60,7 @@ void init_auxiliary(plate_matrix_t* plate_matrix) {
     uint64_t index = row * plate_matrix-> cols + last_col;
     plate_matrix->auxiliary_matrix[index] = initial_matrix[index];
   }
+  return EXIT_SUCCESS;
 }
 
 
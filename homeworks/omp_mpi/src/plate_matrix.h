@@ -8,21 +8,35 @@
 #include <stdbool.h>
 #include <stdlib.h>
 
+/**
+ * @brief Declares a plate matrix struct with cells of a floating point type,
+ * so plate matrices of every precision have the same fields.
+ */
+#define PLATE_MATRIX_STRUCT(cell_type) \
+  struct { \
+    uint64_t rows;          /**< Number of rows in the matrix */ \
+    uint64_t cols;          /**< Number of columns in the matrix */ \
+    cell_type* matrix;      /**< Pointer to the primary matrix */ \
+    cell_type* auxiliary_matrix; /**< Pointer to the auxiliary matrix */ \
+  }
+
 /** 
  * @struct plate_matrix_t
  * @brief Represents a heat diffusion plate matrix.
  */
-typedef struct {
-    uint64_t rows;          /**< Number of rows in the matrix */
-    uint64_t cols;          /**< Number of columns in the matrix */
-    double* matrix;        /**< Pointer to the primary matrix */
-    double* auxiliary_matrix; /**< Pointer to the auxiliary matrix */
-} plate_matrix_t;
+typedef PLATE_MATRIX_STRUCT(double) plate_matrix_t;
+
+/**
+ * @struct plate_matrix_float_t
+ * @brief Plate matrix in single precision, used by the float kernel.
+ */
+typedef PLATE_MATRIX_STRUCT(float) plate_matrix_float_t;
 
 /**
  * @brief Initializes a plate matrix with specified dimensions.
  * 
- * Allocates memory for both primary and auxiliary matrices.
+ * Allocates memory for the primary matrix. The auxiliary matrix is only
+ * allocated by init_auxiliary, for kernels that swap matrices.
  * 
  * @param rows Number of rows.
  * @param cols Number of columns.
@@ -31,13 +45,14 @@ typedef struct {
 plate_matrix_t* init_plate_matrix(uint64_t rows, uint64_t cols);
 
 /**
- * @brief Initializes the auxiliary matrix by copying boundary values.
+ * @brief Allocates the auxiliary matrix and copies boundary values to it.
  * 
  * Copies borders ensuring the boundary conditions remain constant.
  * 
  * @param plate_matrix Pointer to the plate matrix.
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE if it could not be allocated.
  */
-void init_auxiliary(plate_matrix_t* plate_matrix);
+int init_auxiliary(plate_matrix_t* plate_matrix);
 
 /**
  * @brief Swaps the primary and auxiliary matrices. Used to update the
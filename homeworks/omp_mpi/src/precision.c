@@ -0,0 +1,119 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "precision.h"
+#include "placement.h"
+#include <float.h>
+#include <omp.h>
+
+int equilibrate_plate_float(plate_t* plate, const options_t* options) {
+  plate_matrix_t* plate_matrix = plate->plate_matrix;
+  const uint64_t rows = plate_matrix->rows;
+  const uint64_t cols = plate_matrix->cols;
+  const double epsilon = plate->epsilon;
+  double stop_delta = options->precision == PRECISION_MIXED ?
+      MIXED_PROMOTION_FACTOR * epsilon : epsilon;
+  // Already close enough to epsilon to be finished in double
+  if (plate->k_states > 0 && plate->max_delta <= stop_delta) {
+    return EXIT_SUCCESS;
+  }
+
+  plate_matrix_float_t float_matrix = {rows, cols
+      , (float*) malloc(rows * cols * sizeof(float))
+      , (float*) malloc(rows * cols * sizeof(float))};
+  if (!float_matrix.matrix || !float_matrix.auxiliary_matrix) {
+    fprintf(stderr, "Error: Could not allocate float plate matrix\n");
+    free(float_matrix.matrix);
+    free(float_matrix.auxiliary_matrix);
+    return ERR_KERNEL_ALLOC;
+  }
+
+  const update_row_float_t update_row = get_update_row_float(options->simd);
+  const float mult_constant = (float) calculate_mult_constant(plate);
+  const uint64_t interior_cols = cols > 2 ? cols - 2 : 0;
+  double max_temperature = 0;
+  double resolution = 0;
+  double max_delta = 0;
+  // States until the stop state, or unlimited
+  const uint64_t state_budget = plate->stop_state ?
+      plate->stop_state - plate->k_states : UINT64_MAX;
+  uint64_t states = 0;
+
+  #pragma omp parallel num_threads(options->thread_count) default(none) \
+      shared(options, plate, plate_matrix, float_matrix, rows, cols \
+      , update_row, mult_constant \
+      , interior_cols, stop_delta, max_temperature, resolution, max_delta \
+      , state_budget, states)
+  {  // NOLINT (whitespace/braces)
+    pin_thread(options, omp_get_thread_num());
+    // Both float matrices are first touched with the same static map by
+    // blocks used to simulate states, like NUMA mode does with doubles
+    #pragma omp for schedule(static) reduction(max:max_temperature)
+    for (size_t row = 0; row < rows; ++row) {
+      for (size_t col = 0; col < cols; ++col) {
+        const size_t cell = row * cols + col;
+        const float temperature = (float) plate_matrix->matrix[cell];
+        float_matrix.matrix[cell] = temperature;
+        float_matrix.auxiliary_matrix[cell] = temperature;
+        if (fabsf(temperature) > max_temperature) {
+          max_temperature = fabsf(temperature);
+        }
+      }
+    }
+
+    #pragma omp single
+    {
+      resolution = max_temperature * FLT_EPSILON * FLOAT_RESOLUTION_ULPS;
+      if (resolution > stop_delta) stop_delta = resolution;
+    }
+
+    while (true) {
+      #pragma omp single
+      {
+        if (states > 0) {
+          trace_state(plate->trace, plate->k_states + states, max_delta);
+        }
+        ++states;
+        // Same swap as set_auxiliary, new temperatures overwrite the oldest
+        float* current_temperatures = float_matrix.matrix;
+        float_matrix.matrix = float_matrix.auxiliary_matrix;
+        float_matrix.auxiliary_matrix = current_temperatures;
+        max_delta = 0;
+      }
+
+      #pragma omp for schedule(static) reduction(max:max_delta)
+      for (size_t row = 1; row < rows - 1; ++row) {
+        const size_t first_cell = row * cols + 1;
+        const double max_difference = update_row(
+            float_matrix.auxiliary_matrix + first_cell
+            , float_matrix.matrix + first_cell, interior_cols, cols
+            , mult_constant);
+
+        if (max_difference > max_delta) max_delta = max_difference;
+      }
+
+      if (max_delta <= stop_delta || states == state_budget) break;
+      #pragma omp barrier
+    }
+
+    // Borders never change, so only the interior is stored back
+    #pragma omp for schedule(static)
+    for (size_t row = 1; row < rows - 1; ++row) {
+      for (size_t col = 1; col + 1 < cols; ++col) {
+        const size_t cell = row * cols + col;
+        plate_matrix->matrix[cell] = float_matrix.matrix[cell];
+      }
+    }
+  }
+
+  plate->k_states += states;
+  plate->float_states += states;
+  // Float changes smaller than its resolution may have been rounded to zero,
+  // so the plate is only known to be within the resolution of equilibrium
+  plate->max_delta = max_delta > resolution ? max_delta : resolution;
+  // Every state reads the whole current matrix and writes the whole new one
+  plate->moved_bytes += states * 2 * sizeof(float) * rows * cols;
+
+  free(float_matrix.matrix);
+  free(float_matrix.auxiliary_matrix);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,39 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef PRECISION_H
+#define PRECISION_H
+
+#include "options.h"
+#include "plate.h"
+
+/** @brief Mixed precision promotes to double once max delta is within this
+ * factor of epsilon. */
+#define MIXED_PROMOTION_FACTOR 16
+
+/** @brief Float changes below these units in the last place of the hottest
+ * cell are rounding noise, not heat transfer. */
+#define FLOAT_RESOLUTION_ULPS 8
+
+/**
+ * @brief Simulates states of a plate in single precision, sweeping the whole
+ * float matrix once per state.
+ *
+ * The double temperatures are rounded to a float copy of the plate, which is
+ * simulated until max delta is within epsilon (float precision), or within
+ * MIXED_PROMOTION_FACTOR times epsilon (mixed precision). Simulation also
+ * stops if max delta is within the resolution of float for the hottest cell,
+ * since smaller epsilons can not be reached in float. The final temperatures
+ * are stored back in the double matrix, and max delta is never recorded
+ * below that resolution, so the caller finishes the plate in double if max
+ * delta is still greater than epsilon.
+ *
+ * A plate continued from a greater epsilon whose max delta is already within
+ * the promotion threshold is not simulated again in float.
+ *
+ * @param plate Plate to simulate, its double matrix holds the current state
+ * @param options Options with amount of threads and precision
+ * @return EXIT_SUCCESS on success, ERR_KERNEL_ALLOC otherwise.
+ */
+int equilibrate_plate_float(plate_t* plate, const options_t* options);
+
+#endif  // PRECISION_H
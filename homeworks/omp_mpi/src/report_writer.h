@@ -0,0 +1,94 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef REPORT_WRITER_H
+#define REPORT_WRITER_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "job_file.h"
+#include "threads.h"
+
+/** @brief Bytes buffered by the report writer before writing to its file */
+#define REPORT_BUFFER_SIZE (1 << 20)
+/** @brief Seconds between flushes of the lines written to the report files */
+#define REPORT_FLUSH_SECONDS 1.0
+
+/**
+ * @struct report_writer_t
+ * @brief Background thread writing the report of a job while it runs.
+ *
+ * Plates are reported as they finish, in any order, and the writer writes the
+ * line of every plate in job order: the finished plates after the last one
+ * written wait in a reorder buffer of one flag per plate. Lines are formatted
+ * into a large stdio buffer, which is flushed at most every
+ * REPORT_FLUSH_SECONDS, and at most REPORT_FLUSH_SECONDS after a line was
+ * written to it, so the report of finished plates survives a job that dies
+ * later without a write per plate.
+ */
+typedef struct {
+  thrd_t thread;                ///< Thread formatting and writing lines
+  mtx_t mutex;                  ///< Protects finished, next_plate and stop
+  cnd_t changed;                ///< Signals finished plates or stop
+  const job_file_t* job_file;   ///< Table with the results of the plates
+  bool* finished;               ///< Plates reported as finished
+  size_t plates_count;          ///< Plates of the job
+  size_t next_plate;            ///< First plate not written yet
+  bool started;                 ///< True once the thread was started
+  bool stop;                    ///< True to finish the thread
+  bool failed;                  ///< True if a line could not be written
+  FILE* report_file;            ///< Report of the job, a line per plate
+  FILE* sidecar_file;           ///< Timing of each plate, NULL if disabled
+  char* report_buffer;          ///< Buffer of the report file
+  uint64_t* previous_plates;    ///< Previous rung of each plate, or itself
+} report_writer_t;
+
+/**
+ * @brief Opens the report files and starts the background thread.
+ *
+ * @param writer Writer to initialize
+ * @param job_file Table of plates, with their ladders
+ * @param report_path Path of the report of the job
+ * @param sidecar_path Path of the CSV with the wall time and states per
+ * second of each plate, NULL for none
+ * @return EXIT_SUCCESS on success, error code otherwise.
+ */
+int init_report_writer(report_writer_t* writer, const job_file_t* job_file
+    , const char* report_path, const char* sidecar_path);
+
+/**
+ * @brief Reports that a plate finished, with its states in the table.
+ * @param writer Writer of the report
+ * @param plate_number Plate finished
+ */
+void report_plate(report_writer_t* writer, size_t plate_number);
+
+/**
+ * @brief Writes the lines of the plates finished so far, stops the thread,
+ * and flushes the report to disk with fsync before closing it.
+ *
+ * @param writer Writer to destroy
+ * @return EXIT_SUCCESS if every plate was written, EXIT_FAILURE otherwise.
+ */
+int destroy_report_writer(report_writer_t* writer);
+
+/// @brief Writes the results of a plate's simulation into a file
+/// @param results_file Results file to report to
+/// @param job_file Table with the plates
+/// @param plate_number Number of plate to extract data from
+void write_result(FILE* results_file, const job_file_t* job_file
+    , size_t plate_number);
+
+/**
+ * @brief Formats a time value into a human-readable string.
+ * @param seconds Time in seconds.
+ * @param text Buffer to store formatted time.
+ * @param capacity Size of the buffer.
+ * @return Pointer to formatted time string.
+ */
+char* format_time(const time_t seconds, char* text, const size_t capacity);
+
+#endif  // REPORT_WRITER_H
@@ -0,0 +1,310 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "row_kernel.h"
+
+#include <math.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ROW_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+// Vector implementations use explicit multiplications and additions in the
+// same order as update_cell. Results are identical only if the compiler does
+// not fuse them (FMA), which ISO C modes (-std=c17) do not do by default.
+
+/// @brief Updates row one cell at a time
+/// @see update_row_t
+double update_row_scalar(const double* current, double* result
+    , uint64_t count, uint64_t stride, double mult_constant);
+
+#ifdef ROW_KERNEL_X86
+/// @brief Updates row two cells at a time
+/// @see update_row_t
+double update_row_sse2(const double* current, double* result
+    , uint64_t count, uint64_t stride, double mult_constant);
+
+/// @brief Updates row four cells at a time
+/// @see update_row_t
+double update_row_avx2(const double* current, double* result
+    , uint64_t count, uint64_t stride, double mult_constant);
+
+/// @brief Updates row eight cells at a time
+/// @see update_row_t
+double update_row_avx512(const double* current, double* result
+    , uint64_t count, uint64_t stride, double mult_constant);
+#endif
+
+/**
+ * @brief Defines a float row kernel compiled for an instruction set.
+ *
+ * Same operations and order as update_row_scalar. The max delta reduction
+ * is vectorized with omp simd, since float max is exact in any order.
+ */
+#define DEFINE_UPDATE_ROW_FLOAT(name, attributes) \
+  attributes float name(const float* current, float* result \
+      , uint64_t count, uint64_t stride, float mult_constant) { \
+    float max_delta = 0; \
+    _Pragma("omp simd reduction(max:max_delta)") \
+    for (uint64_t col = 0; col < count; ++col) { \
+      float value = -4 * current[col]; \
+      value += current[col - stride]; \
+      value += current[col + 1]; \
+      value += current[col + stride]; \
+      value += current[col - 1]; \
+      value *= mult_constant; \
+      value += current[col]; \
+      result[col] = value; \
+      const float delta = fabsf(value - current[col]); \
+      max_delta = delta > max_delta ? delta : max_delta; \
+    } \
+    return max_delta; \
+  }
+
+DEFINE_UPDATE_ROW_FLOAT(update_row_float_scalar, )
+#ifdef ROW_KERNEL_X86
+DEFINE_UPDATE_ROW_FLOAT(update_row_float_sse2
+    , __attribute__((target("sse2"))))
+DEFINE_UPDATE_ROW_FLOAT(update_row_float_avx2
+    , __attribute__((target("avx2"))))
+DEFINE_UPDATE_ROW_FLOAT(update_row_float_avx512
+    , __attribute__((target("avx512f"))))
+#endif
+
+/**
+ * @brief Defines an unchecked row kernel compiled for an instruction set.
+ *
+ * Same operations and order as update_row_scalar, without the absolute
+ * difference and maximum of every cell.
+ */
+#define DEFINE_UPDATE_ROW_UNCHECKED(name, attributes) \
+  attributes void name(const double* current, double* result \
+      , uint64_t count, uint64_t stride, double mult_constant) { \
+    _Pragma("omp simd") \
+    for (uint64_t col = 0; col < count; ++col) { \
+      double value = -4 * current[col]; \
+      value += current[col - stride]; \
+      value += current[col + 1]; \
+      value += current[col + stride]; \
+      value += current[col - 1]; \
+      value *= mult_constant; \
+      value += current[col]; \
+      result[col] = value; \
+    } \
+  }
+
+DEFINE_UPDATE_ROW_UNCHECKED(update_row_unchecked_scalar, )
+#ifdef ROW_KERNEL_X86
+DEFINE_UPDATE_ROW_UNCHECKED(update_row_unchecked_sse2
+    , __attribute__((target("sse2"))))
+DEFINE_UPDATE_ROW_UNCHECKED(update_row_unchecked_avx2
+    , __attribute__((target("avx2"))))
+DEFINE_UPDATE_ROW_UNCHECKED(update_row_unchecked_avx512
+    , __attribute__((target("avx512f"))))
+#endif
+
+/// @brief Resolves SIMD_AUTO to the widest instruction set supported
+simd_t resolve_simd(simd_t simd);
+
+/// @brief Returns the greatest of two deltas
+static inline double max_double(double first, double second) {
+  return first > second ? first : second;
+}
+
+update_row_t get_update_row(simd_t simd) {
+  simd = resolve_simd(simd);
+  if (!is_simd_supported(simd)) return NULL;
+
+  switch (simd) {
+#ifdef ROW_KERNEL_X86
+    case SIMD_SSE2: return update_row_sse2;
+    case SIMD_AVX2: return update_row_avx2;
+    case SIMD_AVX512: return update_row_avx512;
+#endif
+    default: return update_row_scalar;
+  }
+}
+
+update_row_float_t get_update_row_float(simd_t simd) {
+  simd = resolve_simd(simd);
+  if (!is_simd_supported(simd)) return NULL;
+
+  switch (simd) {
+#ifdef ROW_KERNEL_X86
+    case SIMD_SSE2: return update_row_float_sse2;
+    case SIMD_AVX2: return update_row_float_avx2;
+    case SIMD_AVX512: return update_row_float_avx512;
+#endif
+    default: return update_row_float_scalar;
+  }
+}
+
+update_row_unchecked_t get_update_row_unchecked(simd_t simd) {
+  simd = resolve_simd(simd);
+  if (!is_simd_supported(simd)) return NULL;
+
+  switch (simd) {
+#ifdef ROW_KERNEL_X86
+    case SIMD_SSE2: return update_row_unchecked_sse2;
+    case SIMD_AVX2: return update_row_unchecked_avx2;
+    case SIMD_AVX512: return update_row_unchecked_avx512;
+#endif
+    default: return update_row_unchecked_scalar;
+  }
+}
+
+bool is_simd_supported(simd_t simd) {
+  switch (simd) {
+    case SIMD_AUTO: case SIMD_SCALAR: return true;
+#ifdef ROW_KERNEL_X86
+    case SIMD_SSE2: return __builtin_cpu_supports("sse2");
+    case SIMD_AVX2: return __builtin_cpu_supports("avx2");
+    case SIMD_AVX512: return __builtin_cpu_supports("avx512f");
+#endif
+    default: return false;
+  }
+}
+
+const char* get_simd_name(simd_t simd) {
+  switch (resolve_simd(simd)) {
+    case SIMD_SSE2: return "sse2";
+    case SIMD_AVX2: return "avx2";
+    case SIMD_AVX512: return "avx512";
+    default: return "scalar";
+  }
+}
+
+simd_t resolve_simd(simd_t simd) {
+  if (simd != SIMD_AUTO) return simd;
+  // Widest first
+  const simd_t candidates[] = {SIMD_AVX512, SIMD_AVX2, SIMD_SSE2};
+  for (size_t index = 0; index < sizeof(candidates) / sizeof(simd_t);
+      ++index) {
+    if (is_simd_supported(candidates[index])) return candidates[index];
+  }
+  return SIMD_SCALAR;
+}
+
+double update_row_scalar(const double* current, double* result
+    , uint64_t count, uint64_t stride, double mult_constant) {
+  double max_delta = 0;
+  for (uint64_t col = 0; col < count; ++col) {
+    // Compute net energy change using the heat diffusion equation
+    double value = -4 * current[col];
+    value += current[col - stride];  // Top neighbor
+    value += current[col + 1];  // Right neighbor
+    value += current[col + stride];  // Bottom neighbor
+    value += current[col - 1];  // Left neighbor
+    value *= mult_constant;
+    value += current[col];
+    result[col] = value;
+
+    // Track the maximum temperature change in this segment
+    const double delta = fabs(value - current[col]);
+    if (delta > max_delta) max_delta = delta;
+  }
+  return max_delta;
+}
+
+#ifdef ROW_KERNEL_X86
+__attribute__((target("sse2")))
+double update_row_sse2(const double* current, double* result
+    , uint64_t count, uint64_t stride, double mult_constant) {
+  const __m128d minus_four = _mm_set1_pd(-4.0);
+  const __m128d mult = _mm_set1_pd(mult_constant);
+  const __m128d sign_bit = _mm_set1_pd(-0.0);
+  __m128d max_delta = _mm_setzero_pd();
+
+  uint64_t col = 0;
+  for (; col + 2 <= count; col += 2) {
+    const __m128d center = _mm_loadu_pd(current + col);
+    __m128d value = _mm_mul_pd(minus_four, center);
+    value = _mm_add_pd(value, _mm_loadu_pd(current + col - stride));
+    value = _mm_add_pd(value, _mm_loadu_pd(current + col + 1));
+    value = _mm_add_pd(value, _mm_loadu_pd(current + col + stride));
+    value = _mm_add_pd(value, _mm_loadu_pd(current + col - 1));
+    value = _mm_mul_pd(value, mult);
+    value = _mm_add_pd(value, center);
+    _mm_storeu_pd(result + col, value);
+
+    // Absolute value clears the sign bit. Max keeps second operand on NaN,
+    // so NaN deltas are ignored like in the scalar comparison
+    const __m128d delta = _mm_andnot_pd(sign_bit, _mm_sub_pd(value, center));
+    max_delta = _mm_max_pd(delta, max_delta);
+  }
+
+  double lanes[2];
+  _mm_storeu_pd(lanes, max_delta);
+  double tail = update_row_scalar(current + col, result + col, count - col
+      , stride, mult_constant);
+  return max_double(max_double(lanes[0], lanes[1]), tail);
+}
+
+__attribute__((target("avx2")))
+double update_row_avx2(const double* current, double* result
+    , uint64_t count, uint64_t stride, double mult_constant) {
+  const __m256d minus_four = _mm256_set1_pd(-4.0);
+  const __m256d mult = _mm256_set1_pd(mult_constant);
+  const __m256d sign_bit = _mm256_set1_pd(-0.0);
+  __m256d max_delta = _mm256_setzero_pd();
+
+  uint64_t col = 0;
+  for (; col + 4 <= count; col += 4) {
+    const __m256d center = _mm256_loadu_pd(current + col);
+    __m256d value = _mm256_mul_pd(minus_four, center);
+    value = _mm256_add_pd(value, _mm256_loadu_pd(current + col - stride));
+    value = _mm256_add_pd(value, _mm256_loadu_pd(current + col + 1));
+    value = _mm256_add_pd(value, _mm256_loadu_pd(current + col + stride));
+    value = _mm256_add_pd(value, _mm256_loadu_pd(current + col - 1));
+    value = _mm256_mul_pd(value, mult);
+    value = _mm256_add_pd(value, center);
+    _mm256_storeu_pd(result + col, value);
+
+    const __m256d delta = _mm256_andnot_pd(sign_bit
+        , _mm256_sub_pd(value, center));
+    max_delta = _mm256_max_pd(delta, max_delta);
+  }
+
+  double lanes[4];
+  _mm256_storeu_pd(lanes, max_delta);
+  double tail = update_row_scalar(current + col, result + col, count - col
+      , stride, mult_constant);
+  for (size_t lane = 0; lane < 4; ++lane) {
+    tail = max_double(tail, lanes[lane]);
+  }
+  return tail;
+}
+
+__attribute__((target("avx512f")))
+double update_row_avx512(const double* current, double* result
+    , uint64_t count, uint64_t stride, double mult_constant) {
+  const __m512d minus_four = _mm512_set1_pd(-4.0);
+  const __m512d mult = _mm512_set1_pd(mult_constant);
+  __m512d max_delta = _mm512_setzero_pd();
+
+  uint64_t col = 0;
+  for (; col + 8 <= count; col += 8) {
+    const __m512d center = _mm512_loadu_pd(current + col);
+    __m512d value = _mm512_mul_pd(minus_four, center);
+    value = _mm512_add_pd(value, _mm512_loadu_pd(current + col - stride));
+    value = _mm512_add_pd(value, _mm512_loadu_pd(current + col + 1));
+    value = _mm512_add_pd(value, _mm512_loadu_pd(current + col + stride));
+    value = _mm512_add_pd(value, _mm512_loadu_pd(current + col - 1));
+    value = _mm512_mul_pd(value, mult);
+    value = _mm512_add_pd(value, center);
+    _mm512_storeu_pd(result + col, value);
+
+    const __m512d delta = _mm512_abs_pd(_mm512_sub_pd(value, center));
+    max_delta = _mm512_max_pd(delta, max_delta);
+  }
+
+  double lanes[8];
+  _mm512_storeu_pd(lanes, max_delta);
+  double tail = update_row_scalar(current + col, result + col, count - col
+      , stride, mult_constant);
+  for (size_t lane = 0; lane < 8; ++lane) {
+    tail = max_double(tail, lanes[lane]);
+  }
+  return tail;
+}
+#endif
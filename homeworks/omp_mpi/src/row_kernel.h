@@ -0,0 +1,87 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef ROW_KERNEL_H
+#define ROW_KERNEL_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * @enum simd_t
+ * @brief Instruction sets a row kernel can be implemented with.
+ */
+typedef enum {
+  SIMD_AUTO,     ///< Best instruction set supported by the CPU
+  SIMD_SCALAR,   ///< One cell at a time, no vector instructions
+  SIMD_SSE2,     ///< Two cells at a time
+  SIMD_AVX2,     ///< Four cells at a time
+  SIMD_AVX512    ///< Eight cells at a time
+} simd_t;
+
+/**
+ * @brief Updates a segment of a row and measures how much it changed.
+ *
+ * Computes the new temperature of count cells, from the current temperatures
+ * of the cells and their neighbors, with the same operations and order as
+ * update_cell, so every implementation produces identical results.
+ *
+ * @param current First cell of the segment in the current state matrix.
+ * @param result Where the new temperature of the first cell is stored.
+ * @param count Amount of cells in the segment.
+ * @param stride Distance between two vertically adjacent cells (columns).
+ * @param mult_constant Multiplication constant for heat diffusion.
+ * @return Maximum absolute difference between new and current temperatures
+ * of the segment, 0 if the segment is empty.
+ */
+typedef double (*update_row_t)(const double* current, double* result
+    , uint64_t count, uint64_t stride, double mult_constant);
+
+/// @brief Updates a segment of a row of a float plate matrix
+/// @see update_row_t
+typedef float (*update_row_float_t)(const float* current, float* result
+    , uint64_t count, uint64_t stride, float mult_constant);
+
+/// @brief Updates a segment of a row without measuring how much it changed,
+/// for states whose convergence is not checked
+/// @see update_row_t
+typedef void (*update_row_unchecked_t)(const double* current, double* result
+    , uint64_t count, uint64_t stride, double mult_constant);
+
+/**
+ * @brief Returns the row kernel of an instruction set.
+ *
+ * @param simd Instruction set requested, SIMD_AUTO chooses the widest one
+ * supported by the CPU.
+ * @return Row kernel, or NULL if the CPU does not support the instruction set.
+ */
+update_row_t get_update_row(simd_t simd);
+
+/**
+ * @brief Returns the float row kernel of an instruction set.
+ *
+ * Float kernels are vectorized by the compiler for each instruction set, so
+ * a vector holds twice the cells of the double kernel of the same set.
+ *
+ * @see get_update_row
+ */
+update_row_float_t get_update_row_float(simd_t simd);
+
+/**
+ * @brief Returns the unchecked row kernel of an instruction set.
+ *
+ * Unchecked kernels are vectorized by the compiler for each instruction set,
+ * with the same operations and order as the double kernels.
+ *
+ * @see get_update_row
+ */
+update_row_unchecked_t get_update_row_unchecked(simd_t simd);
+
+/// @brief Checks with cpuid if the CPU supports an instruction set
+bool is_simd_supported(simd_t simd);
+
+/// @brief Returns the name of the instruction set, as used in the options.
+/// SIMD_AUTO is resolved to the instruction set it chooses.
+const char* get_simd_name(simd_t simd);
+
+#endif  // ROW_KERNEL_H
@@ -0,0 +1,224 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "schedule.h"
+
+#include <math.h>
+
+/**
+ * @struct ladder_cost_t
+ * @brief Estimated cost of a ladder, sorted to find the dispatch order.
+ */
+typedef struct {
+  uint64_t rows;         ///< Rows of the plate of the ladder
+  uint64_t cols;         ///< Columns of the plate of the ladder
+  double updates;        ///< Estimated cell updates of the ladder
+  size_t ladder_number;  ///< Number of the ladder in the job
+} ladder_cost_t;
+
+/// @brief Sorts ladder costs by shape, then by decreasing updates, then by
+/// ladder number. Used with qsort
+int compare_ladder_costs(const void* first, const void* second);
+
+/**
+ * @brief Estimates the states a plate takes to reach its epsilon from its
+ * initial temperatures.
+ * @param plate Plate with its epsilon and physical parameters
+ * @param rows Rows of the plate
+ * @param cols Columns of the plate
+ * @return Estimated states, at least 1
+ */
+uint64_t estimate_plate_states(plate_t* plate, uint64_t rows, uint64_t cols);
+
+int init_schedule(schedule_t* schedule, job_t* job) {
+  memset(schedule, 0, sizeof(schedule_t));
+  const size_t ladders_count = job->ladders_count;
+  schedule->predicted_states = (uint64_t*) calloc(job->plates_count + 1
+      , sizeof(uint64_t));
+  schedule->ladder_cells = (uint64_t*) calloc(ladders_count + 1
+      , sizeof(uint64_t));
+  schedule->ladder_updates = (double*) calloc(ladders_count + 1
+      , sizeof(double));
+  schedule->ladder_shapes = (size_t*) calloc(ladders_count + 1
+      , sizeof(size_t));
+  schedule->ladder_order = (size_t*) calloc(ladders_count + 1
+      , sizeof(size_t));
+  // Every ladder may have its own shape
+  schedule->shape_starts = (size_t*) calloc(ladders_count + 2
+      , sizeof(size_t));
+  schedule->shape_positions = (size_t*) calloc(ladders_count + 1
+      , sizeof(size_t));
+  schedule->shape_actual_states = (double*) calloc(ladders_count + 1
+      , sizeof(double));
+  schedule->shape_estimated_states = (double*) calloc(ladders_count + 1
+      , sizeof(double));
+  ladder_cost_t* costs = (ladder_cost_t*) calloc(ladders_count + 1
+      , sizeof(ladder_cost_t));
+  if (!schedule->predicted_states || !schedule->ladder_cells
+      || !schedule->ladder_updates || !schedule->ladder_shapes
+      || !schedule->ladder_order || !schedule->shape_starts
+      || !schedule->shape_positions || !schedule->shape_actual_states
+      || !schedule->shape_estimated_states || !costs) {
+    perror("Error: Memory for ladder schedule could not be allocated");
+    free(costs);
+    destroy_schedule(schedule);
+    return ERR_LADDER_ALLOC;
+  }
+
+  for (size_t ladder = 0; ladder < ladders_count; ++ladder) {
+    // Plates of a ladder share their plate file, validated with the job
+    const size_t first = job->ladder_starts[ladder];
+    const size_t last = job->ladder_starts[ladder + 1];
+    const uint64_t rows = job->job_file.rows[job->ladder_plates[first]];
+    const uint64_t cols = job->job_file.cols[job->ladder_plates[first]];
+
+    // Every rung continues the previous one, so the ladder costs the most
+    // states of any of its rungs
+    uint64_t ladder_states = 0;
+    for (size_t position = first; position < last; ++position) {
+      const size_t plate_number = job->ladder_plates[position];
+      plate_t plate;
+      memset(&plate, 0, sizeof(plate_t));
+      set_plate_parameters(job, plate_number, &plate);
+      schedule->predicted_states[plate_number] = estimate_plate_states(&plate
+          , rows, cols);
+      if (schedule->predicted_states[plate_number] > ladder_states) {
+        ladder_states = schedule->predicted_states[plate_number];
+      }
+    }
+    schedule->ladder_cells[ladder] = rows * cols;
+    schedule->ladder_updates[ladder] = (double) ladder_states * rows * cols;
+    costs[ladder].rows = rows;
+    costs[ladder].cols = cols;
+    costs[ladder].updates = schedule->ladder_updates[ladder];
+    costs[ladder].ladder_number = ladder;
+  }
+
+  qsort(costs, ladders_count, sizeof(ladder_cost_t), compare_ladder_costs);
+  for (size_t position = 0; position < ladders_count; ++position) {
+    // A new shape starts wherever rows or columns change
+    if (position == 0 || costs[position].rows != costs[position - 1].rows
+        || costs[position].cols != costs[position - 1].cols) {
+      schedule->shape_starts[schedule->shapes_count] = position;
+      schedule->shape_positions[schedule->shapes_count] = position;
+      ++schedule->shapes_count;
+    }
+    schedule->ladder_order[position] = costs[position].ladder_number;
+    schedule->ladder_shapes[costs[position].ladder_number]
+        = schedule->shapes_count - 1;
+  }
+  schedule->shape_starts[schedule->shapes_count] = ladders_count;
+  free(costs);
+  return EXIT_SUCCESS;
+}
+
+void destroy_schedule(schedule_t* schedule) {
+  free(schedule->predicted_states);
+  free(schedule->ladder_cells);
+  free(schedule->ladder_updates);
+  free(schedule->ladder_shapes);
+  free(schedule->ladder_order);
+  free(schedule->shape_starts);
+  free(schedule->shape_positions);
+  free(schedule->shape_actual_states);
+  free(schedule->shape_estimated_states);
+}
+
+int compare_ladder_costs(const void* first, const void* second) {
+  const ladder_cost_t* first_cost = (const ladder_cost_t*) first;
+  const ladder_cost_t* second_cost = (const ladder_cost_t*) second;
+  if (first_cost->rows != second_cost->rows) {
+    return first_cost->rows < second_cost->rows ? -1 : 1;
+  }
+  if (first_cost->cols != second_cost->cols) {
+    return first_cost->cols < second_cost->cols ? -1 : 1;
+  }
+  if (first_cost->updates != second_cost->updates) {
+    return first_cost->updates > second_cost->updates ? -1 : 1;
+  }
+  return first_cost->ladder_number < second_cost->ladder_number ? -1 : 1;
+}
+
+uint64_t estimate_plate_states(plate_t* plate, uint64_t rows, uint64_t cols) {
+  // Temperature changes start in the order of a degree
+  if (rows < 3 || cols < 3 || plate->epsilon >= 1) return 1;
+  const double pi = acos(-1.0);
+  const double row_term = sin(pi / (2.0 * (rows - 1)));
+  const double col_term = sin(pi / (2.0 * (cols - 1)));
+  const double decay = calculate_mult_constant(plate)
+      * 4 * (row_term * row_term + col_term * col_term);
+  if (decay <= 0 || decay >= 1) return 1;
+  // The slowest mode decreases by 1 - decay every state
+  const double states = log(1 / plate->epsilon) / -log1p(-decay);
+  return states >= 1 ? (uint64_t) ceil(states) : 1;
+}
+
+double predict_ladder_seconds(const schedule_t* schedule
+    , size_t ladder_number) {
+  // Until ladders are completed, estimates are taken as they are, and until
+  // one of its shape is, they are scaled by the error of the whole job
+  const size_t shape = schedule->ladder_shapes[ladder_number];
+  const double states_factor = schedule->shape_estimated_states[shape] > 0 ?
+      schedule->shape_actual_states[shape]
+      / schedule->shape_estimated_states[shape]
+      : schedule->estimated_states > 0 ?
+      schedule->actual_states / schedule->estimated_states : 1;
+  const double seconds_per_update = schedule->actual_updates > 0 ?
+      schedule->actual_seconds / schedule->actual_updates
+      : DEFAULT_SECONDS_PER_UPDATE;
+  return schedule->ladder_updates[ladder_number] * states_factor
+      * seconds_per_update;
+}
+
+size_t take_next_ladder(schedule_t* schedule) {
+  size_t next_shape = schedule->shapes_count;
+  double next_seconds = 0;
+  for (size_t shape = 0; shape < schedule->shapes_count; ++shape) {
+    const size_t position = schedule->shape_positions[shape];
+    if (position == schedule->shape_starts[shape + 1]) continue;
+    const double seconds = predict_ladder_seconds(schedule
+        , schedule->ladder_order[position]);
+    if (next_shape == schedule->shapes_count || seconds > next_seconds) {
+      next_shape = shape;
+      next_seconds = seconds;
+    }
+  }
+  assert(next_shape < schedule->shapes_count);
+  return schedule->ladder_order[schedule->shape_positions[next_shape]++];
+}
+
+void finish_scheduled_ladder(schedule_t* schedule, const job_t* job
+    , size_t ladder_number, int process_number, double seconds, bool report) {
+  const double predicted_seconds = predict_ladder_seconds(schedule
+      , ladder_number);
+
+  uint64_t states = 0, predicted_states = 0;
+  size_t last_plate = 0;
+  for (size_t position = job->ladder_starts[ladder_number];
+      position < job->ladder_starts[ladder_number + 1]; ++position) {
+    const size_t plate_number = job->ladder_plates[position];
+    if (job->job_file.k_states[plate_number] >= states) {
+      states = job->job_file.k_states[plate_number];
+      last_plate = plate_number;
+    }
+    if (schedule->predicted_states[plate_number] > predicted_states) {
+      predicted_states = schedule->predicted_states[plate_number];
+    }
+  }
+
+  if (report) {
+    printf("Plate %zu: predicted %.6lfs and %" PRIu64 " states, took %.6lfs"
+        " and %" PRIu64 " states in process %d\n", last_plate
+        , predicted_seconds, predicted_states, seconds, states
+        , process_number);
+  }
+
+  // Later predictions use the costs of every ladder completed so far
+  schedule->actual_states += states;
+  schedule->estimated_states += predicted_states;
+  const size_t shape = schedule->ladder_shapes[ladder_number];
+  schedule->shape_actual_states[shape] += states;
+  schedule->shape_estimated_states[shape] += predicted_states;
+  schedule->actual_seconds += seconds;
+  schedule->actual_updates += (double) states
+      * schedule->ladder_cells[ladder_number];
+}
@@ -0,0 +1,113 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "job.h"
+
+/** @brief Seconds per cell update assumed until a ladder is completed. */
+#define DEFAULT_SECONDS_PER_UPDATE 1e-9
+
+/**
+ * @struct schedule_t
+ * @brief Order in which the master hands out ladders, with the estimated
+ * cost of each one, and the costs learned from completed ladders.
+ *
+ * Ladders are handed out longest expected first, so the largest ones do not
+ * start last and leave the other workers idle at the end of the job. The
+ * error of the estimated states is learned for each shape (rows and columns)
+ * of plate, so ladders of a shape that turned out longer than estimated move
+ * ahead of the pending ladders of other shapes.
+ */
+typedef struct {
+  uint64_t* predicted_states;  ///< Estimated states of each plate
+  uint64_t* ladder_cells;      ///< Cells of the plate of each ladder
+  double* ladder_updates;      ///< Estimated cell updates of each ladder
+  size_t* ladder_shapes;       ///< Shape of the plate of each ladder
+  size_t* ladder_order;        ///< Ladders by shape, and then by decreasing
+                               ///< estimated updates
+  size_t shapes_count;         ///< Different shapes of the plates of the job
+  size_t* shape_starts;        ///< First position of each shape in
+                               ///< ladder_order, and the end of the last one
+  size_t* shape_positions;     ///< Position of the next ladder of each shape
+                               ///< to hand out
+  double* shape_actual_states;     ///< States of completed ladders of each
+                                   ///< shape
+  double* shape_estimated_states;  ///< Estimated states of completed ladders
+                                   ///< of each shape
+  double actual_states;        ///< States of completed ladders
+  double estimated_states;     ///< Estimated states of completed ladders
+  double actual_seconds;       ///< Seconds of completed ladders
+  double actual_updates;       ///< Cell updates of completed ladders
+} schedule_t;
+
+/**
+ * @brief Estimates the cost of every ladder of a job and sorts them by it.
+ *
+ * Rows and columns of each plate are the ones read from the header of its
+ * plate file when the job was validated. The states of a plate are
+ * estimated from how fast its slowest mode of heat decays: every state
+ * multiplies it by 1 - mult_constant * lambda, where lambda is the smallest
+ * eigenvalue of the discrete Laplacian of the plate, until epsilon is
+ * reached. The cost of a ladder is the states of its smallest epsilon times
+ * the cells of its plate. Ladders are grouped by the shape of their plate,
+ * each shape sorted by decreasing cost.
+ *
+ * @param schedule Schedule to initialize
+ * @param job Job with its ladders
+ * @return EXIT_SUCCESS on success, ERR_LADDER_ALLOC otherwise.
+ */
+int init_schedule(schedule_t* schedule, job_t* job);
+
+/// @brief Frees the arrays of a schedule
+void destroy_schedule(schedule_t* schedule);
+
+/**
+ * @brief Takes the pending ladder with the longest predicted time.
+ *
+ * Only the first pending ladder of each shape is compared, since the others
+ * of its shape are predicted shorter. Once a ladder of a shape is completed,
+ * the pending ones of that shape are predicted with its own error, so what
+ * was learned changes which shape goes next. The job must have ladders not
+ * handed out yet.
+ *
+ * @param schedule Schedule of the job
+ * @return Number of the ladder taken
+ */
+size_t take_next_ladder(schedule_t* schedule);
+
+/**
+ * @brief Records that a process completed a ladder, refining the learned
+ * states per estimated state of the job and of the shape of its plate, and
+ * seconds per cell update with it.
+ *
+ * @param schedule Schedule of the job
+ * @param job Job with the states of the ladder already updated
+ * @param ladder_number Ladder completed
+ * @param process_number Process that simulated the ladder
+ * @param seconds Seconds the process took to simulate the ladder
+ * @param report True to print predicted and actual time of the ladder
+ */
+void finish_scheduled_ladder(schedule_t* schedule, const job_t* job
+    , size_t ladder_number, int process_number, double seconds, bool report);
+
+/**
+ * @brief Predicts the seconds a ladder takes with the costs learned so far.
+ *
+ * Estimated states are scaled by the actual states per estimated state of
+ * the completed ladders of the same shape, or of the whole job while no
+ * ladder of the shape is completed.
+ *
+ * @param schedule Schedule of the job
+ * @param ladder_number Ladder to predict
+ * @return Predicted seconds
+ */
+double predict_ladder_seconds(const schedule_t* schedule
+    , size_t ladder_number);
+
+#endif  // SCHEDULE_H
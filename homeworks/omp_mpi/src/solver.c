@@ -0,0 +1,522 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "solver.h"
+#include "placement.h"
+#include <omp.h>
+
+/**
+ * @struct level_t
+ * @brief Grid of a multigrid level. The finest level is the plate itself.
+ *
+ * Coarser levels solve the correction of the finer one, with twice its cell
+ * size and a border of zeros, for the residual of the finer one as right
+ * hand side. Their cells are the even rows and columns of the finer one, so
+ * sides with an even amount of cells end closer to the border: the last
+ * interior row (and column) is a tail away from it, instead of a cell.
+ */
+typedef struct {
+  uint64_t rows;      ///< Rows of the grid, border included
+  uint64_t cols;      ///< Columns of the grid, border included
+  double* values;     ///< Temperatures of the plate, or their corrections
+  double* rhs;        ///< Right hand side, NULL for the plate (all zeros)
+  double* residuals;  ///< Residual of each cell, NULL in the coarsest level
+  double scale;       ///< Cell area, relative to the area of plate cells
+  double row_tail;    ///< Distance from the last interior row to the border
+  double col_tail;    ///< Distance from the last interior column to the border
+} level_t;
+
+/**
+ * @struct multigrid_t
+ * @brief Levels of the V-cycle of a plate.
+ */
+typedef struct {
+  level_t* levels;        ///< Levels from the plate to the coarsest one
+  uint64_t level_count;   ///< Amount of levels
+  uint64_t thread_count;  ///< Threads updating each level
+  uint64_t moved_bytes;   ///< Bytes of the grids read and written
+} multigrid_t;
+
+/// @brief Finds the equilibrium of a plate with red-black SOR
+/// @see equilibrate_plate_solver
+int equilibrate_plate_sor(plate_t* plate, const options_t* options);
+
+/// @brief Finds the equilibrium of a plate with multigrid V-cycles
+/// @see equilibrate_plate_solver
+int equilibrate_plate_multigrid(plate_t* plate, const options_t* options);
+
+/**
+ * @brief Allocates the levels of a plate, coarsening while both sides have
+ * MULTIGRID_MIN_SIDE cells. Coarse cells are the even rows and columns of
+ * the finer level, so a side of n cells has n / 2 + 1 in the coarser one.
+ * @param multigrid Multigrid to initialize
+ * @param plate_matrix Plate matrix, used as the finest level
+ * @param thread_count Threads updating each level
+ * @return EXIT_SUCCESS on success, ERR_KERNEL_ALLOC otherwise.
+ */
+int init_multigrid(multigrid_t* multigrid, plate_matrix_t* plate_matrix
+    , uint64_t thread_count);
+
+/// @brief Frees the grids of the coarse levels and the residuals
+void destroy_multigrid(multigrid_t* multigrid);
+
+/**
+ * @brief Runs a V-cycle from a level: smooths it, solves the correction of
+ * its residual in the coarser levels, adds it, and smooths it again. The
+ * coarsest level is solved with MULTIGRID_COARSE_SWEEPS of SOR.
+ * @param multigrid Levels of the plate
+ * @param level_number Level the cycle starts from
+ */
+void run_v_cycle(multigrid_t* multigrid, uint64_t level_number);
+
+/**
+ * @brief Sweeps the cells of a color of a level, whose row and column add to
+ * an even (0) or odd (1) number.
+ *
+ * Each cell moves omega times the way to the average of its neighbors (plus
+ * the right hand side), so omega 1 is Gauss-Seidel.
+ *
+ * @param level Level to sweep
+ * @param color Parity of the cells updated
+ * @param omega Relaxation factor
+ * @param thread_count Threads updating the level
+ * @return Maximum residual of the cells before their update, in units of
+ * the temperatures of the level
+ */
+double relax_color(const level_t* level, uint64_t color, double omega
+    , uint64_t thread_count);
+
+/// @brief Sweeps the red and then the black cells of a level
+/// @return Maximum residual found by both sweeps
+/// @see relax_color
+double relax_level(const level_t* level, double omega, uint64_t thread_count);
+
+/**
+ * @brief Measures the residual of every interior cell of a level.
+ * @param level Level to measure
+ * @param residuals Where the residual of each cell is stored, divided by the
+ * scale of the level, or NULL to only find the maximum
+ * @param thread_count Threads measuring the level
+ * @return Maximum residual, in units of the temperatures of the level
+ */
+double compute_residuals(const level_t* level, double* residuals
+    , uint64_t thread_count);
+
+/// @brief Sets the right hand side of a coarse level to the full weighting of
+/// the residuals of the finer one (the transpose of the interpolation over
+/// 4), and its initial correction to zeros
+void restrict_residuals(const level_t* fine, const level_t* coarse
+    , uint64_t thread_count);
+
+/// @brief Adds the bilinear interpolation of the corrections of a coarse
+/// level to the values of the finer one
+void prolongate_corrections(const level_t* coarse, const level_t* fine
+    , uint64_t thread_count);
+
+/**
+ * @brief Returns the weight of the neighbor of a cell on one side, in the
+ * difference of its temperature with the average of its neighbors.
+ *
+ * Cells are a cell away from their neighbors, so both weights are 1, except
+ * the last interior cell of a side, which is a tail away from the border.
+ *
+ * @param index Row or column of the cell
+ * @param count Rows or columns of the level
+ * @param tail Distance from the last interior cell to the border
+ * @param after True for the neighbor after the cell, false for the one
+ * before it
+ */
+static inline double get_neighbor_weight(uint64_t index, uint64_t count
+    , double tail, bool after) {
+  if (index + 2 != count) return 1;
+  return after ? 2 / (tail * (1 + tail)) : 2 / (1 + tail);
+}
+
+/**
+ * @brief Returns the weight of a coarse row (or column) in the bilinear
+ * interpolation of a fine one.
+ *
+ * Even fine rows are a coarse row. Odd ones are between two, with half of
+ * each, except the last interior row of a side with an odd amount of rows,
+ * which is a tail away from the border instead of a cell.
+ *
+ * @param fine_index Row or column of the fine level
+ * @param coarse_index Row or column of the coarse level
+ * @param fine_count Rows or columns of the fine level
+ * @param fine_tail Distance from the last interior fine cell to the border
+ */
+static inline double get_interpolation_weight(uint64_t fine_index
+    , uint64_t coarse_index, uint64_t fine_count, double fine_tail) {
+  if (fine_index % 2 == 0) return fine_index == 2 * coarse_index ? 1 : 0;
+  if (coarse_index != fine_index / 2 && coarse_index != fine_index / 2 + 1) {
+    return 0;
+  }
+  if (fine_index + 2 != fine_count) return 0.5;
+  return (coarse_index == fine_index / 2 ? fine_tail : 1) / (1 + fine_tail);
+}
+
+/// @brief Returns the level of the plate itself
+static inline level_t get_plate_level(const plate_matrix_t* plate_matrix) {
+  return (level_t) {plate_matrix->rows, plate_matrix->cols
+      , plate_matrix->matrix, NULL, NULL, 1, 1, 1};
+}
+
+/// @brief Returns the bytes of a given amount of arrays of a level
+static inline uint64_t get_level_bytes(const level_t* level, double arrays) {
+  return (uint64_t) (arrays * sizeof(double) * level->rows * level->cols);
+}
+
+int equilibrate_plate_solver(plate_t* plate, const options_t* options) {
+  // Threads of the team keep their CPU in the parallel regions of every level
+  if (options->affinity_count > 0) {
+    #pragma omp parallel num_threads(options->thread_count) default(none) \
+        shared(options)
+    pin_thread(options, omp_get_thread_num());
+  }
+  return options->solver == SOLVER_MULTIGRID ?
+      equilibrate_plate_multigrid(plate, options)
+      : equilibrate_plate_sor(plate, options);
+}
+
+int equilibrate_plate_sor(plate_t* plate, const options_t* options) {
+  plate_matrix_t* plate_matrix = plate->plate_matrix;
+  const level_t level = get_plate_level(plate_matrix);
+  const double omega = options->omega > 0 ? options->omega
+      : get_sor_omega(plate_matrix->rows, plate_matrix->cols);
+  const double mult_constant = calculate_mult_constant(plate);
+
+  double residual = 0;
+  while (true) {
+    ++plate->k_states;
+    // Residuals found while sweeping are measured before the update of each
+    // cell, the exact one is only measured once they are within epsilon
+    residual = mult_constant * relax_level(&level, omega
+        , options->thread_count);
+    // Each color reads the whole plate and writes half of it
+    plate->moved_bytes += get_level_bytes(&level, 3);
+    trace_state(plate->trace, plate->k_states, residual);
+
+    if (residual <= plate->epsilon) {
+      residual = mult_constant * compute_residuals(&level, NULL
+          , options->thread_count);
+      plate->moved_bytes += get_level_bytes(&level, 1);
+      if (residual <= plate->epsilon) break;
+    }
+    // Stopped plates keep a residual greater than epsilon, so they stop at
+    // the same iteration whether they are stopped or not
+    if (plate->k_states == plate->stop_state) break;
+  }
+  plate->max_delta = residual;
+  return EXIT_SUCCESS;
+}
+
+int equilibrate_plate_multigrid(plate_t* plate, const options_t* options) {
+  multigrid_t multigrid;
+  if (init_multigrid(&multigrid, plate->plate_matrix, options->thread_count)
+      != EXIT_SUCCESS) {
+    fprintf(stderr, "Error: Could not allocate multigrid levels\n");
+    return ERR_KERNEL_ALLOC;
+  }
+  const double mult_constant = calculate_mult_constant(plate);
+
+  double residual = 0;
+  while (true) {
+    ++plate->k_states;
+    run_v_cycle(&multigrid, 0);
+    residual = mult_constant * compute_residuals(multigrid.levels, NULL
+        , options->thread_count);
+    multigrid.moved_bytes += get_level_bytes(multigrid.levels, 1);
+    trace_state(plate->trace, plate->k_states, residual);
+    if (residual <= plate->epsilon || plate->k_states == plate->stop_state) {
+      break;
+    }
+  }
+  plate->max_delta = residual;
+  plate->moved_bytes += multigrid.moved_bytes;
+  destroy_multigrid(&multigrid);
+  return EXIT_SUCCESS;
+}
+
+double get_sor_omega(uint64_t rows, uint64_t cols) {
+  // Plates without interior cells converge with any factor
+  if (rows < 3 || cols < 3) return 1;
+  const double rho = (cos(M_PI / (rows - 1)) + cos(M_PI / (cols - 1))) / 2;
+  return 2 / (1 + sqrt(1 - rho * rho));
+}
+
+uint64_t count_multigrid_levels(uint64_t rows, uint64_t cols) {
+  uint64_t level_count = 1;
+  while (rows >= MULTIGRID_MIN_SIDE && cols >= MULTIGRID_MIN_SIDE) {
+    rows = rows / 2 + 1;
+    cols = cols / 2 + 1;
+    ++level_count;
+  }
+  return level_count;
+}
+
+double get_plate_residual(const plate_t* plate, const options_t* options) {
+  const level_t level = get_plate_level(plate->plate_matrix);
+  return calculate_mult_constant((plate_t*) plate)
+      * compute_residuals(&level, NULL, options->thread_count);
+}
+
+double get_largest_difference(const plate_matrix_t* plate_matrix
+    , const plate_matrix_t* other_matrix) {
+  double largest_difference = 0;
+  const uint64_t cells = plate_matrix->rows * plate_matrix->cols;
+  for (uint64_t cell = 0; cell < cells; ++cell) {
+    const double difference = fabs(plate_matrix->matrix[cell]
+        - other_matrix->matrix[cell]);
+    if (difference > largest_difference) largest_difference = difference;
+  }
+  return largest_difference;
+}
+
+int init_multigrid(multigrid_t* multigrid, plate_matrix_t* plate_matrix
+    , uint64_t thread_count) {
+  multigrid->level_count = count_multigrid_levels(plate_matrix->rows
+      , plate_matrix->cols);
+  multigrid->thread_count = thread_count;
+  multigrid->moved_bytes = 0;
+  multigrid->levels = (level_t*) calloc(multigrid->level_count
+      , sizeof(level_t));
+  if (!multigrid->levels) return ERR_KERNEL_ALLOC;
+
+  level_t* levels = multigrid->levels;
+  levels[0] = get_plate_level(plate_matrix);
+  bool allocated = true;
+  for (uint64_t number = 0; number < multigrid->level_count; ++number) {
+    level_t* level = levels + number;
+    if (number > 0) {
+      const level_t* fine = level - 1;
+      level->rows = fine->rows / 2 + 1;
+      level->cols = fine->cols / 2 + 1;
+      level->scale = 4 * fine->scale;
+      // Odd sides keep their border, whose distance to the last interior
+      // coarse cell is a fine cell and the fine tail. Even sides lose it,
+      // and the border is the fine tail away from the last even cell
+      level->row_tail = (fine->rows % 2 ? 1 + fine->row_tail
+          : fine->row_tail) / 2;
+      level->col_tail = (fine->cols % 2 ? 1 + fine->col_tail
+          : fine->col_tail) / 2;
+      // Borders of corrections and residuals are never written, so zeros
+      level->values = (double*) calloc(level->rows * level->cols
+          , sizeof(double));
+      level->rhs = (double*) calloc(level->rows * level->cols
+          , sizeof(double));
+      allocated = allocated && level->values && level->rhs;
+    }
+    if (number + 1 < multigrid->level_count) {
+      level->residuals = (double*) calloc(level->rows * level->cols
+          , sizeof(double));
+      allocated = allocated && level->residuals;
+    }
+  }
+  if (!allocated) {
+    destroy_multigrid(multigrid);
+    return ERR_KERNEL_ALLOC;
+  }
+  return EXIT_SUCCESS;
+}
+
+void destroy_multigrid(multigrid_t* multigrid) {
+  for (uint64_t number = 0; number < multigrid->level_count; ++number) {
+    // Values of the finest level are the plate matrix
+    if (number > 0) {
+      free(multigrid->levels[number].values);
+      free(multigrid->levels[number].rhs);
+    }
+    free(multigrid->levels[number].residuals);
+  }
+  free(multigrid->levels);
+  multigrid->levels = NULL;
+}
+
+void run_v_cycle(multigrid_t* multigrid, uint64_t level_number) {
+  const level_t* level = multigrid->levels + level_number;
+  const uint64_t thread_count = multigrid->thread_count;
+  // Sweeps read the values (and right hand side) and write half of them
+  const double sweep_arrays = level->rhs ? 4 : 3;
+
+  if (level_number + 1 == multigrid->level_count) {
+    // A side of the coarsest level has less than MULTIGRID_MIN_SIDE cells,
+    // so SOR converges in a few sweeps
+    const double omega = get_sor_omega(level->rows, level->cols);
+    for (uint64_t sweep = 0; sweep < MULTIGRID_COARSE_SWEEPS; ++sweep) {
+      relax_level(level, omega, thread_count);
+    }
+    multigrid->moved_bytes += MULTIGRID_COARSE_SWEEPS
+        * get_level_bytes(level, sweep_arrays);
+    return;
+  }
+
+  const level_t* coarse = level + 1;
+  for (uint64_t sweep = 0; sweep < MULTIGRID_SMOOTH_SWEEPS; ++sweep) {
+    relax_level(level, 1, thread_count);
+  }
+  compute_residuals(level, level->residuals, thread_count);
+  restrict_residuals(level, coarse, thread_count);
+  run_v_cycle(multigrid, level_number + 1);
+  prolongate_corrections(coarse, level, thread_count);
+  for (uint64_t sweep = 0; sweep < MULTIGRID_SMOOTH_SWEEPS; ++sweep) {
+    relax_level(level, 1, thread_count);
+  }
+
+  // Residuals read the values and right hand side and write the residuals,
+  // the restriction reads them and writes two coarse arrays, and the
+  // prolongation reads the coarse corrections and adds them to the values
+  multigrid->moved_bytes += 2 * MULTIGRID_SMOOTH_SWEEPS
+      * get_level_bytes(level, sweep_arrays)
+      + get_level_bytes(level, sweep_arrays - 1 + 1 + 2)
+      + get_level_bytes(coarse, 2 + 1);
+}
+
+double relax_color(const level_t* level, uint64_t color, double omega
+    , uint64_t thread_count) {
+  const uint64_t rows = level->rows;
+  const uint64_t cols = level->cols;
+  double* values = level->values;
+  const double* rhs = level->rhs;
+  const double scale = level->scale;
+  // Levels with less than three rows have no interior cells
+  const uint64_t last_row = rows > 2 ? rows - 1 : 1;
+  double max_residual = 0;
+
+  #pragma omp parallel for num_threads(thread_count) default(none) \
+      if (rows * cols >= SOLVER_PARALLEL_CELLS) schedule(static) \
+      shared(level, rows, cols, values, rhs, scale, color, omega, last_row) \
+      reduction(max:max_residual)
+  for (uint64_t row = 1; row < last_row; ++row) {
+    const double north = get_neighbor_weight(row, rows, level->row_tail
+        , false);
+    const double south = get_neighbor_weight(row, rows, level->row_tail
+        , true);
+    // First column of the row whose parity with the row is the color
+    for (uint64_t col = 1 + (row + color + 1) % 2; col + 1 < cols;
+        col += 2) {
+      const uint64_t cell = row * cols + col;
+      const double west = get_neighbor_weight(col, cols, level->col_tail
+          , false);
+      const double east = get_neighbor_weight(col, cols, level->col_tail
+          , true);
+      const double weight = north + south + west + east;
+      double residual = north * values[cell - cols]
+          + south * values[cell + cols] + west * values[cell - 1]
+          + east * values[cell + 1] - weight * values[cell];
+      if (rhs) residual += scale * rhs[cell];
+      values[cell] += omega * residual / weight;
+      if (fabs(residual) > max_residual) max_residual = fabs(residual);
+    }
+  }
+  return max_residual;
+}
+
+double relax_level(const level_t* level, double omega
+    , uint64_t thread_count) {
+  const double red_residual = relax_color(level, 0, omega, thread_count);
+  const double black_residual = relax_color(level, 1, omega, thread_count);
+  return red_residual > black_residual ? red_residual : black_residual;
+}
+
+double compute_residuals(const level_t* level, double* residuals
+    , uint64_t thread_count) {
+  const uint64_t rows = level->rows;
+  const uint64_t cols = level->cols;
+  const double* values = level->values;
+  const double* rhs = level->rhs;
+  const double scale = level->scale;
+  // Levels with less than three rows have no interior cells
+  const uint64_t last_row = rows > 2 ? rows - 1 : 1;
+  double max_residual = 0;
+
+  #pragma omp parallel for num_threads(thread_count) default(none) \
+      if (rows * cols >= SOLVER_PARALLEL_CELLS) schedule(static) \
+      shared(level, rows, cols, values, rhs, scale, residuals, last_row) \
+      reduction(max:max_residual)
+  for (uint64_t row = 1; row < last_row; ++row) {
+    const double north = get_neighbor_weight(row, rows, level->row_tail
+        , false);
+    const double south = get_neighbor_weight(row, rows, level->row_tail
+        , true);
+    for (uint64_t col = 1; col + 1 < cols; ++col) {
+      const uint64_t cell = row * cols + col;
+      const double west = get_neighbor_weight(col, cols, level->col_tail
+          , false);
+      const double east = get_neighbor_weight(col, cols, level->col_tail
+          , true);
+      double residual = north * values[cell - cols]
+          + south * values[cell + cols] + west * values[cell - 1]
+          + east * values[cell + 1]
+          - (north + south + west + east) * values[cell];
+      if (rhs) residual += scale * rhs[cell];
+      if (residuals) residuals[cell] = residual / scale;
+      if (fabs(residual) > max_residual) max_residual = fabs(residual);
+    }
+  }
+  return max_residual;
+}
+
+void restrict_residuals(const level_t* fine, const level_t* coarse
+    , uint64_t thread_count) {
+  const uint64_t fine_cols = fine->cols;
+  const double* residuals = fine->residuals;
+  // Coarse levels always have interior cells
+  const uint64_t last_row = coarse->rows - 1;
+
+  #pragma omp parallel for num_threads(thread_count) default(none) \
+      if (fine->rows * fine_cols >= SOLVER_PARALLEL_CELLS) schedule(static) \
+      shared(fine, coarse, fine_cols, residuals, last_row)
+  for (uint64_t row = 1; row < last_row; ++row) {
+    for (uint64_t col = 1; col + 1 < coarse->cols; ++col) {
+      // Residuals of the border of the fine level are zeros, and the fine
+      // cells around a coarse one are always inside the fine level
+      double rhs = 0;
+      for (uint64_t fine_row = 2 * row - 1; fine_row <= 2 * row + 1;
+          ++fine_row) {
+        const double row_weight = get_interpolation_weight(fine_row, row
+            , fine->rows, fine->row_tail);
+        for (uint64_t fine_col = 2 * col - 1; fine_col <= 2 * col + 1;
+            ++fine_col) {
+          rhs += row_weight * get_interpolation_weight(fine_col, col
+              , fine_cols, fine->col_tail)
+              * residuals[fine_row * fine_cols + fine_col];
+        }
+      }
+      coarse->rhs[row * coarse->cols + col] = rhs / 4;
+      coarse->values[row * coarse->cols + col] = 0;
+    }
+  }
+}
+
+void prolongate_corrections(const level_t* coarse, const level_t* fine
+    , uint64_t thread_count) {
+  const uint64_t coarse_cols = coarse->cols;
+  const double* corrections = coarse->values;
+  const uint64_t last_row = fine->rows - 1;
+
+  #pragma omp parallel for num_threads(thread_count) default(none) \
+      if (fine->rows * fine->cols >= SOLVER_PARALLEL_CELLS) schedule(static) \
+      shared(fine, coarse_cols, corrections, last_row)
+  for (uint64_t row = 1; row < last_row; ++row) {
+    // Even rows and columns are coarse cells, odd ones are between two
+    const uint64_t top = row / 2;
+    const uint64_t bottom = top + row % 2;
+    const double top_weight = get_interpolation_weight(row, top, fine->rows
+        , fine->row_tail);
+    const double bottom_weight = row % 2 ? get_interpolation_weight(row
+        , bottom, fine->rows, fine->row_tail) : 0;
+    for (uint64_t col = 1; col + 1 < fine->cols; ++col) {
+      const uint64_t left = col / 2;
+      const uint64_t right = left + col % 2;
+      const double left_weight = get_interpolation_weight(col, left
+          , fine->cols, fine->col_tail);
+      const double right_weight = col % 2 ? get_interpolation_weight(col
+          , right, fine->cols, fine->col_tail) : 0;
+      fine->values[row * fine->cols + col] += top_weight
+          * (left_weight * corrections[top * coarse_cols + left]
+          + right_weight * corrections[top * coarse_cols + right])
+          + bottom_weight
+          * (left_weight * corrections[bottom * coarse_cols + left]
+          + right_weight * corrections[bottom * coarse_cols + right]);
+    }
+  }
+}
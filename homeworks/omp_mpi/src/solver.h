@@ -0,0 +1,75 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "options.h"
+#include "plate.h"
+
+/** @brief Red-black sweeps of the multigrid smoother before and after the
+ * correction from the coarser level. */
+#define MULTIGRID_SMOOTH_SWEEPS 2
+
+/** @brief Levels are coarsened while both sides have at least these cells,
+ * border included. */
+#define MULTIGRID_MIN_SIDE 5
+
+/** @brief Red-black SOR sweeps that solve the coarsest level. */
+#define MULTIGRID_COARSE_SWEEPS 32
+
+/** @brief Grids with fewer cells are updated by a single thread, since
+ * waking the team would take longer than the sweep. */
+#define SOLVER_PARALLEL_CELLS 16384
+
+/**
+ * @brief Finds the equilibrium temperatures of a plate with the steady-state
+ * solver of the options, instead of simulating states in time.
+ *
+ * Equilibrium is the field where no cell changes: every cell is the average
+ * of its four neighbors. Solvers iterate until the residual of the plate
+ * (see get_plate_residual) is within epsilon, which is the criterion the
+ * Jacobi states are stopped by, so one more state would change no cell more
+ * than epsilon. Iterations are counted in k_states, and the residual is
+ * stored in max_delta. Solvers also stop once they reach the stop state.
+ *
+ * `sor` sweeps the plate in place, first the cells whose row and column add
+ * to an even number (red), then the rest (black), so the cells of a color
+ * only depend on the other one and are updated by every thread at once.
+ * `multigrid` runs V-cycles, each of them a sweep of the plate and every
+ * coarser level of it.
+ *
+ * @param plate Plate to equilibrate, continued from its current temperatures
+ * @param options Options with the solver, relaxation factor and amount of
+ * threads
+ * @return EXIT_SUCCESS on success, ERR_KERNEL_ALLOC otherwise.
+ */
+int equilibrate_plate_solver(plate_t* plate, const options_t* options);
+
+/**
+ * @brief Returns the relaxation factor that makes SOR converge the fastest
+ * on a plate of the given size, from the spectral radius of the Jacobi
+ * iteration on it: 2 / (1 + sqrt(1 - rho^2)), with
+ * rho = (cos(pi / (rows - 1)) + cos(pi / (cols - 1))) / 2.
+ * @param rows Rows of the plate, border included
+ * @param cols Columns of the plate, border included
+ */
+double get_sor_omega(uint64_t rows, uint64_t cols);
+
+/// @brief Returns the amount of grids of the multigrid V-cycle of a plate,
+/// the plate itself included
+uint64_t count_multigrid_levels(uint64_t rows, uint64_t cols);
+
+/**
+ * @brief Returns the residual of a plate: the maximum change a state of
+ * Jacobi would make to any cell from its current temperatures.
+ * @param plate Plate to measure
+ * @param options Options with the amount of threads
+ */
+double get_plate_residual(const plate_t* plate, const options_t* options);
+
+/// @brief Returns the largest difference between the temperatures of two
+/// plate matrices of the same size
+double get_largest_difference(const plate_matrix_t* plate_matrix
+    , const plate_matrix_t* other_matrix);
+
+#endif  // SOLVER_H
@@ -0,0 +1,146 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "trace.h"
+#include "common.h"
+
+#include <math.h>
+#include <string.h>
+
+/// @brief Stores a sample in the ring, overwriting the oldest if full
+void store_sample(trace_t* trace, uint64_t state, double max_delta
+    , double seconds);
+
+/// @brief Prints the states and seconds the ladder of the plate has left,
+/// and gives the seconds to the progress function
+void report_progress(trace_t* trace, double seconds);
+
+int init_trace(trace_t* trace, uint64_t every) {
+  memset(trace, 0, sizeof(trace_t));
+  trace->every = every;
+  trace->states = (uint64_t*) malloc(TRACE_CAPACITY * sizeof(uint64_t));
+  trace->max_deltas = (double*) malloc(TRACE_CAPACITY * sizeof(double));
+  trace->seconds = (double*) malloc(TRACE_CAPACITY * sizeof(double));
+  if (!trace->states || !trace->max_deltas || !trace->seconds) {
+    destroy_trace(trace);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+void destroy_trace(trace_t* trace) {
+  free(trace->states);
+  free(trace->max_deltas);
+  free(trace->seconds);
+  trace->states = NULL;
+  trace->max_deltas = NULL;
+  trace->seconds = NULL;
+}
+
+void start_trace(trace_t* trace, size_t plate_number, uint64_t first_state) {
+  trace->count = 0;
+  trace->plate_number = plate_number;
+  trace->first_state = first_state;
+  // Samples fall on multiples of every, wherever the plate started
+  trace->next_state = (first_state / trace->every + 1) * trace->every;
+  trace->next_progress = TRACE_PROGRESS_SECONDS;
+  clock_gettime(CLOCK_MONOTONIC, &trace->start_time);
+}
+
+void record_trace(trace_t* trace, uint64_t state, double max_delta) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  const double seconds = get_elapsed_seconds(&trace->start_time, &now);
+  store_sample(trace, state, max_delta, seconds);
+  trace->next_state = (state / trace->every + 1) * trace->every;
+  if (seconds >= trace->next_progress) {
+    report_progress(trace, seconds);
+    trace->next_progress = seconds + TRACE_PROGRESS_SECONDS;
+  }
+}
+
+void finish_trace(trace_t* trace, uint64_t state, double max_delta) {
+  if (trace->count > 0
+      && trace->states[(trace->count - 1) % TRACE_CAPACITY] == state) {
+    return;
+  }
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  store_sample(trace, state, max_delta
+      , get_elapsed_seconds(&trace->start_time, &now));
+}
+
+void store_sample(trace_t* trace, uint64_t state, double max_delta
+    , double seconds) {
+  const uint64_t slot = trace->count++ % TRACE_CAPACITY;
+  trace->states[slot] = state;
+  trace->max_deltas[slot] = max_delta;
+  trace->seconds[slot] = seconds;
+}
+
+void report_progress(trace_t* trace, double seconds) {
+  const uint64_t last = (trace->count - 1) % TRACE_CAPACITY;
+  const uint64_t state = trace->states[last];
+  double remaining_states = 0;
+  if (state <= trace->first_state || !predict_remaining_states(trace
+      , trace->target_epsilon, &remaining_states)) {
+    return;
+  }
+  // States of the same plate take about the same time
+  const double remaining_seconds = remaining_states * seconds
+      / (state - trace->first_state);
+  printf("Plate %zu: state %" PRIu64 ", max delta %.3e, about %.0lf states"
+      " and %.1lfs left\n", trace->plate_number, state
+      , trace->max_deltas[last], remaining_states, remaining_seconds);
+  if (trace->progress) {
+    trace->progress(trace->progress_data, trace->ladder_number
+        , remaining_seconds);
+  }
+}
+
+bool predict_remaining_states(const trace_t* trace, double epsilon
+    , double* remaining_states) {
+  const uint64_t samples = trace->count < TRACE_FIT_SAMPLES ? trace->count
+      : TRACE_FIT_SAMPLES;
+  if (samples < 2) return false;
+
+  // Least squares line of the logarithm of the maximum change by state,
+  // states taken from the last sample so they stay small
+  const uint64_t last = (trace->count - 1) % TRACE_CAPACITY;
+  const double last_state = (double) trace->states[last];
+  double sum_x = 0, sum_y = 0, sum_xx = 0, sum_xy = 0;
+  for (uint64_t sample = trace->count - samples; sample < trace->count;
+      ++sample) {
+    const uint64_t slot = sample % TRACE_CAPACITY;
+    if (trace->max_deltas[slot] <= 0) return false;
+    const double x = (double) trace->states[slot] - last_state;
+    const double y = log(trace->max_deltas[slot]);
+    sum_x += x;
+    sum_y += y;
+    sum_xx += x * x;
+    sum_xy += x * y;
+  }
+  const double denominator = samples * sum_xx - sum_x * sum_x;
+  if (denominator <= 0) return false;
+  const double slope = (samples * sum_xy - sum_x * sum_y) / denominator;
+  if (slope >= 0) return false;
+  // Extrapolated from the fitted line at the last sample
+  const double intercept = (sum_y - slope * sum_x) / samples;
+  const double states = (log(epsilon) - intercept) / slope;
+  *remaining_states = states > 0 ? states : 0;
+  return true;
+}
+
+int write_trace(FILE* trace_file, const trace_t* trace) {
+  const uint64_t samples = trace->count < TRACE_CAPACITY ? trace->count
+      : TRACE_CAPACITY;
+  for (uint64_t sample = trace->count - samples; sample < trace->count;
+      ++sample) {
+    const uint64_t slot = sample % TRACE_CAPACITY;
+    if (fprintf(trace_file, "%zu\t%" PRIu64 "\t%.9g\t%.9f\n"
+        , trace->plate_number, trace->states[slot], trace->max_deltas[slot]
+        , trace->seconds[slot]) < 0) {
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
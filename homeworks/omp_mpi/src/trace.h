@@ -0,0 +1,120 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/** @brief Samples kept by the trace of a plate, the oldest are overwritten */
+#define TRACE_CAPACITY 4096
+/** @brief Latest samples the decay of the maximum change is fitted to */
+#define TRACE_FIT_SAMPLES 8
+/** @brief Seconds between estimates of the states and time a plate has left */
+#define TRACE_PROGRESS_SECONDS 1.0
+
+/**
+ * @brief Receives the seconds the ladder of a traced plate is expected to
+ * take yet, every TRACE_PROGRESS_SECONDS.
+ */
+typedef void (*trace_progress_t)(void* data, size_t ladder_number
+    , double seconds);
+
+/**
+ * @struct trace_t
+ * @brief Maximum temperature change of a plate every few states.
+ *
+ * Samples are stored in a ring, so a plate keeps the last TRACE_CAPACITY of
+ * them however long it takes. Kernels that check every state record every
+ * `every` states, kernels that check every few states (amortized checks,
+ * wavefront blocks) record at the first check after that. A trace is
+ * reused by the plates a process simulates, each one starting it again.
+ */
+typedef struct {
+  uint64_t every;               ///< States between samples
+  uint64_t count;               ///< Samples recorded since the plate started
+  uint64_t next_state;          ///< State of the next sample
+  uint64_t* states;             ///< State of each sample
+  double* max_deltas;           ///< Maximum change at each sample
+  double* seconds;              ///< Seconds since the plate started
+  size_t plate_number;          ///< Plate being recorded
+  size_t ladder_number;         ///< Ladder of the plate, set by its simulator
+  uint64_t first_state;         ///< State the plate started from
+  double target_epsilon;        ///< Epsilon the estimates are made for, the
+                                ///< smallest of the ladder, set with it
+  struct timespec start_time;   ///< When the plate started
+  double next_progress;         ///< Seconds of the next estimate
+  trace_progress_t progress;    ///< Called with each estimate, may be NULL
+  void* progress_data;          ///< Data given to progress
+} trace_t;
+
+/**
+ * @brief Allocates the ring of a trace.
+ * @param trace Trace to initialize
+ * @param every States between samples
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE otherwise.
+ */
+int init_trace(trace_t* trace, uint64_t every);
+
+/// @brief Frees the ring of a trace
+void destroy_trace(trace_t* trace);
+
+/**
+ * @brief Empties a trace to record a plate, keeping its ladder and target
+ * epsilon, so estimates include the rungs after the plate.
+ *
+ * @param trace Trace to start
+ * @param plate_number Plate to record
+ * @param first_state State the plate starts from
+ */
+void start_trace(trace_t* trace, size_t plate_number, uint64_t first_state);
+
+/**
+ * @brief Stores a sample, and every TRACE_PROGRESS_SECONDS prints the
+ * estimated states and seconds left, and gives the seconds to progress.
+ * @param trace Trace of the plate
+ * @param state State the maximum change was measured at
+ * @param max_delta Maximum change of the state
+ */
+void record_trace(trace_t* trace, uint64_t state, double max_delta);
+
+/// @brief Records a sample if one is due at the state. Called by kernels
+/// after every state they check, with a NULL trace when disabled
+static inline void trace_state(trace_t* trace, uint64_t state
+    , double max_delta) {
+  if (trace && state >= trace->next_state) {
+    record_trace(trace, state, max_delta);
+  }
+}
+
+/// @brief Records the last state of a plate, even if no sample is due
+void finish_trace(trace_t* trace, uint64_t state, double max_delta);
+
+/**
+ * @brief Estimates the states until the maximum change reaches an epsilon.
+ *
+ * The maximum change of a plate ends up decaying geometrically, at the rate
+ * of its slowest mode, so the logarithm of the last TRACE_FIT_SAMPLES
+ * samples is fitted to a line by least squares, and extrapolated.
+ *
+ * @param trace Trace of the plate
+ * @param epsilon Epsilon to reach
+ * @param remaining_states Estimated states after the last sample
+ * @return True if estimated, false without at least two samples or a decay
+ */
+bool predict_remaining_states(const trace_t* trace, double epsilon
+    , double* remaining_states);
+
+/**
+ * @brief Writes the samples of a plate, oldest first, as lines of plate
+ * number, state, maximum change and seconds, separated by tabs.
+ * @param trace_file File to write to
+ * @param trace Trace of the plate
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE otherwise.
+ */
+int write_trace(FILE* trace_file, const trace_t* trace);
+
+#endif  // TRACE_H
@@ -0,0 +1,311 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "wavefront.h"
+#include "placement.h"
+#include <omp.h>
+
+/**
+ * @struct tile_t
+ * @brief Region of the plate's interior owned by a tile.
+ */
+typedef struct {
+  uint64_t first_row;  ///< First row owned by the tile
+  uint64_t last_row;   ///< Row after the last one owned by the tile
+  uint64_t first_col;  ///< First column owned by the tile
+  uint64_t last_col;   ///< Column after the last one owned by the tile
+} tile_t;
+
+/**
+ * @struct wavefront_t
+ * @brief Data shared by the threads advancing tiles of a plate.
+ */
+typedef struct {
+  plate_matrix_t* plate_matrix;  ///< Plate matrix being equilibrated
+  const options_t* options;      ///< Options with the affinity list
+  double mult_constant;          ///< Constant in new temp formula
+  double epsilon;                ///< Epsilon associated to the plate
+  update_row_t update_row;       ///< Row kernel updating tile rows
+  uint64_t thread_count;         ///< Threads advancing tiles
+  uint64_t tile_rows;            ///< Rows owned by each tile
+  uint64_t tile_cols;            ///< Columns owned by each tile
+  uint64_t tiles_per_row;        ///< Tiles along the columns of the plate
+  uint64_t tile_count;           ///< Total amount of tiles
+  uint64_t block_states;         ///< Maximum states advanced per block
+  size_t scratch_size;           ///< Cells of each scratch buffer
+  double** scratches;            ///< Two scratch buffers per thread
+  double* max_deltas;            ///< Max change per thread per block state
+  double max_delta;              ///< Max change in the last state advanced
+  uint64_t moved_bytes;          ///< Matrix bytes read and written
+} wavefront_t;
+
+/// @brief Allocates scratch buffers and sets tile dimensions for the plate
+/// @return EXIT_SUCCESS on success, ERR_KERNEL_ALLOC otherwise
+int init_wavefront(wavefront_t* wavefront, plate_t* plate
+    , const options_t* options);
+
+/// @brief Frees scratch buffers and flags of the wavefront
+void destroy_wavefront(wavefront_t* wavefront);
+
+/**
+ * @brief Advances every tile of the plate the given amount of states, from
+ * the auxiliary matrix (current state) into the main matrix.
+ *
+ * @param wavefront Wavefront with the plate and scratch buffers
+ * @param states States to advance, at most block_states
+ * @return Number (1-based) of the first state of the block where the whole
+ * plate was equilibrated, 0 if it was not equilibrated in the block. The
+ * maximum temperature change of that state (or the last one) is stored in
+ * the wavefront.
+ */
+uint64_t advance_tiles(wavefront_t* wavefront, uint64_t states);
+
+/**
+ * @brief Advances one tile inside a scratch area.
+ *
+ * @param wavefront Wavefront with the plate being equilibrated
+ * @param tile Tile to advance
+ * @param states States to advance
+ * @param scratch Scratch buffers of the calling thread
+ * @param max_deltas Maximum changes of the calling thread, one per state,
+ * raised to the greatest change of the owned cells in each state
+ * @return Bytes read from and written to the plate matrices
+ */
+uint64_t advance_tile(wavefront_t* wavefront, const tile_t* tile
+    , uint64_t states, double* scratch, double* max_deltas);
+
+/// @brief Sets the region owned by the tile with the given index
+void get_tile(const wavefront_t* wavefront, uint64_t index, tile_t* tile);
+
+/// @brief Returns the smallest of two values
+static inline uint64_t min_u64(uint64_t first, uint64_t second) {
+  return first < second ? first : second;
+}
+
+int equilibrate_plate_wavefront(plate_t* plate, const options_t* options) {
+  wavefront_t wavefront;
+  int error = init_wavefront(&wavefront, plate, options);
+  if (error != EXIT_SUCCESS) return error;
+
+  while (true) {
+    // Auxiliary matrix holds the current state, tiles write the main one
+    set_auxiliary(plate->plate_matrix);
+    // Blocks do not go past the stop state, if there is one
+    const uint64_t states = plate->stop_state ?
+        min_u64(wavefront.block_states, plate->stop_state - plate->k_states)
+        : wavefront.block_states;
+    const uint64_t equilibrium = advance_tiles(&wavefront, states);
+
+    if (equilibrium > 0) {
+      // Auxiliary still holds the start of the block, so the block is redone
+      // to stop exactly at the first equilibrated state
+      if (equilibrium < states) advance_tiles(&wavefront, equilibrium);
+      plate->k_states += equilibrium;
+      trace_state(plate->trace, plate->k_states, wavefront.max_delta);
+      break;
+    }
+    plate->k_states += states;
+    trace_state(plate->trace, plate->k_states, wavefront.max_delta);
+    if (plate->k_states == plate->stop_state) break;
+  }
+
+  plate->max_delta = wavefront.max_delta;
+  plate->moved_bytes += wavefront.moved_bytes;
+  destroy_wavefront(&wavefront);
+  return EXIT_SUCCESS;
+}
+
+int init_wavefront(wavefront_t* wavefront, plate_t* plate
+    , const options_t* options) {
+  plate_matrix_t* plate_matrix = plate->plate_matrix;
+  wavefront->plate_matrix = plate_matrix;
+  wavefront->options = options;
+  wavefront->mult_constant = calculate_mult_constant(plate);
+  wavefront->epsilon = plate->epsilon;
+  wavefront->update_row = get_update_row(options->simd);
+  wavefront->thread_count = options->thread_count;
+  wavefront->block_states = options->tile_states;
+  wavefront->moved_bytes = 0;
+  wavefront->max_delta = 0;
+
+  // Plates with less than three rows or columns have no interior cells
+  uint64_t interior_rows = plate_matrix->rows > 2 ? plate_matrix->rows - 2 : 0;
+  uint64_t interior_cols = plate_matrix->cols > 2 ? plate_matrix->cols - 2 : 0;
+  wavefront->tile_rows = min_u64(options->tile_rows, interior_rows);
+  wavefront->tile_cols = min_u64(options->tile_cols, interior_cols);
+  wavefront->tiles_per_row = 0;
+  wavefront->tile_count = 0;
+  if (interior_rows > 0 && interior_cols > 0) {
+    wavefront->tiles_per_row = (interior_cols + wavefront->tile_cols - 1)
+        / wavefront->tile_cols;
+    wavefront->tile_count = wavefront->tiles_per_row
+        * ((interior_rows + wavefront->tile_rows - 1) / wavefront->tile_rows);
+  }
+
+  // A tile and its halo, clipped to the plate, must fit in a scratch buffer
+  wavefront->scratch_size = min_u64(wavefront->tile_rows
+      + 2 * wavefront->block_states, plate_matrix->rows)
+      * min_u64(wavefront->tile_cols + 2 * wavefront->block_states
+      , plate_matrix->cols);
+
+  wavefront->max_deltas = (double*) calloc(wavefront->thread_count
+      * wavefront->block_states, sizeof(double));
+  wavefront->scratches = (double**) calloc(wavefront->thread_count
+      , sizeof(double*));
+  if (!wavefront->max_deltas || !wavefront->scratches) {
+    fprintf(stderr, "Error: Could not allocate wavefront kernel buffers\n");
+    destroy_wavefront(wavefront);
+    return ERR_KERNEL_ALLOC;
+  }
+
+  for (uint64_t thread = 0; thread < wavefront->thread_count; ++thread) {
+    wavefront->scratches[thread] = (double*) malloc(2 * sizeof(double)
+        * wavefront->scratch_size);
+    if (!wavefront->scratches[thread]) {
+      fprintf(stderr, "Error: Could not allocate wavefront kernel buffers\n");
+      destroy_wavefront(wavefront);
+      return ERR_KERNEL_ALLOC;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+void destroy_wavefront(wavefront_t* wavefront) {
+  if (wavefront->scratches) {
+    for (uint64_t thread = 0; thread < wavefront->thread_count; ++thread) {
+      free(wavefront->scratches[thread]);
+    }
+  }
+  free(wavefront->scratches);
+  free(wavefront->max_deltas);
+}
+
+uint64_t advance_tiles(wavefront_t* wavefront, uint64_t states) {
+  const uint64_t block_states = wavefront->block_states;
+  // Tiles raise the maximum change of each state from zero
+  for (uint64_t index = 0; index < wavefront->thread_count * block_states;
+      ++index) {
+    wavefront->max_deltas[index] = 0;
+  }
+
+  uint64_t moved_bytes = 0;
+  // Tiles are independent within a block, so they are mapped statically
+  #pragma omp parallel for num_threads(wavefront->thread_count) \
+      schedule(static) default(none) shared(wavefront, states, block_states) \
+      reduction(+:moved_bytes)
+  for (uint64_t index = 0; index < wavefront->tile_count; ++index) {
+    tile_t tile;
+    get_tile(wavefront, index, &tile);
+    const int thread = omp_get_thread_num();
+    pin_thread(wavefront->options, thread);
+    moved_bytes += advance_tile(wavefront, &tile, states
+        , wavefront->scratches[thread]
+        , &wavefront->max_deltas[thread * block_states]);
+  }
+  wavefront->moved_bytes += moved_bytes;
+
+  // Find the first state where every thread's tiles were equilibrated
+  for (uint64_t state = 0; state < states; ++state) {
+    double max_delta = 0;
+    for (uint64_t thread = 0; thread < wavefront->thread_count; ++thread) {
+      const double delta = wavefront->max_deltas[thread * block_states
+          + state];
+      if (delta > max_delta) max_delta = delta;
+    }
+    wavefront->max_delta = max_delta;
+    if (max_delta <= wavefront->epsilon) return state + 1;
+  }
+  return 0;
+}
+
+uint64_t advance_tile(wavefront_t* wavefront, const tile_t* tile
+    , uint64_t states, double* scratch, double* max_deltas) {
+  plate_matrix_t* plate_matrix = wavefront->plate_matrix;
+  const uint64_t rows = plate_matrix->rows;
+  const uint64_t cols = plate_matrix->cols;
+  const double mult_constant = wavefront->mult_constant;
+  const update_row_t update_row = wavefront->update_row;
+
+  // Region loaded: owned cells plus a halo as wide as the states to advance
+  const uint64_t top = tile->first_row > states ? tile->first_row - states : 0;
+  const uint64_t bottom = min_u64(tile->last_row + states, rows);
+  const uint64_t left = tile->first_col > states ? tile->first_col - states
+      : 0;
+  const uint64_t right = min_u64(tile->last_col + states, cols);
+  const uint64_t width = right - left;
+  const uint64_t height = bottom - top;
+
+  double* current = scratch;
+  double* next = scratch + wavefront->scratch_size;
+  for (uint64_t row = 0; row < height; ++row) {
+    memcpy(current + row * width, plate_matrix->auxiliary_matrix
+        + (top + row) * cols + left, width * sizeof(double));
+  }
+  // Next buffer also needs the plate borders, which never change
+  memcpy(next, current, height * width * sizeof(double));
+
+  for (uint64_t state = 1; state <= states; ++state) {
+    // Cells valid after this state shrink by one on each side per state
+    const uint64_t margin = states - state;
+    const uint64_t first_row = tile->first_row > margin + 1 ?
+        tile->first_row - margin : 1;
+    const uint64_t last_row = min_u64(tile->last_row + margin, rows - 1);
+    const uint64_t first_col = tile->first_col > margin + 1 ?
+        tile->first_col - margin : 1;
+    const uint64_t last_col = min_u64(tile->last_col + margin, cols - 1);
+
+    for (uint64_t row = first_row; row < last_row; ++row) {
+      const uint64_t first_cell = (row - top) * width + (first_col - left);
+      if (row < tile->first_row || row >= tile->last_row) {
+        // Halo rows do not decide if the tile was equilibrated
+        update_row(current + first_cell, next + first_cell
+            , last_col - first_col, width, mult_constant);
+        continue;
+      }
+      // Halo columns on each side of owned cells
+      const uint64_t left_halo = tile->first_col - first_col;
+      const uint64_t owned = tile->last_col - tile->first_col;
+      update_row(current + first_cell, next + first_cell, left_halo, width
+          , mult_constant);
+      const double max_difference = update_row(current + first_cell
+          + left_halo, next + first_cell + left_halo, owned, width
+          , mult_constant);
+      update_row(current + first_cell + left_halo + owned
+          , next + first_cell + left_halo + owned, last_col - tile->last_col
+          , width, mult_constant);
+
+      // Only owned cells decide if the tile was equilibrated in this state
+      if (max_difference > max_deltas[state - 1]) {
+        max_deltas[state - 1] = max_difference;
+      }
+    }
+
+    // New temperatures become the current ones for the next state
+    double* temp = current;
+    current = next;
+    next = temp;
+  }
+
+  // Write owned cells back to the plate
+  const uint64_t owned_width = tile->last_col - tile->first_col;
+  for (uint64_t row = tile->first_row; row < tile->last_row; ++row) {
+    memcpy(plate_matrix->matrix + row * cols + tile->first_col
+        , current + (row - top) * width + (tile->first_col - left)
+        , owned_width * sizeof(double));
+  }
+
+  return sizeof(double) * (height * width
+      + (tile->last_row - tile->first_row) * owned_width);
+}
+
+void get_tile(const wavefront_t* wavefront, uint64_t index, tile_t* tile) {
+  const plate_matrix_t* plate_matrix = wavefront->plate_matrix;
+  // Tiles start at the first interior cell, last ones may be smaller
+  tile->first_row = 1 + (index / wavefront->tiles_per_row)
+      * wavefront->tile_rows;
+  tile->last_row = min_u64(tile->first_row + wavefront->tile_rows
+      , plate_matrix->rows - 1);
+  tile->first_col = 1 + (index % wavefront->tiles_per_row)
+      * wavefront->tile_cols;
+  tile->last_col = min_u64(tile->first_col + wavefront->tile_cols
+      , plate_matrix->cols - 1);
+}
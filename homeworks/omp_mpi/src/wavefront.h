@@ -0,0 +1,31 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef WAVEFRONT_H
+#define WAVEFRONT_H
+
+#include "options.h"
+#include "plate.h"
+
+/**
+ * @brief Simulates heat transfer of a plate until equilibrium with temporal
+ * blocking (overlapped tiling).
+ *
+ * The interior of the plate is split into tiles. In every block, each tile is
+ * copied with a halo as wide as the states to advance into a scratch area
+ * small enough to stay in cache, where it advances those states before its
+ * owned cells are written back. Halos are recomputed by every tile instead of
+ * being exchanged, so tiles are independent within a block, and the matrix
+ * is streamed from memory once per block instead of once per state.
+ *
+ * Equilibrium is checked for every state of a block. If the plate reached it
+ * before the last state of the block, the block is redone from its starting
+ * matrix with fewer states, so k_states and the final temperatures are the
+ * same as the ones of the sweep kernel.
+ *
+ * @param plate Plate to equilibrate
+ * @param options Options with tile dimensions and amount of threads
+ * @return EXIT_SUCCESS on success, ERR_KERNEL_ALLOC otherwise.
+ */
+int equilibrate_plate_wavefront(plate_t* plate, const options_t* options);
+
+#endif  // WAVEFRONT_H
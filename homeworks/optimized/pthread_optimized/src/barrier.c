@@ -0,0 +1,93 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "barrier.h"
+
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/// @brief Hints the processor that the calling thread is spinning
+static inline void relax_processor(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#endif
+}
+
+/// @brief Waits until the sense of the barrier is no longer the given one
+void wait_for_sense(state_barrier_t* barrier, uint32_t sense);
+
+void init_state_barrier(state_barrier_t* barrier, uint64_t thread_count) {
+  barrier->thread_count = thread_count;
+  const long processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+  barrier->spin_count = processor_count > 0
+      && thread_count <= (uint64_t) processor_count ? BARRIER_SPIN_COUNT : 0;
+  atomic_init(&barrier->arrived, 0);
+  atomic_init(&barrier->all_equilibrated, true);
+  barrier->equilibrated = true;
+  atomic_init(&barrier->sense, 0);
+  atomic_init(&barrier->sleepers, 0);
+}
+
+bool state_barrier_wait(state_barrier_t* barrier, bool equilibrated
+    , barrier_completion_t completion, void* data) {
+  // Sense of this phase, only reversed once every thread arrived
+  const uint32_t sense = atomic_load_explicit(&barrier->sense
+      , memory_order_acquire);
+  if (!equilibrated) {
+    atomic_store_explicit(&barrier->all_equilibrated, false
+        , memory_order_relaxed);
+  }
+
+  // Arrivals release the flags and cells of each thread to the last one
+  const uint64_t arrived = atomic_fetch_add_explicit(&barrier->arrived, 1
+      , memory_order_acq_rel) + 1;
+  if (arrived < barrier->thread_count) {
+    wait_for_sense(barrier, sense);
+    // Written before the sense was reversed, and not again until this
+    // thread arrives at the next phase
+    return barrier->equilibrated;
+  }
+
+  // Last thread prepares the next phase before releasing the others
+  const bool all_equilibrated = atomic_load_explicit(
+      &barrier->all_equilibrated, memory_order_relaxed);
+  barrier->equilibrated = all_equilibrated;
+  atomic_store_explicit(&barrier->all_equilibrated, true
+      , memory_order_relaxed);
+  atomic_store_explicit(&barrier->arrived, 0, memory_order_relaxed);
+  if (completion) completion(data, all_equilibrated);
+
+  // Sleepers either are seen here, or see the new sense in the futex
+  atomic_store_explicit(&barrier->sense, sense ^ 1, memory_order_seq_cst);
+  if (atomic_load_explicit(&barrier->sleepers, memory_order_seq_cst) > 0) {
+    futex_wake(&barrier->sense, INT_MAX);
+  }
+  return all_equilibrated;
+}
+
+void wait_for_sense(state_barrier_t* barrier, uint32_t sense) {
+  for (uint64_t spin = 0; spin < barrier->spin_count; ++spin) {
+    if (atomic_load_explicit(&barrier->sense, memory_order_acquire)
+        != sense) {
+      return;
+    }
+    relax_processor();
+  }
+
+  atomic_fetch_add_explicit(&barrier->sleepers, 1, memory_order_seq_cst);
+  // The futex only sleeps if the sense was not reversed meanwhile
+  while (atomic_load_explicit(&barrier->sense, memory_order_seq_cst)
+      == sense) {
+    futex_wait(&barrier->sense, sense);
+  }
+  atomic_fetch_sub_explicit(&barrier->sleepers, 1, memory_order_relaxed);
+}
+
+void futex_wait(_Atomic uint32_t* word, uint32_t value) {
+  syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+}
+
+void futex_wake(_Atomic uint32_t* word, int count) {
+  syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
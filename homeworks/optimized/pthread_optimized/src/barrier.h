@@ -0,0 +1,78 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef BARRIER_H
+#define BARRIER_H
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+/** @brief Checks of the barrier's sense before a thread sleeps on it */
+#define BARRIER_SPIN_COUNT 2000
+
+/**
+ * @brief Completion step of a barrier phase, run by the last thread to
+ * arrive while the others still wait.
+ * @param data Data given to the barrier wait
+ * @param equilibrated AND of the flags of the threads of the phase
+ */
+typedef void (*barrier_completion_t)(void* data, bool equilibrated);
+
+/**
+ * @struct state_barrier_t
+ * @brief Sense-reversing barrier that also reduces a flag of every thread.
+ *
+ * Threads arrive with their equilibrated flag, and the barrier returns the
+ * AND of the flags of all of them. The last thread to arrive runs the
+ * completion step, then reverses the sense, which releases the others.
+ * Waiting threads spin on the sense BARRIER_SPIN_COUNT times, and then sleep
+ * on it with a futex. A team with more threads than online processors
+ * sleeps right away, since spinning would only delay the threads it waits
+ * for. Neither arriving nor leaving takes a mutex.
+ */
+typedef struct state_barrier {
+  uint64_t thread_count;         /**< Threads meeting at the barrier */
+  uint64_t spin_count;           /**< Checks of the sense before sleeping */
+  atomic_uint_fast64_t arrived;  /**< Threads arrived in this phase */
+  atomic_bool all_equilibrated;  /**< AND of the flags arrived in this phase */
+  bool equilibrated;             /**< AND of the flags of the last phase */
+  _Atomic uint32_t sense;        /**< Reversed by each phase, futex word */
+  atomic_uint_fast32_t sleepers; /**< Threads that may sleep on the futex */
+} state_barrier_t;
+
+/**
+ * @brief Sleeps while a futex word holds a value. May return spuriously,
+ * so callers check the word again.
+ * @param word Futex word
+ * @param value Value the word must hold for the thread to sleep
+ */
+void futex_wait(_Atomic uint32_t* word, uint32_t value);
+
+/**
+ * @brief Wakes threads sleeping on a futex word.
+ * @param word Futex word
+ * @param count Maximum threads to wake, INT_MAX for all of them
+ */
+void futex_wake(_Atomic uint32_t* word, int count);
+
+/**
+ * @brief Initializes a barrier for a team of threads.
+ * @param barrier Barrier to initialize
+ * @param thread_count Threads meeting at the barrier
+ */
+void init_state_barrier(state_barrier_t* barrier, uint64_t thread_count);
+
+/**
+ * @brief Waits until every thread of the team arrives.
+ *
+ * @param barrier Barrier of the team
+ * @param equilibrated Flag of the calling thread
+ * @param completion Step run by the last thread before releasing the
+ * others, NULL for none
+ * @param data Data given to the completion step
+ * @return AND of the flags of every thread of the phase
+ */
+bool state_barrier_wait(state_barrier_t* barrier, bool equilibrated
+    , barrier_completion_t completion, void* data);
+
+#endif  // BARRIER_H
@@ -8,7 +8,9 @@
 // ARGS RELATED
 enum {
   ERR_NO_JOB_FILE = EXIT_FAILURE + 1,
-  ERR_INVALID_THREAD_COUNT
+  ERR_INVALID_THREAD_COUNT,
+  ERR_INVALID_AFFINITY,
+  ERR_INVALID_BALANCE
 };
 
 // JOB RELATED
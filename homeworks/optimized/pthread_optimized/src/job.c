@@ -4,7 +4,8 @@
 
 // ***[SIMULATION RELATED]***
 
-int simulate(char* job_file_path, uint64_t thread_count) {
+int simulate(char* job_file_path, uint64_t thread_count
+    , const affinity_t* affinity, balance_t balance) {
   int error = EXIT_SUCCESS;
 
   // Create job struct
@@ -19,8 +20,19 @@ int simulate(char* job_file_path, uint64_t thread_count) {
   struct timespec start_time, finish_time;
   clock_gettime(CLOCK_MONOTONIC, &start_time);
 
+  // Threads are kept for the whole job, and created the first time a plate
+  // needs them
+  thread_pool_t pool;
+  if (init_thread_pool(&pool, thread_count, equilibrate_plate_concurrent)
+      != EXIT_SUCCESS) {
+    fprintf(stderr, "Error: Could not create thread pool\n");
+    destroy_job(job);
+    return ERR_CREATE_THREAD_TEAM;
+  }
+
   // Process the plates
-  error = process_plates(job, thread_count);
+  error = process_plates(job, &pool, affinity, balance);
+  destroy_thread_pool(&pool);
   if (error != EXIT_SUCCESS) return error;
 
   // Record end time
@@ -41,7 +53,8 @@ int simulate(char* job_file_path, uint64_t thread_count) {
 
 
 
-int process_plates(job_t* job, uint64_t thread_count) {
+int process_plates(job_t* job, thread_pool_t* pool
+    , const affinity_t* affinity, balance_t balance) {
   // For each plate stored
   for (size_t plate_number = 0; plate_number < job->plates_count;
     ++plate_number) {
@@ -58,7 +71,8 @@ int process_plates(job_t* job, uint64_t thread_count) {
     struct timespec start_time, finish_time;
     clock_gettime(CLOCK_MONOTONIC, &start_time);
 
-    error = equilibrate_plate(job, plate_number, thread_count);
+    error = equilibrate_plate(job, plate_number, pool, affinity
+        , balance);
     if (error!= EXIT_SUCCESS) {
       destroy_job(job);
       return error;
@@ -80,11 +94,12 @@ int process_plates(job_t* job, uint64_t thread_count) {
 
 
 
-int equilibrate_plate(job_t* job, size_t plate_number, uint64_t thread_count) {
+int equilibrate_plate(job_t* job, size_t plate_number, thread_pool_t* pool
+    , const affinity_t* affinity, balance_t balance) {
   plate_t* curr_plate = job->plates[plate_number];
   shared_data_t shared_data;
-  if (init_shared_data(&shared_data, curr_plate, thread_count)
-      != EXIT_SUCCESS) {
+  if (init_shared_data(&shared_data, curr_plate, pool->thread_count, affinity
+      , balance) != EXIT_SUCCESS) {
     fprintf(stderr, "Error: Could not initialize shared data for plate %zu"
         , plate_number);
     return ERR_INIT_SHARED_DATA;
@@ -93,25 +108,32 @@ int equilibrate_plate(job_t* job, size_t plate_number, uint64_t thread_count) {
   private_data_t* thread_team = init_private_data(&shared_data);
 
   if (!thread_team) {
+    free(shared_data.placed_matrix);
+    free(shared_data.placed_auxiliary);
+    free((void*) shared_data.chunks);
     fprintf(stderr, "Error: Could not create thread team for plate %zu"
         , plate_number);
     return ERR_CREATE_THREAD_TEAM;
   }
 
   set_auxiliary(curr_plate->plate_matrix);
-  int errors = create_threads(equilibrate_plate_concurrent, thread_team);
-  if (errors > 0) {
+  // Team of the pool sized for this plate, workers not in it keep parked
+  int error = run_thread_team(pool, thread_team);
+  free((void*) shared_data.chunks);
+  if (error != EXIT_SUCCESS) {
     free(thread_team);
-    return errors;
+    return error;
   }
 
-  join_threads(shared_data.thread_count, thread_team);
-
   set_auxiliary(curr_plate->plate_matrix);
 
   // Store k, number of states iterated until equilibrium, in plate
   curr_plate->k_states = shared_data.k_states;
 
+  // Rows stolen show how unbalanced the blocks of the threads were
+  if (shared_data.balance == BALANCE_STEAL) {
+    report_balance(plate_number, thread_team);
+  }
   free(thread_team);
 
   return EXIT_SUCCESS;
@@ -14,6 +14,7 @@
 #include "common.h"
 #include "errors.h"
 #include "plate.h"
+#include "pool.h"
 #include "threads.h"
 
 /** @brief Initial capacity for plates allocation. */
@@ -42,28 +43,37 @@ typedef struct {
  * 
  * @param job_file_path path of job to simulate
  * @param thread_count amount of threads used to simulate
+ * @param affinity CPUs to pin threads to in NUMA mode
+ * @param balance Way rows are balanced among threads
  * @return Success or failure of procedure
  */
-int simulate(char* job_file_path, uint64_t thread_count);
+int simulate(char* job_file_path, uint64_t thread_count
+    , const affinity_t* affinity, balance_t balance);
 
 /**
  * @brief Loops through all of the plates recorded to simulate.
  * 
  * @param job current working job
- * @param thread_count Amount of threads available for use
+ * @param pool Threads kept for the whole job
+ * @param affinity CPUs to pin threads to in NUMA mode
+ * @param balance Way rows are balanced among threads
  * @return Success or failure of processing
  */
-int process_plates(job_t* job, uint64_t thread_count);
+int process_plates(job_t* job, thread_pool_t* pool
+    , const affinity_t* affinity, balance_t balance);
 
 /**
  * @brief Equilibrates current plate
  * 
  * @param job current working job
  * @param plate_number current plate's index
- * @param thread_count Amount of threads available for use
+ * @param pool Threads kept for the whole job, a team of them simulates it
+ * @param affinity CPUs to pin threads to in NUMA mode
+ * @param balance Way rows are balanced among threads
  * @return Success or failure of equilibrate
  */
-int equilibrate_plate(job_t* job, size_t plate_number,  uint64_t thread_count);
+int equilibrate_plate(job_t* job, size_t plate_number, thread_pool_t* pool
+    , const affinity_t* affinity, balance_t balance);
 
 /// @brief Carries out recording of updated plate and freeing of memory.
 /// @see equilibrate_plates
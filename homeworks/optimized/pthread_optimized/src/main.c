@@ -1,9 +1,11 @@
 // Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
 #include <assert.h>
 #include <inttypes.h>
+#include <sched.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include "job.h"
@@ -13,9 +15,21 @@
  * @param argc Argument count.
  * @param argv Arguments vector.
  * @param *thread_count POinter to thread_count in main to set.
+ * @param affinity Affinity list in main to set, if one was given.
+ * @param balance Balance in main to set, if one was given.
  * @return Success or failure of arguments analysis.
  */
-int analyze_arguments(int argc, char* argv[], uint64_t* thread_count);
+int analyze_arguments(int argc, char* argv[], uint64_t* thread_count
+    , affinity_t* affinity, balance_t* balance);
+
+/**
+ * @brief Parses a list of CPUs like 0-3,8,10-11 to pin threads to, or none
+ * to leave them unpinned.
+ * @param value Text of the affinity list.
+ * @param affinity Affinity list to store the CPUs.
+ * @return EXIT_SUCCESS if the list is valid, ERR_INVALID_AFFINITY otherwise.
+ */
+int parse_affinity(const char* value, affinity_t* affinity);
 
 /**
  * @brief Processes execution command to set thread count and 
@@ -27,30 +41,87 @@ int analyze_arguments(int argc, char* argv[], uint64_t* thread_count);
 int main(int argc, char* argv[]) {
   // Assume default amount of threads first
   uint64_t thread_count = sysconf(_SC_NPROCESSORS_ONLN);
+  // Threads are not pinned unless an affinity list is given
+  static affinity_t affinity;
+  // Each thread keeps its block of rows unless stealing is requested
+  balance_t balance = BALANCE_STATIC;
 
-  int error = analyze_arguments(argc, argv, &thread_count);
+  int error = analyze_arguments(argc, argv, &thread_count, &affinity
+      , &balance);
 
-  if (error == EXIT_SUCCESS) error = simulate(argv[1], thread_count);
+  if (error == EXIT_SUCCESS) {
+    error = simulate(argv[1], thread_count, &affinity, balance);
+  }
 
   return error;
 }
 
-int analyze_arguments(int argc, char* argv[], uint64_t* thread_count) {
+int analyze_arguments(int argc, char* argv[], uint64_t* thread_count
+    , affinity_t* affinity, balance_t* balance) {
   int error = EXIT_SUCCESS;
   // Must at least include job directory
-  if (argc == 3) {
+  if (argc >= 3 && argc <= 5) {
     if (sscanf(argv[2], "%zu", thread_count) != 1
         || *thread_count <= 0 || *thread_count > 32000) {
       // Inform usage to user
       fprintf(stderr,
         "Error: Invalid thread count (0 < thread_count <= 32000)\n");
       error = ERR_INVALID_THREAD_COUNT;
+    } else if (argc >= 4 && parse_affinity(argv[3], affinity)
+        != EXIT_SUCCESS) {
+      fprintf(stderr, "Error: Invalid affinity list %s\n", argv[3]);
+      error = ERR_INVALID_AFFINITY;
+    } else if (argc == 5) {
+      if (strcmp(argv[4], "steal") == 0) {
+        *balance = BALANCE_STEAL;
+      } else if (strcmp(argv[4], "static") != 0) {
+        fprintf(stderr, "Error: Invalid balance (static or steal)\n");
+        error = ERR_INVALID_BALANCE;
+      }
     }
-  } else if (argc < 2) {
-    // Inform usage to user
+  } else if (argc < 2 || argc > 5) {
+    // Inform usage to user, also of arguments that would be ignored
     fprintf(stderr,
-        "usage: bin/pthread job_file_path thread_count (count optional)\n");
+        "usage: bin/pthread_optimized job_file_path thread_count"
+        " (count optional) affinity_list (list optional) balance (optional)\n");
     error = ERR_NO_JOB_FILE;
   }
   return error;
 }
+
+int parse_affinity(const char* value, affinity_t* affinity) {
+  // Threads are left unpinned, so a balance can be given without NUMA mode
+  if (strcmp(value, "none") == 0) return EXIT_SUCCESS;
+  uint64_t count = 0;
+  const char* range = value;
+  // Each range is either a CPU or first-last, separated by commas
+  while (*range) {
+    unsigned first = 0, last = 0;
+    int length = 0;
+    if (sscanf(range, "%u-%u%n", &first, &last, &length) != 2) {
+      if (sscanf(range, "%u%n", &first, &length) != 1) {
+        return ERR_INVALID_AFFINITY;
+      }
+      last = first;
+    }
+    if (range[0] < '0' || range[0] > '9' || first > last
+        || last >= CPU_SETSIZE) {
+      return ERR_INVALID_AFFINITY;
+    }
+    for (unsigned cpu = first; cpu <= last; ++cpu) {
+      if (count == MAX_AFFINITY_CPUS) return ERR_INVALID_AFFINITY;
+      affinity->cpus[count++] = (uint16_t) cpu;
+    }
+
+    range += length;
+    if (*range == ',') {
+      ++range;
+      if (*range == '\0') return ERR_INVALID_AFFINITY;
+    } else if (*range != '\0') {
+      return ERR_INVALID_AFFINITY;
+    }
+  }
+  if (count == 0) return ERR_INVALID_AFFINITY;
+  affinity->count = count;
+  return EXIT_SUCCESS;
+}
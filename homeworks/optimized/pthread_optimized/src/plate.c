@@ -3,6 +3,21 @@
 #include "plate.h"
 #include "threads.h"
 
+/// @brief Moves a plate to its next state once every thread updated its
+/// rows. Completion step of the barrier of each state
+void finish_state(void* data, bool equilibrated);
+
+/**
+ * @brief Updates the rows of a chunk of a block, and clears the equilibrated
+ * flag of the calling thread if any cell changed more than epsilon.
+ * @param private_data Data of the calling thread
+ * @param owner Data of the thread whose block the chunk belongs to
+ * @param chunk Number of the chunk in the block
+ * @return Amount of rows of the chunk
+ */
+uint64_t equilibrate_chunk(private_data_t* private_data
+    , const private_data_t* owner, uint64_t chunk);
+
 int set_plate_matrix(plate_t* plate, char* source_directory) {
   // Concatenate plate file name with same directory specified for job
   char* plate_file_path = build_file_path(source_directory, plate->file_name);
@@ -51,10 +66,55 @@ int set_plate_matrix(plate_t* plate, char* source_directory) {
 void* equilibrate_rows(void* data) {
   private_data_t* private_data = (private_data_t*) data;
   shared_data_t* shared_data = private_data->shared_data;
+  const uint64_t thread_count = shared_data->thread_count;
+  const uint64_t thread_number = private_data->thread_number;
+  // The static map updates the whole block, which is a single chunk
+  if (shared_data->balance == BALANCE_STATIC) {
+    equilibrate_chunk(private_data, private_data, /*chunk*/ 0);
+    return NULL;
+  }
+  _Atomic uint64_t* chunks = shared_data->chunks
+      + private_data->state % 2 * thread_count;
+  uint64_t chunk = 0;
+  // Own block first, from its head
+  while (take_chunk(&chunks[thread_number], /*from_tail*/ false, &chunk)) {
+    equilibrate_chunk(private_data, private_data, chunk);
+  }
+  // Then the tails of the other blocks, nearest first
+  for (uint64_t distance = 1; distance < thread_count; ++distance) {
+    if (thread_number + distance < thread_count) {
+      const private_data_t* owner = shared_data->team + thread_number
+          + distance;
+      while (take_chunk(&chunks[owner->thread_number], /*from_tail*/ true
+          , &chunk)) {
+        private_data->stolen_rows += equilibrate_chunk(private_data, owner
+            , chunk);
+      }
+    }
+    if (distance <= thread_number) {
+      const private_data_t* owner = shared_data->team + thread_number
+          - distance;
+      while (take_chunk(&chunks[owner->thread_number], /*from_tail*/ true
+          , &chunk)) {
+        private_data->stolen_rows += equilibrate_chunk(private_data, owner
+            , chunk);
+      }
+    }
+  }
+  return NULL;
+}
+
+uint64_t equilibrate_chunk(private_data_t* private_data
+    , const private_data_t* owner, uint64_t chunk) {
+  shared_data_t* shared_data = private_data->shared_data;
   plate_matrix_t* plate_matrix = shared_data->plate_matrix;
-  uint64_t starting_row = private_data->starting_row;
-  uint64_t ending_row = private_data->finish_row;
-  // Only work designated rows
+  uint64_t starting_row = owner->starting_row
+      + chunk * shared_data->chunk_rows;
+  uint64_t ending_row = starting_row + shared_data->chunk_rows;
+  if (ending_row > owner->finish_row) ending_row = owner->finish_row;
+  // Kept local, so threads do not write next to each other's flags per cell
+  bool equilibrated = true;
+  // Only work rows of the chunk
   for (uint64_t row = starting_row; row < ending_row; ++row) {
     for (uint64_t col = 1; col < plate_matrix->cols - 1; ++col) {
       // Update the cell temperature based on surrounding cells
@@ -68,63 +128,64 @@ void* equilibrate_rows(void* data) {
       double difference = fabs(new_temperature - old_temperature);
       // Track the maximum temperature change in this update step
       if (difference > shared_data->epsilon) {
-        private_data->equilibrated = false;
+        equilibrated = false;
       }
     }
   }
-  return NULL;
+  if (!equilibrated) private_data->equilibrated = false;
+  return ending_row - starting_row;
 }
 
 void* equilibrate_plate_concurrent(void* data) {
   private_data_t* private_data = (private_data_t*) data;
   shared_data_t* shared_data = private_data->shared_data;
-  plate_matrix_t* plate_matrix = shared_data->plate_matrix;
-
-  while (true) {
+  // Rows are moved to the NUMA node of the thread updating them
+  if (shared_data->affinity->count > 0) place_thread_rows(private_data);
+
+  // Only stealing threads are timed, as only they are reported
+  const bool stealing = shared_data->balance == BALANCE_STEAL;
+  struct timespec lap_time, now;
+  if (stealing) clock_gettime(CLOCK_MONOTONIC, &lap_time);
+  bool done = false;
+  while (!done) {
+    ++private_data->state;
     // Reset local flag for this round
     private_data->equilibrated = true;
     // Update rows; this may set equilibrated = false
     equilibrate_rows(data);
-
-    // Combine result into shared flag
-    pthread_mutex_lock(&shared_data->can_access_equilibrated);
-      shared_data->equilibrated_plate &= private_data->equilibrated;
-    pthread_mutex_unlock(&shared_data->can_access_equilibrated);
-
-    // First barrier: sync all threads after work
-    // Second barrier: ensure all threads see updated matrix
-    // and equilibrium result
-    int barrier_result = pthread_barrier_wait(&shared_data->can_continue1);
-    if (barrier_result == PTHREAD_BARRIER_SERIAL_THREAD) {
-      ++shared_data->k_states;
-      set_auxiliary(plate_matrix);
-    }
-
-    pthread_barrier_wait(&shared_data->can_continue2);
-
-    // Check if we’re done
-    pthread_mutex_lock(&shared_data->can_access_equilibrated);
-      bool done = shared_data->equilibrated_plate;
-    pthread_mutex_unlock(&shared_data->can_access_equilibrated);
-
-    if (done) {
-      break;
+    if (stealing) {
+      // Chunks of the next state, last taken in the previous one, which
+      // every thread finished before this one started
+      atomic_store_explicit(&shared_data->chunks[(private_data->state + 1)
+          % 2 * shared_data->thread_count + private_data->thread_number]
+          , private_data->block_chunks, memory_order_relaxed);
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      private_data->busy_seconds += get_elapsed_seconds(&lap_time, &now);
+      lap_time = now;
     }
 
-    if (pthread_barrier_wait(&shared_data->can_continue1)
-        == PTHREAD_BARRIER_SERIAL_THREAD) {
-      pthread_mutex_lock(&shared_data->can_access_equilibrated);
-        shared_data->equilibrated_plate = true;
-      pthread_mutex_unlock(&shared_data->can_access_equilibrated);
+    // Single barrier per state: it combines the flags of all threads, and
+    // the last thread to arrive moves to the next state before releasing
+    // the others, which see the updated matrix and equilibrium result
+    done = state_barrier_wait(&shared_data->barrier
+        , private_data->equilibrated, finish_state, shared_data);
+    if (stealing) {
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      private_data->idle_seconds += get_elapsed_seconds(&lap_time, &now);
+      lap_time = now;
     }
-
-    // Prevent equilibrated plate change during simul
-    pthread_barrier_wait(&shared_data->can_continue2);
   }
 
   return NULL;
 }
 
+void finish_state(void* data, bool equilibrated) {
+  (void) equilibrated;
+  shared_data_t* shared_data = (shared_data_t*) data;
+  ++shared_data->k_states;
+  set_auxiliary(shared_data->plate_matrix);
+}
+
 
 
 int update_plate_file(plate_t* plate, char* source_directory) {
@@ -47,7 +47,11 @@ int set_plate_matrix(plate_t* plate, char* source_directory);
  * @brief Updates the plate's temperature matrix using diffusion calculations.
  * 
  * Computes new temperatures for each cell of its designated section in the
- * plate and checks for equilibrium.
+ * plate and checks for equilibrium. When stealing, the section is taken in
+ * chunks of rows from its head, and once none is left, the thread steals
+ * chunks from the tails of the sections of the nearest threads, so a slow
+ * thread does not hold the others at the barrier. Each row is still updated
+ * once per state.
  * 
  * @param data PRivate data with information necessary to equilibrate
  */
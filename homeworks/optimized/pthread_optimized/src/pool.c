@@ -0,0 +1,118 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "pool.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/// @brief Runs a member of each team a worker is woken for, until the pool
+/// is stopping
+void* run_pool_worker(void* data);
+
+/// @brief Wakes a worker, after everything it reads was written
+void wake_pool_worker(pool_worker_t* worker);
+
+int init_thread_pool(thread_pool_t* pool, uint64_t thread_count
+    , void* (*routine)(void*)) {
+  assert(thread_count > 0);
+  pool->thread_count = thread_count;
+  pool->worker_count = 0;
+  pool->routine = routine;
+  pool->team = NULL;
+  atomic_init(&pool->pending, 0);
+  pool->stopping = false;
+  // The calling thread is the first member of every team, so a slot is
+  // left over, which keeps a pool of one thread from allocating nothing
+  pool->workers = (pool_worker_t*) calloc(thread_count, sizeof(pool_worker_t));
+  return pool->workers ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int run_thread_team(thread_pool_t* pool, private_data_t* team) {
+  const uint64_t worker_count = team[0].shared_data->thread_count - 1;
+  assert(worker_count < pool->thread_count);
+
+  // Workers are only created once a team needs them
+  while (pool->worker_count < worker_count) {
+    pool_worker_t* worker = &pool->workers[pool->worker_count];
+    worker->worker_number = pool->worker_count + 1;
+    worker->pool = pool;
+    atomic_init(&worker->generation, 0);
+    if (pthread_create(&worker->thread_id, NULL, run_pool_worker, worker)
+        != 0) {
+      fprintf(stderr, "Error: could not create thread %" PRIu64 "\n"
+          , worker->worker_number);
+      return ERR_CREATE_THREAD;
+    }
+    ++pool->worker_count;
+  }
+
+  pool->team = team;
+  atomic_store_explicit(&pool->pending, (uint32_t) worker_count
+      , memory_order_relaxed);
+  for (uint64_t index = 0; index < worker_count; ++index) {
+    wake_pool_worker(&pool->workers[index]);
+  }
+  pool->routine(&team[0]);
+
+  // The team may be freed once no worker reads it
+  uint32_t pending = 0;
+  while ((pending = atomic_load_explicit(&pool->pending
+      , memory_order_acquire)) != 0) {
+    futex_wait(&pool->pending, pending);
+  }
+  return EXIT_SUCCESS;
+}
+
+void wake_pool_worker(pool_worker_t* worker) {
+  atomic_fetch_add_explicit(&worker->generation, 1, memory_order_release);
+  futex_wake(&worker->generation, 1);
+}
+
+void* run_pool_worker(void* data) {
+  pool_worker_t* worker = (pool_worker_t*) data;
+  thread_pool_t* pool = worker->pool;
+  uint32_t generation = 0;
+
+  while (true) {
+    // Parked until the generation changes, once per team or to stop
+    uint32_t current = 0;
+    while ((current = atomic_load_explicit(&worker->generation
+        , memory_order_acquire)) == generation) {
+      futex_wait(&worker->generation, generation);
+    }
+    generation = current;
+    if (pool->stopping) break;
+
+    pool->routine(&pool->team[worker->worker_number]);
+    // Last worker of the team wakes the calling thread
+    if (atomic_fetch_sub_explicit(&pool->pending, 1, memory_order_acq_rel)
+        == 1) {
+      futex_wake(&pool->pending, 1);
+    }
+  }
+  return NULL;
+}
+
+// MODIFIED FROM IN-CLASS EXAMPLE
+int destroy_thread_pool(thread_pool_t* pool) {
+  pool->stopping = true;
+  for (uint64_t index = 0; index < pool->worker_count; ++index) {
+    wake_pool_worker(&pool->workers[index]);
+  }
+
+  int error_count = 0;
+  for (uint64_t index = 0; index < pool->worker_count; ++index) {
+    const int error = pthread_join(pool->workers[index].thread_id, NULL);
+    if (error) {
+      fprintf(stderr, "Error: could not join thread %" PRIu64 "\n"
+          , pool->workers[index].worker_number);
+      ++error_count;
+    }
+  }
+
+  free(pool->workers);
+  pool->workers = NULL;
+  pool->worker_count = 0;
+  return error_count;
+}
@@ -0,0 +1,79 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#include "barrier.h"
+#include "errors.h"
+#include "threads.h"
+
+/**
+ * @struct pool_worker_t
+ * @brief Thread of a pool, parked on its own futex word between teams.
+ */
+typedef struct pool_worker {
+  pthread_t thread_id;           /**< POSIX thread ID */
+  uint64_t worker_number;        /**< Member of the teams the worker runs */
+  _Atomic uint32_t generation;   /**< Futex word, increased to wake it */
+  struct thread_pool* pool;      /**< Pool of the worker */
+} pool_worker_t;
+
+/**
+ * @struct thread_pool_t
+ * @brief Threads kept for the whole job, and given a team for each plate.
+ *
+ * The calling thread always runs the first member of a team, and worker i
+ * runs member i, so a thread keeps its number, and its CPU in NUMA mode,
+ * from a plate to the next. Workers are created the first time a team
+ * needs them, so a job of small plates does not create any. Only the
+ * members of a team are woken; the other workers keep sleeping.
+ */
+typedef struct thread_pool {
+  uint64_t thread_count;           /**< Maximum threads of a team */
+  uint64_t worker_count;           /**< Workers created so far */
+  pool_worker_t* workers;          /**< One less than thread_count */
+  void* (*routine)(void*);         /**< Run by each member of a team */
+  private_data_t* team;            /**< Team published to the workers */
+  _Atomic uint32_t pending;        /**< Workers of the team still running,
+                                        futex word of the calling thread */
+  bool stopping;                   /**< Makes woken workers finish */
+} thread_pool_t;
+
+/**
+ * @brief Initializes a pool without creating any thread yet.
+ * @param pool Pool to initialize
+ * @param thread_count Maximum threads of a team, the calling one included
+ * @param routine Function run by each member of a team
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE if out of memory.
+ */
+int init_thread_pool(thread_pool_t* pool, uint64_t thread_count
+    , void* (*routine)(void*));
+
+/**
+ * @brief Runs a team, and returns once all of its members finished.
+ *
+ * Creates the workers the team needs and the pool does not have yet,
+ * publishes the team, wakes its members, and runs the first member in the
+ * calling thread.
+ *
+ * @param pool Pool of threads
+ * @param team Private data of each member, as many as the thread count
+ * of their shared data, which may not exceed the one of the pool
+ * @return EXIT_SUCCESS on success, ERR_CREATE_THREAD if a worker could not
+ * be created.
+ */
+int run_thread_team(thread_pool_t* pool, private_data_t* team);
+
+/**
+ * @brief Finishes and joins the workers of a pool, and frees it.
+ * @param pool Pool to destroy
+ * @return The number of errors encountered while joining threads.
+ */
+int destroy_thread_pool(thread_pool_t* pool);
+
+#endif  // POOL_H
@@ -2,6 +2,9 @@
 
 #include "threads.h"
 
+#include <sched.h>
+#include <string.h>
+
 /**
  * @brief Calculates the last row index (exclusive) a thread should process
  *        in a row-wise data partitioning.
@@ -20,8 +23,12 @@
 uint64_t get_finish_row(size_t thread_number, uint64_t evaluated_rows
     , size_t thread_count);
 
+/// @brief Replaces the plate matrices by the ones placed by the threads.
+/// Completion step of the barrier of place_thread_rows
+void replace_placed_matrices(void* data, bool equilibrated);
+
 int init_shared_data(shared_data_t* shared_data, plate_t* plate
-    , uint64_t thread_count) {
+    , uint64_t thread_count, const affinity_t* affinity, balance_t balance) {
   // Precompute constant for temperature update calculations
   double diff_times_interval =
       plate->thermal_diffusivity * plate->interval_duration;
@@ -31,7 +38,6 @@ int init_shared_data(shared_data_t* shared_data, plate_t* plate
   shared_data->plate_matrix = plate->plate_matrix;
   shared_data->mult_constant = mult_constant;
   shared_data->epsilon = plate->epsilon;
-  shared_data->equilibrated_plate = true;
 
   uint64_t evaluated_rows = plate->plate_matrix->rows - 2;
   // Thread count depends on whether there are more threads solicited
@@ -39,22 +45,36 @@ int init_shared_data(shared_data_t* shared_data, plate_t* plate
   shared_data->thread_count = evaluated_rows > thread_count ?
       thread_count : evaluated_rows;
   shared_data->k_states = 0;
-
-  int error = EXIT_SUCCESS;
-  error = pthread_mutex_init(&shared_data->can_access_equilibrated
-      , /*attr*/ NULL);
-  if (error != EXIT_SUCCESS) return error;
-
-  error = pthread_barrier_init(&shared_data->can_continue1, /*attr*/ NULL
-      , shared_data->thread_count);
-  error = pthread_barrier_init(&shared_data->can_continue2, /*attr*/ NULL
-    , shared_data->thread_count);
-  if (error != EXIT_SUCCESS) {
-    pthread_mutex_destroy(&shared_data->can_access_equilibrated);
-    return error;
+  shared_data->affinity = affinity;
+  shared_data->placed_matrix = NULL;
+  shared_data->placed_auxiliary = NULL;
+  shared_data->balance = balance;
+  // The static map updates each block at once, as a single chunk
+  const uint64_t cols = plate->plate_matrix->cols;
+  shared_data->chunk_rows = balance == BALANCE_STATIC ? evaluated_rows
+      : cols < STEAL_CHUNK_CELLS ? STEAL_CHUNK_CELLS / cols : 1;
+  shared_data->chunks = NULL;
+  if (balance == BALANCE_STEAL) {
+    shared_data->chunks = (_Atomic uint64_t*) calloc(
+        2 * shared_data->thread_count, sizeof(uint64_t));
+    if (!shared_data->chunks) return EXIT_FAILURE;
+  }
+  if (affinity->count > 0) {
+    // Large allocations are mapped without being touched until copied
+    const size_t size = plate->plate_matrix->rows * plate->plate_matrix->cols
+        * sizeof(double);
+    shared_data->placed_matrix = (double*) malloc(size);
+    shared_data->placed_auxiliary = (double*) malloc(size);
+    if (!shared_data->placed_matrix || !shared_data->placed_auxiliary) {
+      free(shared_data->placed_matrix);
+      free(shared_data->placed_auxiliary);
+      free((void*) shared_data->chunks);
+      return EXIT_FAILURE;
+    }
   }
 
-  return error;
+  init_state_barrier(&shared_data->barrier, shared_data->thread_count);
+  return EXIT_SUCCESS;
 }
 
 private_data_t* init_private_data(void* data) {
@@ -64,6 +84,7 @@ private_data_t* init_private_data(void* data) {
   private_data_t* private_data = (private_data_t*)
       calloc(shared_data->thread_count, sizeof(private_data_t));
   if (private_data) {
+    shared_data->team = private_data;
     uint64_t prev_finish_row = 1;  // Initialize in 1, as row 0 is not evaluated
     for (uint64_t thread_number = 0; thread_number < shared_data->thread_count;
         ++thread_number) {
@@ -72,8 +93,19 @@ private_data_t* init_private_data(void* data) {
       private_data[thread_number].finish_row = get_finish_row(thread_number + 1
           , evaluated_rows, shared_data->thread_count) + 1;
       prev_finish_row = private_data[thread_number].finish_row;
+      private_data[thread_number].thread_number = thread_number;
       private_data[thread_number].equilibrated = true;
       private_data[thread_number].shared_data = data;
+      const uint64_t block_rows = private_data[thread_number].finish_row
+          - private_data[thread_number].starting_row;
+      private_data[thread_number].block_chunks = (block_rows
+          + shared_data->chunk_rows - 1) / shared_data->chunk_rows;
+      if (shared_data->chunks) {
+        // The first state takes its chunks from the odd half
+        atomic_init(&shared_data->chunks[shared_data->thread_count
+            + thread_number], private_data[thread_number].block_chunks);
+        atomic_init(&shared_data->chunks[thread_number], 0);
+      }
     }
   }
   return private_data;
@@ -87,41 +119,77 @@ uint64_t get_finish_row(size_t thread_number, uint64_t evaluated_rows
   return thread_number * (evaluated_rows / thread_count) + added;
 }
 
-// MODIFIED FROM IN-CLASS EXAMPLE
-int create_threads(void*(*routine)(void*), void* data) {
-  private_data_t* private_data = (private_data_t*) data;
-  shared_data_t* shared_data = (shared_data_t*) private_data[0].shared_data;
-  for (size_t index = 0; index < shared_data->thread_count; ++index) {
-    if (pthread_create(&private_data[index].thread_id, NULL, routine
-      , &private_data[index]) != 0) {
-      fprintf(stderr, "Error: could not create thread %zu\n", index);
-      join_threads(index, private_data);
-      return ERR_CREATE_THREAD;
-    }
+void place_thread_rows(private_data_t* private_data) {
+  shared_data_t* shared_data = private_data->shared_data;
+  plate_matrix_t* plate_matrix = shared_data->plate_matrix;
+  const affinity_t* affinity = shared_data->affinity;
+  const uint64_t thread_number = private_data->thread_number;
+
+  const int cpu = affinity->cpus[thread_number % affinity->count];
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu, &cpus);
+  // Thread simply runs unpinned if it could not be pinned
+  if (sched_setaffinity(/*calling thread*/ 0, sizeof(cpu_set_t), &cpus)
+      != 0) {
+    fprintf(stderr, "Error: Could not pin thread %" PRIu64 " to CPU %d\n"
+        , thread_number, cpu);
   }
-  return EXIT_SUCCESS;
-}
 
-// MODIFIED FROM IN-CLASS EXAMPLE
-int join_threads(const size_t count, private_data_t* private_data) {
-  shared_data_t* shared_data = private_data[0].shared_data;
+  // Border rows are placed with the first and last blocks
+  const uint64_t first_row = thread_number == 0 ? 0
+      : private_data->starting_row;
+  const uint64_t finish_row = thread_number == shared_data->thread_count - 1 ?
+      plate_matrix->rows : private_data->finish_row;
+  const size_t first_cell = first_row * plate_matrix->cols;
+  const size_t size = (finish_row - first_row) * plate_matrix->cols
+      * sizeof(double);
+  memcpy(shared_data->placed_matrix + first_cell
+      , plate_matrix->matrix + first_cell, size);
+  memcpy(shared_data->placed_auxiliary + first_cell
+      , plate_matrix->auxiliary_matrix + first_cell, size);
+
+  // Matrices are replaced once no thread is copying them
+  state_barrier_wait(&shared_data->barrier, /*equilibrated*/ true
+      , replace_placed_matrices, shared_data);
+}
 
-  int error_count = 0;
-  for (size_t index = 0; index < count; ++index) {
-    const int error = pthread_join(private_data[index].thread_id, NULL);
-    if (error) {
-      pthread_mutex_destroy(&shared_data->can_access_equilibrated);
-      pthread_barrier_destroy(&shared_data->can_continue1);
-      pthread_barrier_destroy(&shared_data->can_continue2);
+void replace_placed_matrices(void* data, bool equilibrated) {
+  (void) equilibrated;
+  shared_data_t* shared_data = (shared_data_t*) data;
+  plate_matrix_t* plate_matrix = shared_data->plate_matrix;
+  free(plate_matrix->matrix);
+  free(plate_matrix->auxiliary_matrix);
+  plate_matrix->matrix = shared_data->placed_matrix;
+  plate_matrix->auxiliary_matrix = shared_data->placed_auxiliary;
+}
 
-      fprintf(stderr, "Error: could not join thread %zu\n", index);
-      ++error_count;
+bool take_chunk(_Atomic uint64_t* chunks, bool from_tail, uint64_t* chunk) {
+  // Blocks have far less than 2^32 chunks, so both ends fit in a word and
+  // the owner and thieves agree on the chunks left with a single CAS
+  uint64_t left = atomic_load_explicit(chunks, memory_order_relaxed);
+  while (true) {
+    const uint64_t head = left >> 32;
+    const uint64_t tail = left & UINT32_MAX;
+    if (head >= tail) return false;
+    const uint64_t taken = from_tail ? left - 1 : left + ((uint64_t) 1 << 32);
+    if (atomic_compare_exchange_weak_explicit(chunks, &left, taken
+        , memory_order_relaxed, memory_order_relaxed)) {
+      *chunk = from_tail ? tail - 1 : head;
+      return true;
     }
   }
+}
 
-  pthread_mutex_destroy(&shared_data->can_access_equilibrated);
-  pthread_barrier_destroy(&shared_data->can_continue1);
-  pthread_barrier_destroy(&shared_data->can_continue2);
-
-  return error_count;
+void report_balance(size_t plate_number, const private_data_t* team) {
+  const shared_data_t* shared_data = team[0].shared_data;
+  for (uint64_t thread = 0; thread < shared_data->thread_count; ++thread) {
+    const private_data_t* balance = team + thread;
+    const double seconds = balance->busy_seconds + balance->idle_seconds;
+    printf("Plate %zu: thread %" PRIu64 " busy %.6lfs, idle %.6lfs (%.1lf%%)"
+        ", %" PRIu64 " rows stolen\n", plate_number, thread
+        , balance->busy_seconds, balance->idle_seconds
+        , seconds > 0 ? 100.0 * balance->idle_seconds / seconds : 0
+        , balance->stolen_rows);
+  }
 }
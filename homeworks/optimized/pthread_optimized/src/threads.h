@@ -9,45 +9,91 @@
 
 #include <inttypes.h>
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdio.h>
 
+#include "barrier.h"
 #include "errors.h"
 #include "plate.h"
 #include "plate_matrix.h"
 
+/** @brief Maximum amount of CPUs in an affinity list. */
+#define MAX_AFFINITY_CPUS 1024
+
+/**
+ * @brief Cells of the rows a thread takes at once from a block, rounded to
+ * whole rows and at least one.
+ */
+#define STEAL_CHUNK_CELLS 16384
+
+/**
+ * @struct affinity_t
+ * @brief CPUs the threads are pinned to in NUMA mode.
+ */
+typedef struct affinity {
+  uint64_t count;                    /**< CPUs in list, 0 disables NUMA mode */
+  uint16_t cpus[MAX_AFFINITY_CPUS];  /**< CPU of each thread, cyclically */
+} affinity_t;
+
+/**
+ * @enum balance_t
+ * @brief Ways the rows of a plate are balanced among threads.
+ */
+typedef enum balance {
+  BALANCE_STATIC,  /**< Static map by blocks, the same every state */
+  BALANCE_STEAL    /**< Blocks kept, idle threads steal from their tails */
+} balance_t;
+
 typedef struct shared_data {
   plate_matrix_t* plate_matrix; /**< Plate matrix being equilibrated */
   uint64_t thread_count;        /**< Total amount of threads */
   double mult_constant;         /**< Constant in new temp formula */
   double epsilon;               /**< Epsilon associated to the plate */
-  bool equilibrated_plate;      /**< True if plate was equilibrated */
-  pthread_mutex_t can_access_equilibrated; /**< Controls access to flag */
-  pthread_barrier_t can_continue1;  /**< First barrier */
-  pthread_barrier_t can_continue2;  /**< Second barrier */
+  state_barrier_t barrier;      /**< Ends each state, reducing equilibrium */
   uint64_t k_states;              /**< The amount of states iterated */
+  const affinity_t* affinity;     /**< CPUs to pin threads to */
+  double* placed_matrix;          /**< Matrix first touched by the threads */
+  double* placed_auxiliary;       /**< Auxiliary first touched by threads */
+  balance_t balance;              /**< Way rows are balanced among threads */
+  uint64_t chunk_rows;            /**< Rows taken at once from a block */
+  _Atomic uint64_t* chunks;       /**< Chunks left in each block, head in
+                                       the upper 32 bits and tail in the
+                                       lower ones, twice, for even and odd
+                                       states, NULL if not stealing */
+  struct private_data* team;      /**< Private data of each thread */
 } shared_data_t;
 
 typedef struct private_data {
-  pthread_t thread_id;         /**< POSIX thread ID. */
   uint64_t starting_row;       /**< Index of the first row assigned to thread */
   uint64_t finish_row;         /**< Index of the last row assigned to thread */
+  uint64_t thread_number;      /**< Index of the thread in its team */
   bool equilibrated;           /**< Indicates if section reached equilibrium */
   shared_data_t* shared_data;  /**< Pointer to the shared data structure. */
+  uint64_t block_chunks;       /**< Chunks the rows of the thread are in */
+  uint64_t state;              /**< States the thread started in this plate */
+  double busy_seconds;         /**< Seconds updating rows, stolen included,
+                                    only when stealing */
+  double idle_seconds;         /**< Seconds waiting at the barrier, only when
+                                    stealing */
+  uint64_t stolen_rows;        /**< Rows taken from the tails of other blocks */
 } private_data_t;
 
 /**
  * @brief Initializes a shared data struct
  *
  * This procedure sets up a shared data struct by initializing values
- * and concurrency control tools.
+ * and concurrency control tools. The plate gets the requested threads, but
+ * no more than its evaluated rows.
  *
  * @param shared_data The shared data struct to initialize
  * @param plate Plate to equilibrate, with important information for the struct
  * @param thread_count Amount of threads requested from args.
+ * @param affinity CPUs to pin threads to, with no CPUs to leave them unpinned
+ * @param balance Way rows are balanced among threads
  * @return Success or failure of the intialization.
  */
 int init_shared_data(shared_data_t* shared_data, plate_t* plate
-    , uint64_t thread_count);
+    , uint64_t thread_count, const affinity_t* affinity, balance_t balance);
 
 /**
  * @brief Initializes an array of private_data_t structures.
@@ -55,7 +101,7 @@ int init_shared_data(shared_data_t* shared_data, plate_t* plate
  * This function sets up the private data for each thread based on
  * the number of rows in the matrix and the desired thread count.
  * It evenly divides the work among threads and sets starting and ending
- * row indices accordingly.
+ * row indices accordingly, and the chunks of the first state when stealing.
  *
  * @param data  A pointer to the shared_data_t structure.
  * @return A pointer to an array of initialized private_data_t structures,
@@ -64,28 +110,39 @@ int init_shared_data(shared_data_t* shared_data, plate_t* plate
 private_data_t* init_private_data(void* data);
 
 /**
- * @brief Creates and starts threads using the specified routine.
+ * @brief Pins the calling thread and moves its rows to memory it touches
+ * first, so they are paged on the thread's NUMA node.
  *
- * Iterates through each thread and assigns it the routine and data
- * to execute. On failure, it joins already created threads and returns
- * an error code.
+ * Each thread copies its block of rows, the same static map by blocks used
+ * to update them, into matrices not touched before. The first and last
+ * threads also copy the border rows. Once all threads copied their blocks,
+ * the last one to arrive at the barrier replaces the plate matrices by the
+ * placed ones.
  *
- * @param routine The function each thread should execute.
- * @param data    A pointer to the private_data_t array.
- * @return EXIT_SUCCESS on success, ERR_CREATE_THREAD on failure.
+ * @param private_data Data of the calling thread
  */
-int create_threads(void* (*routine)(void*), void* data);
+void place_thread_rows(private_data_t* private_data);
 
 /**
- * @brief Joins a given number of threads and updates equilibrium status.
+ * @brief Takes a chunk from the head or the tail of a block.
  *
- * Waits for all threads to complete. Checks if all threads reached
- * equilibrium and updates the status accordingly.
+ * The owner of a block takes its chunks from the head, and threads that
+ * finished their own blocks take them from the tail. Both ends are in the
+ * same word, so each chunk is taken by a single thread without locks.
  *
- * @param count               The number of threads to join.
- * @param private_data        A pointer to the array of private_data_t.
- * @return The number of errors encountered while joining threads.
+ * @param chunks Chunks left in the block
+ * @param from_tail True to take the last chunk, false for the first one
+ * @param chunk Where the number of the chunk taken is stored
+ * @return True if a chunk was taken, false if none was left.
+ */
+bool take_chunk(_Atomic uint64_t* chunks, bool from_tail, uint64_t* chunk);
+
+/**
+ * @brief Prints the busy and idle seconds and stolen rows of each thread of
+ * a team.
+ * @param plate_number Number of the plate in the job
+ * @param team Private data of each member of the team
  */
-int join_threads(const size_t count, private_data_t* private_data);
+void report_balance(size_t plate_number, const private_data_t* team);
 
 #endif  // THREADS_H
@@ -0,0 +1,336 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include "generator.h"
+
+#include <string.h>
+
+/**
+ * @struct point_t
+ * @brief Place of a point source.
+ */
+typedef struct {
+  uint64_t row;  ///< Row of the point
+  uint64_t col;  ///< Column of the point
+} point_t;
+
+/// @brief Checks if the name of an argument (before '=') is an option's
+bool is_option(const char* argument, size_t name_length, const char* name);
+
+/// @brief Parses an unsigned integer, rejecting empty or signed values and
+/// trailing characters
+int parse_unsigned(const char* value, uint64_t* result);
+
+/// @brief Parses a positive real number, rejecting trailing characters
+int parse_positive_real(const char* value, double* result);
+
+/**
+ * @brief Random number of a seed and an index, by mixing both with
+ * SplitMix64. Independent of the order numbers are asked in, so rows can be
+ * generated one at a time, and the same in any C library.
+ */
+uint64_t get_random(uint64_t seed, uint64_t index);
+
+/// @brief Random real number in [0, 1) of a seed and an index
+double get_random_unit(uint64_t seed, uint64_t index);
+
+/// @brief Temperature of a border cell of the plate
+double get_border_temperature(const generator_t* generator, uint64_t row
+    , uint64_t col);
+
+/// @brief Sorts point sources by row, and then by column
+int compare_points(const void* first, const void* second);
+
+/**
+ * @brief Places the point sources of the plate, sorted by row.
+ * @return The points, or NULL if out of memory. An empty array if the
+ * pattern has none.
+ */
+point_t* place_points(const generator_t* generator, uint64_t* point_count);
+
+/**
+ * @brief Sets the temperatures of a row of the plate.
+ * @param generator Plate being generated
+ * @param row Row to set
+ * @param temperatures Temperature of each column
+ * @param points Point sources, sorted by row
+ * @param point_count Amount of point sources
+ * @param next_point First point source not in the previous rows, updated
+ */
+void generate_row(const generator_t* generator, uint64_t row
+    , double* temperatures, const point_t* points, uint64_t point_count
+    , uint64_t* next_point);
+
+void init_generator(generator_t* generator) {
+  generator->rows = 0;
+  generator->cols = 0;
+  generator->pattern = PATTERN_UNIFORM;
+  generator->plate_file = NULL;
+  generator->seed = 1;
+  generator->point_count = 4;
+  generator->job_file = NULL;
+  generator->interval = 1200;
+  generator->diffusivity = 127;
+  generator->dimension = 1000;
+  generator->epsilon = 2;
+  generator->ratio = 0.1;
+  generator->ladder = 1;
+}
+
+int parse_pattern(const char* name, pattern_t* pattern) {
+  if (strcmp(name, "uniform") == 0) {
+    *pattern = PATTERN_UNIFORM;
+  } else if (strcmp(name, "top") == 0) {
+    *pattern = PATTERN_TOP;
+  } else if (strcmp(name, "gradient") == 0) {
+    *pattern = PATTERN_GRADIENT;
+  } else if (strcmp(name, "random") == 0) {
+    *pattern = PATTERN_RANDOM;
+  } else if (strcmp(name, "points") == 0) {
+    *pattern = PATTERN_POINTS;
+  } else {
+    return ERR_INVALID_PATTERN;
+  }
+  return EXIT_SUCCESS;
+}
+
+int set_generator_option(generator_t* generator, const char* argument) {
+  // Split option name from its value, if there is one
+  const char* equals = strchr(argument, '=');
+  const char* value = equals ? equals + 1 : "";
+  size_t name_length = equals ? (size_t) (equals - argument)
+      : strlen(argument);
+
+  // Every option has a value, so a missing one is an empty value
+  int error = ERR_INVALID_OPTION;
+  if (is_option(argument, name_length, "--seed")) {
+    error = parse_unsigned(value, &generator->seed);
+  } else if (is_option(argument, name_length, "--points")) {
+    error = parse_unsigned(value, &generator->point_count);
+  } else if (is_option(argument, name_length, "--job")) {
+    generator->job_file = value;
+    error = value[0] ? EXIT_SUCCESS : ERR_INVALID_OPTION;
+  } else if (is_option(argument, name_length, "--interval")) {
+    error = parse_unsigned(value, &generator->interval);
+  } else if (is_option(argument, name_length, "--diffusivity")) {
+    error = parse_positive_real(value, &generator->diffusivity);
+  } else if (is_option(argument, name_length, "--dimension")) {
+    error = parse_positive_real(value, &generator->dimension);
+  } else if (is_option(argument, name_length, "--epsilon")) {
+    error = parse_positive_real(value, &generator->epsilon);
+  } else if (is_option(argument, name_length, "--ratio")) {
+    error = parse_positive_real(value, &generator->ratio);
+  } else if (is_option(argument, name_length, "--ladder")) {
+    error = parse_unsigned(value, &generator->ladder);
+    if (error == EXIT_SUCCESS && generator->ladder == 0) {
+      error = ERR_INVALID_OPTION;
+    }
+  }
+
+  if (error != EXIT_SUCCESS) {
+    fprintf(stderr, "Error: Invalid option %s\n", argument);
+  }
+  return error;
+}
+
+bool is_option(const char* argument, size_t name_length, const char* name) {
+  return strlen(name) == name_length
+      && strncmp(argument, name, name_length) == 0;
+}
+
+int parse_unsigned(const char* value, uint64_t* result) {
+  uint64_t parsed = 0;
+  char extra = '\0';
+  if (value[0] < '0' || value[0] > '9'
+      || sscanf(value, "%" SCNu64 "%c", &parsed, &extra) != 1) {
+    return ERR_INVALID_OPTION;
+  }
+  *result = parsed;
+  return EXIT_SUCCESS;
+}
+
+int parse_positive_real(const char* value, double* result) {
+  double parsed = 0;
+  char extra = '\0';
+  if (sscanf(value, "%lg%c", &parsed, &extra) != 1 || !(parsed > 0)) {
+    return ERR_INVALID_OPTION;
+  }
+  *result = parsed;
+  return EXIT_SUCCESS;
+}
+
+uint64_t get_random(uint64_t seed, uint64_t index) {
+  uint64_t mixed = seed + (index + 1) * 0x9E3779B97F4A7C15ull;
+  mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+  mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+  return mixed ^ (mixed >> 31);
+}
+
+double get_random_unit(uint64_t seed, uint64_t index) {
+  // The 53 bits of a double's mantissa
+  return (double) (get_random(seed, index) >> 11) * 0x1.0p-53;
+}
+
+double get_border_temperature(const generator_t* generator, uint64_t row
+    , uint64_t col) {
+  const uint64_t rows = generator->rows;
+  const uint64_t cols = generator->cols;
+  switch (generator->pattern) {
+    case PATTERN_UNIFORM:
+      return HOT_TEMPERATURE;
+    case PATTERN_TOP:
+      return row == 0 ? HOT_TEMPERATURE : COLD_TEMPERATURE;
+    case PATTERN_GRADIENT: {
+      // Position of the cell walking the border clockwise
+      const uint64_t perimeter = 2 * (rows + cols) - 4;
+      uint64_t position = 0;
+      if (row == 0) {
+        position = col;
+      } else if (col == cols - 1) {
+        position = cols - 1 + row;
+      } else if (row == rows - 1) {
+        position = cols + rows - 2 + (cols - 1 - col);
+      } else {
+        position = 2 * cols + rows - 3 + (rows - 1 - row);
+      }
+      return COLD_TEMPERATURE + (HOT_TEMPERATURE - COLD_TEMPERATURE)
+          * (double) position / (double) (perimeter - 1);
+    }
+    case PATTERN_RANDOM:
+      return COLD_TEMPERATURE + (HOT_TEMPERATURE - COLD_TEMPERATURE)
+          * get_random_unit(generator->seed, row * cols + col);
+    default:
+      return COLD_TEMPERATURE;
+  }
+}
+
+int compare_points(const void* first, const void* second) {
+  const point_t* first_point = (const point_t*) first;
+  const point_t* second_point = (const point_t*) second;
+  if (first_point->row != second_point->row) {
+    return first_point->row < second_point->row ? -1 : 1;
+  }
+  if (first_point->col != second_point->col) {
+    return first_point->col < second_point->col ? -1 : 1;
+  }
+  return 0;
+}
+
+point_t* place_points(const generator_t* generator, uint64_t* point_count) {
+  *point_count = generator->pattern == PATTERN_POINTS ?
+      generator->point_count : 0;
+  // One more, so there is an array to free without points
+  point_t* points = (point_t*) calloc(*point_count + 1, sizeof(point_t));
+  if (!points) return NULL;
+
+  const uint64_t interior_rows = generator->rows - 2;
+  const uint64_t interior_cols = generator->cols - 2;
+  for (uint64_t point = 0; point < *point_count; ++point) {
+    points[point].row = 1 + get_random(generator->seed, 2 * point)
+        % interior_rows;
+    points[point].col = 1 + get_random(generator->seed, 2 * point + 1)
+        % interior_cols;
+  }
+  qsort(points, *point_count, sizeof(point_t), compare_points);
+  return points;
+}
+
+void generate_row(const generator_t* generator, uint64_t row
+    , double* temperatures, const point_t* points, uint64_t point_count
+    , uint64_t* next_point) {
+  const uint64_t cols = generator->cols;
+  if (row == 0 || row == generator->rows - 1) {
+    for (uint64_t col = 0; col < cols; ++col) {
+      temperatures[col] = get_border_temperature(generator, row, col);
+    }
+    return;
+  }
+
+  temperatures[0] = get_border_temperature(generator, row, 0);
+  for (uint64_t col = 1; col < cols - 1; ++col) {
+    temperatures[col] = COLD_TEMPERATURE;
+  }
+  temperatures[cols - 1] = get_border_temperature(generator, row, cols - 1);
+
+  // Points are sorted, so the ones of this row are the next ones
+  while (*next_point < point_count && points[*next_point].row == row) {
+    temperatures[points[*next_point].col] = HOT_TEMPERATURE;
+    ++*next_point;
+  }
+}
+
+int write_plate(const generator_t* generator) {
+  uint64_t point_count = 0;
+  point_t* points = place_points(generator, &point_count);
+  double* temperatures = (double*) malloc(generator->cols * sizeof(double));
+  if (!points || !temperatures) {
+    fprintf(stderr, "Error: Memory for plate could not be allocated\n");
+    free(points);
+    free(temperatures);
+    return ERR_PLATE_ALLOC;
+  }
+
+  FILE* plate_file = fopen(generator->plate_file, "wb");
+  if (!plate_file) {
+    fprintf(stderr, "Error: Plate file %s could not be opened\n"
+        , generator->plate_file);
+    free(points);
+    free(temperatures);
+    return ERR_OPEN_PLATE_FILE;
+  }
+  setvbuf(plate_file, NULL, _IOFBF, PLATE_BUFFER_SIZE);
+
+  int error = EXIT_SUCCESS;
+  if (fwrite(&generator->rows, sizeof(uint64_t), 1, plate_file) != 1
+      || fwrite(&generator->cols, sizeof(uint64_t), 1, plate_file) != 1) {
+    error = ERR_WRITE_PLATE_FILE;
+  }
+  uint64_t next_point = 0;
+  for (uint64_t row = 0; error == EXIT_SUCCESS && row < generator->rows;
+      ++row) {
+    generate_row(generator, row, temperatures, points, point_count
+        , &next_point);
+    if (fwrite(temperatures, sizeof(double), generator->cols, plate_file)
+        != generator->cols) {
+      error = ERR_WRITE_PLATE_FILE;
+    }
+  }
+  if (fclose(plate_file) != 0) error = ERR_WRITE_PLATE_FILE;
+  if (error != EXIT_SUCCESS) {
+    fprintf(stderr, "Error: Could not write plate file %s\n"
+        , generator->plate_file);
+  }
+
+  free(points);
+  free(temperatures);
+  return error;
+}
+
+int write_job(const generator_t* generator) {
+  FILE* job_file = fopen(generator->job_file, "w");
+  if (!job_file) {
+    fprintf(stderr, "Error: Job file %s could not be opened\n"
+        , generator->job_file);
+    return ERR_WRITE_JOB_FILE;
+  }
+
+  // Plates are looked for in the directory of the job
+  const char* slash = strrchr(generator->plate_file, '/');
+  const char* plate_name = slash ? slash + 1 : generator->plate_file;
+  double epsilon = generator->epsilon;
+  int error = EXIT_SUCCESS;
+  for (uint64_t line = 0; line < generator->ladder; ++line) {
+    if (fprintf(job_file, "%s\t%" PRIu64 "\t%.9g\t%.9g\t%.9g\n", plate_name
+        , generator->interval, generator->diffusivity, generator->dimension
+        , epsilon) < 0) {
+      error = ERR_WRITE_JOB_FILE;
+      break;
+    }
+    epsilon *= generator->ratio;
+  }
+  if (fclose(job_file) != 0) error = ERR_WRITE_JOB_FILE;
+  if (error != EXIT_SUCCESS) {
+    fprintf(stderr, "Error: Could not write job file %s\n"
+        , generator->job_file);
+  }
+  return error;
+}
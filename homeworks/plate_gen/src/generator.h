@@ -0,0 +1,111 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/** @brief Temperature of the hottest border cells and point sources */
+#define HOT_TEMPERATURE 100.0
+/** @brief Temperature of the interior, and of the coldest border cells */
+#define COLD_TEMPERATURE 0.0
+/** @brief Bytes buffered by the plate file, rows are written through it */
+#define PLATE_BUFFER_SIZE (1 << 20)
+
+enum {
+  ERR_USAGE = EXIT_FAILURE + 1,
+  ERR_INVALID_SIZE,
+  ERR_INVALID_PATTERN,
+  ERR_INVALID_OPTION,
+  ERR_PLATE_ALLOC,
+  ERR_OPEN_PLATE_FILE,
+  ERR_WRITE_PLATE_FILE,
+  ERR_WRITE_JOB_FILE
+};
+
+/**
+ * @brief Temperatures of the border, and of the interior for point sources.
+ *
+ * uniform: every border cell is hot.
+ * top: the top row is a hot edge, the rest of the border is cold.
+ * gradient: temperature grows from cold to hot around the border, clockwise
+ * from the top left corner, so every border cell has a different one.
+ * random: every border cell has a random temperature between cold and hot.
+ * points: a cold border, and hot cells at random places of the interior.
+ */
+typedef enum {
+  PATTERN_UNIFORM,
+  PATTERN_TOP,
+  PATTERN_GRADIENT,
+  PATTERN_RANDOM,
+  PATTERN_POINTS
+} pattern_t;
+
+/**
+ * @struct generator_t
+ * @brief Plate and job file to generate.
+ */
+typedef struct {
+  uint64_t rows;              ///< Rows of the plate
+  uint64_t cols;              ///< Columns of the plate
+  pattern_t pattern;          ///< Temperatures of the plate
+  const char* plate_file;     ///< Path of the plate file
+  uint64_t seed;              ///< Seed of random temperatures and places
+  uint64_t point_count;       ///< Hot cells of the points pattern
+  const char* job_file;       ///< Path of the job file, NULL for none
+  uint64_t interval;          ///< Duration of a state of the job
+  double diffusivity;         ///< Thermal diffusivity of the job
+  double dimension;           ///< Cell dimension of the job
+  double epsilon;             ///< Largest epsilon of the job
+  double ratio;               ///< Ratio between consecutive epsilons
+  uint64_t ladder;            ///< Lines of the job, each with an epsilon
+} generator_t;
+
+/**
+ * @brief Sets the defaults of the options: seed 1, 4 point sources, and a
+ * job of a single line with the interval, diffusivity, dimension and
+ * largest epsilon of job001, where epsilons decrease 10 times per line.
+ * @param generator Generator to initialize
+ */
+void init_generator(generator_t* generator);
+
+/**
+ * @brief Parses a pattern name into a pattern_t.
+ * @return EXIT_SUCCESS on success, ERR_INVALID_PATTERN otherwise.
+ */
+int parse_pattern(const char* name, pattern_t* pattern);
+
+/**
+ * @brief Sets an option given as --name=value in the command line:
+ * --seed, --points, --job, --interval, --diffusivity, --dimension,
+ * --epsilon, --ratio and --ladder.
+ * @param generator Generator to set the option of
+ * @param argument Argument as given in the command line
+ * @return EXIT_SUCCESS on success, ERR_INVALID_OPTION otherwise.
+ */
+int set_generator_option(generator_t* generator, const char* argument);
+
+/**
+ * @brief Writes the plate file in the binary format of the simulators.
+ *
+ * The plate is generated and written a row at a time, so a plate of any
+ * size only takes the memory of a row and the point sources. The same seed
+ * always generates the same plate.
+ *
+ * @param generator Plate to generate
+ * @return EXIT_SUCCESS on success, an error code otherwise.
+ */
+int write_plate(const generator_t* generator);
+
+/**
+ * @brief Writes a job with a line per epsilon of the ladder, all of them
+ * for the plate, which must be in the directory of the job.
+ * @param generator Job to generate
+ * @return EXIT_SUCCESS on success, ERR_WRITE_JOB_FILE otherwise.
+ */
+int write_job(const generator_t* generator);
+
+#endif  // GENERATOR_H
@@ -0,0 +1,61 @@
+// Copyright 2025 Evan Chen Cheng <evan.chen@ucr.ac.cr>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "generator.h"
+
+/**
+ * @brief Analyzes the arguments: rows, columns, pattern and plate file,
+ * followed by options.
+ * @return EXIT_SUCCESS if valid, an error code otherwise.
+ */
+int analyze_arguments(int argc, char* argv[], generator_t* generator);
+
+/**
+ * @brief Generates a synthetic plate file, and a job file for it.
+ * usage: bin/plate_gen rows cols pattern plate_file [options]
+ * @return EXIT_SUCCESS on success, an error code otherwise.
+ */
+int main(int argc, char* argv[]) {
+  generator_t generator;
+  init_generator(&generator);
+  int error = analyze_arguments(argc, argv, &generator);
+  if (error == EXIT_SUCCESS) error = write_plate(&generator);
+  if (error == EXIT_SUCCESS && generator.job_file) {
+    error = write_job(&generator);
+  }
+  return error;
+}
+
+int analyze_arguments(int argc, char* argv[], generator_t* generator) {
+  if (argc < 5) {
+    fprintf(stderr, "usage: bin/plate_gen rows cols pattern plate_file"
+        " [--seed=N] [--points=N] [--job=job_file] [--interval=N]"
+        " [--diffusivity=R] [--dimension=R] [--epsilon=R] [--ratio=R]"
+        " [--ladder=N]\n"
+        "patterns: uniform top gradient random points\n");
+    return ERR_USAGE;
+  }
+
+  char extra = '\0';
+  if (sscanf(argv[1], "%" SCNu64 "%c", &generator->rows, &extra) != 1
+      || sscanf(argv[2], "%" SCNu64 "%c", &generator->cols, &extra) != 1
+      || argv[1][0] == '-' || argv[2][0] == '-' || generator->rows < 3
+      || generator->cols < 3) {
+    fprintf(stderr, "Error: Invalid plate size (at least 3 x 3)\n");
+    return ERR_INVALID_SIZE;
+  }
+  if (parse_pattern(argv[3], &generator->pattern) != EXIT_SUCCESS) {
+    fprintf(stderr, "Error: Invalid pattern %s\n", argv[3]);
+    return ERR_INVALID_PATTERN;
+  }
+  generator->plate_file = argv[4];
+
+  for (int index = 5; index < argc; ++index) {
+    const int error = set_generator_option(generator, argv[index]);
+    if (error != EXIT_SUCCESS) return error;
+  }
+  return EXIT_SUCCESS;
+}
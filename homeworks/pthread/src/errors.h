@@ -7,7 +7,8 @@
 
 enum {
   ERR_NO_JOB_FILE = EXIT_FAILURE + 1,
-  ERR_INVALID_THREAD_COUNT
+  ERR_INVALID_THREAD_COUNT,
+  ERR_INVALID_CHECK_STATES
 };
 
 // JOB RELATED
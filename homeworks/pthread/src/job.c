@@ -4,12 +4,14 @@
 
 // ***[SIMULATION RELATED]***
 
-int simulate(char* job_file_path, uint64_t thread_count) {
+int simulate(char* job_file_path, uint64_t thread_count
+    , uint64_t check_states) {
   int error = EXIT_SUCCESS;
 
   // Create job struct
   job_t* job = init_job(job_file_path);
   if (!job) return ERR_JOB_INIT;
+  job->check_states = check_states;
 
   // Set the struct with necessary information
   error = set_job(job);
@@ -93,7 +95,7 @@ int equilibrate_plate(job_t* job, size_t plate_number, uint64_t thread_count) {
   double mult_constant = diff_times_interval / cell_area;
 
   shared_data_t shared_data = {curr_plate->plate_matrix, thread_count
-      , mult_constant, curr_plate->epsilon};
+      , mult_constant, curr_plate->epsilon, true};
   private_data_t* thread_team = init_private_data(thread_count, &shared_data);
 
   if (!thread_team) {
@@ -102,15 +104,58 @@ int equilibrate_plate(job_t* job, size_t plate_number, uint64_t thread_count) {
     return ERR_CREATE_THREAD_TEAM;
   }
 
+  // The maximum change may grow in unstable plates
+  const uint64_t fixed_states = mult_constant > 0.25 ? 1 : job->check_states;
+  plate_matrix_t* plate_matrix = curr_plate->plate_matrix;
+  // State each run of states starts from, to simulate it again
+  double** run_start = fixed_states == 1 ? NULL
+      : create_double_matrix(plate_matrix->rows, plate_matrix->cols);
+  if (fixed_states != 1 && !run_start) {
+    fprintf(stderr, "Error: Could not allocate the states of plate %zu"
+        , plate_number);
+    free(thread_team);
+    return ERR_PLATE_ALLOC;
+  }
+
+  uint64_t check_states = fixed_states ? fixed_states : 1;
+  double previous_delta = 0;
   //  while not reached_equilibrium do
   while (!reached_equilibrium) {
-    set_auxiliary(curr_plate->plate_matrix);
-    int errors = create_threads(equilibrate_rows, thread_team);
+    if (run_start) {
+      copy_double_matrix(run_start, plate_matrix->matrix, plate_matrix->rows
+          , plate_matrix->cols);
+    }
+    int errors = simulate_states(plate_matrix, &shared_data, thread_team
+        , check_states, &reached_equilibrium);
     if (errors > 0) return errors;
-    reached_equilibrium = true;
-    join_threads(shared_data.thread_count, thread_team, &reached_equilibrium);
-    ++k_states;
+    k_states += check_states;
+
+    if (reached_equilibrium && check_states > 1) {
+      // Equilibrated at or before the check, simulate the run again checking
+      // every state to stop at the first one within epsilon
+      copy_double_matrix(plate_matrix->matrix, run_start, plate_matrix->rows
+          , plate_matrix->cols);
+      k_states -= check_states;
+      reached_equilibrium = false;
+      while (!reached_equilibrium) {
+        errors = simulate_states(plate_matrix, &shared_data, thread_team, 1
+            , &reached_equilibrium);
+        if (errors > 0) return errors;
+        ++k_states;
+      }
+    } else if (!reached_equilibrium) {
+      double delta = 0;
+      for (size_t index = 0; index < shared_data.thread_count; ++index) {
+        if (thread_team[index].max_delta > delta) {
+          delta = thread_team[index].max_delta;
+        }
+      }
+      check_states = fixed_states ? fixed_states : choose_check_states(
+          check_states, delta, previous_delta, curr_plate->epsilon);
+      previous_delta = delta;
+    }
   }  //  end while
+  if (run_start) destroy_double_matrix(run_start, plate_matrix->rows);
   free(thread_team);
 
   // Store k, number of states iterated until equilibrium, in plate
@@ -118,6 +163,19 @@ int equilibrate_plate(job_t* job, size_t plate_number, uint64_t thread_count) {
   return EXIT_SUCCESS;
 }
 
+int simulate_states(plate_matrix_t* plate_matrix, shared_data_t* shared_data
+    , private_data_t* thread_team, uint64_t states, bool* reached_equilibrium) {
+  for (uint64_t state = 1; state <= states; ++state) {
+    set_auxiliary(plate_matrix);
+    shared_data->check = state == states;
+    int errors = create_threads(equilibrate_rows, thread_team);
+    if (errors > 0) return errors;
+    *reached_equilibrium = true;
+    join_threads(shared_data->thread_count, thread_team, reached_equilibrium);
+  }
+  return EXIT_SUCCESS;
+}
+
 int clean_plate(job_t* job, size_t plate_number) {
   plate_t* curr_plate = job->plates[plate_number];
   // Create an updated plate file with final temperatures
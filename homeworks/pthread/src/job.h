@@ -33,6 +33,8 @@ typedef struct {
     size_t plates_count;    /**< Number of plates. */
     size_t plates_capacity; /**< Capacity of plates array. */
     plate_t** plates;       /**< Array of plate pointers. */
+    uint64_t check_states;  /**< States between convergence checks, 0 adapts
+                                 them to how fast plates converge. */
 } job_t;
 
 /**
@@ -40,9 +42,11 @@ typedef struct {
  * 
  * @param job_file_path path of job to simulate
  * @param thread_count amount of threads used to simulate
+ * @param check_states States between convergence checks, 0 to adapt them
  * @return Success or failure of procedure
  */
-int simulate(char* job_file_path, uint64_t thread_count);
+int simulate(char* job_file_path, uint64_t thread_count
+    , uint64_t check_states);
 
 /**
  * @brief Loops through all of the plates recorded to simulate.
@@ -55,6 +59,13 @@ int process_plates(job_t* job, uint64_t thread_count);
 
 /**
  * @brief Equilibrates current plate
+ *
+ * Convergence is checked every job->check_states states. The state a run of
+ * states started from is kept aside, so when a check finds the plate
+ * equilibrated, the run is simulated again checking every state, and the
+ * plate stops at the first state within epsilon. The maximum change never
+ * grows while the constant of the plate is at most 1/4, so no earlier state
+ * is skipped; plates with a greater constant are checked every state.
  * 
  * @param job current working job
  * @param plate_number current plate's index
@@ -63,6 +74,20 @@ int process_plates(job_t* job, uint64_t thread_count);
  */
 int equilibrate_plate(job_t* job, size_t plate_number,  uint64_t thread_count);
 
+/**
+ * @brief Simulates states of a plate with its thread team, checking
+ * convergence only in the last one.
+ *
+ * @param plate_matrix Plate matrix being equilibrated
+ * @param shared_data Shared data of the thread team
+ * @param thread_team Thread team of the plate
+ * @param states States to simulate
+ * @param reached_equilibrium Set to whether the last state is equilibrated
+ * @return Amount of threads that could not be created or joined
+ */
+int simulate_states(plate_matrix_t* plate_matrix, shared_data_t* shared_data
+    , private_data_t* thread_team, uint64_t states, bool* reached_equilibrium);
+
 /// @brief Carries out recording of updated plate and freeing of memory.
 /// @see equilibrate_plates
 /// @return if clean up if successful
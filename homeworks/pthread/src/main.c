@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include "job.h"
@@ -13,9 +14,12 @@
  * @param argc Argument count.
  * @param argv Arguments vector.
  * @param *thread_count POinter to thread_count in main to set.
+ * @param *check_states Pointer to the states between convergence checks in
+ * main to set, 0 for auto.
  * @return Success or failure of arguments analysis.
  */
-int analyze_arguments(int argc, char* argv[], uint64_t* thread_count);
+int analyze_arguments(int argc, char* argv[], uint64_t* thread_count
+    , uint64_t* check_states);
 
 /**
  * @brief Processes execution command to set thread count and 
@@ -27,18 +31,34 @@ int analyze_arguments(int argc, char* argv[], uint64_t* thread_count);
 int main(int argc, char* argv[]) {
   // Assume default amount of threads first
   uint64_t thread_count = sysconf(_SC_NPROCESSORS_ONLN);
+  // Check convergence every state by default
+  uint64_t check_states = 1;
 
-  int error = analyze_arguments(argc, argv, &thread_count);
+  int error = analyze_arguments(argc, argv, &thread_count, &check_states);
 
-  if (error == EXIT_SUCCESS) error = simulate(argv[1], thread_count);
+  if (error == EXIT_SUCCESS) {
+    error = simulate(argv[1], thread_count, check_states);
+  }
 
   return error;
 }
 
-int analyze_arguments(int argc, char* argv[], uint64_t* thread_count) {
+int analyze_arguments(int argc, char* argv[], uint64_t* thread_count
+    , uint64_t* check_states) {
   int error = EXIT_SUCCESS;
+  // States between checks are a positive amount, or auto (0)
+  if (argc == 4) {
+    char extra = '\0';
+    if (strcmp(argv[3], "auto") == 0) {
+      *check_states = 0;
+    } else if (sscanf(argv[3], "%" SCNu64 "%c", check_states, &extra) != 1
+        || *check_states == 0 || argv[3][0] == '-') {
+      fprintf(stderr, "Error: Invalid check states (positive or auto)\n");
+      error = ERR_INVALID_CHECK_STATES;
+    }
+  }
   // Must at least include job directory
-  if (argc == 3) {
+  if (error == EXIT_SUCCESS && argc >= 3) {
     if (sscanf(argv[2], "%zu", thread_count) != 1
         || *thread_count <= 0 || *thread_count > 32000) {
       // Inform usage to user
@@ -49,7 +69,8 @@ int analyze_arguments(int argc, char* argv[], uint64_t* thread_count) {
   } else if (argc < 2) {
     // Inform usage to user
     fprintf(stderr,
-        "usage: bin/pthread job_file_path thread_count (count optional)\n");
+        "usage: bin/pthread job_file_path thread_count check_states"
+        " (count and check states optional)\n");
     error = ERR_NO_JOB_FILE;
   }
   return error;
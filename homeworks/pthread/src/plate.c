@@ -51,6 +51,17 @@ void* equilibrate_rows(void* data) {
   plate_matrix_t* plate_matrix = shared_data->plate_matrix;
   uint64_t starting_row = private_data->starting_row;
   uint64_t ending_row = private_data->ending_row;
+  // States between convergence checks only update the cells
+  if (!shared_data->check) {
+    for (uint64_t row = starting_row; row <= ending_row; ++row) {
+      for (uint64_t col = 1; col < plate_matrix->cols - 1; ++col) {
+        update_cell(plate_matrix, row, col, shared_data->mult_constant);
+      }
+    }
+    return NULL;
+  }
+
+  double max_delta = 0;
   // Only work designated rows
   for (uint64_t row = starting_row; row <= ending_row; ++row) {
     for (uint64_t col = 1; col < plate_matrix->cols - 1; ++col) {
@@ -62,15 +73,31 @@ void* equilibrate_rows(void* data) {
 
       // Compute absolute difference
       double difference = fabs(new_temperature - old_temperature);
-      // Track the maximum temperature change in this update step
-      if (difference > shared_data->epsilon) {
-        private_data->equilibrated = false;
-      }
+      // Track the maximum temperature change in this update step, in a
+      // local variable instead of the flag shared with other threads
+      if (difference > max_delta) max_delta = difference;
     }
   }
+  private_data->max_delta = max_delta;
+  private_data->equilibrated = max_delta <= shared_data->epsilon;
   return NULL;
 }
 
+uint64_t choose_check_states(uint64_t check_states, double delta
+    , double previous_delta, double epsilon) {
+  uint64_t limit = 2 * check_states;
+  if (limit > MAX_CHECK_STATES) limit = MAX_CHECK_STATES;
+  // Without a decay to extrapolate, the next check is farther away
+  if (previous_delta <= 0 || delta <= 0 || delta >= previous_delta) {
+    return limit;
+  }
+  const double decay_per_state = log(delta / previous_delta) / check_states;
+  const double remaining_states = log(epsilon / delta) / decay_per_state;
+  if (remaining_states / 2 < 1) return 1;
+  return remaining_states / 2 < limit ? (uint64_t) (remaining_states / 2)
+      : limit;
+}
+
 
 int update_plate_file(plate_t* plate, char* source_directory) {
   int error = EXIT_SUCCESS;
@@ -15,6 +15,9 @@
 #include "plate_matrix.h"
 #include "threads.h"
 
+/** @brief Most states between two convergence checks in adaptive mode */
+#define MAX_CHECK_STATES 1024
+
 /**
  * @struct plate_t
  * @brief Structure to store plate properties and state.
@@ -50,6 +53,23 @@ int set_plate_matrix(plate_t* plate, char* source_directory);
  */
 void* equilibrate_rows(void* data);
 
+/**
+ * @brief Chooses the states until the next convergence check.
+ *
+ * Assumes the maximum change decays geometrically, at the rate measured
+ * between the last two checks, and checks again at half the states predicted
+ * to reach epsilon, so the states simulated again after the last check are
+ * few. States between checks at most double from one check to the next.
+ *
+ * @param check_states States between the last two checks
+ * @param delta Maximum change at the last check
+ * @param previous_delta Maximum change at the check before, 0 if none
+ * @param epsilon Epsilon of the plate
+ * @return States until the next check, at least 1
+ */
+uint64_t choose_check_states(uint64_t check_states, double delta
+    , double previous_delta, double epsilon);
+
 /**
  * @brief Writes the updated plate matrix to a binary file.
  * 
@@ -3,6 +3,7 @@
 #include "plate_matrix.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 plate_matrix_t* init_plate_matrix(uint64_t rows, uint64_t cols) {
   // Allocate memory for the plate_matrix_t structure
@@ -121,6 +122,16 @@ double** create_double_matrix(const size_t rows, const size_t cols) {
 
 
 
+void copy_double_matrix(double** destination, double** source
+    , const size_t rows, const size_t cols) {
+  // Rows are allocated apart
+  for (size_t row = 0; row < rows; ++row) {
+    memcpy(destination[row], source[row], cols * sizeof(double));
+  }
+}
+
+
+
 void destroy_plate_matrix(plate_matrix_t* plate_matrix) {
   uint64_t rows = plate_matrix->rows;
 
@@ -15,6 +15,7 @@ typedef struct shared_data {
   uint64_t thread_count;        /**< Total amount of threads */
   double mult_constant;         /**< Constant in new temp formula */
   double epsilon;               /**< Epsilon associated to the plate */
+  bool check;                   /**< True to measure changes of this state */
 } shared_data_t;
 
 typedef struct private_data {
@@ -22,6 +23,7 @@ typedef struct private_data {
   uint64_t starting_row;       /**< Index of the first row assigned to thread */
   uint64_t ending_row;         /**< Index of the last row assigned to thread */
   bool equilibrated;           /**< Indicates if section reached equilibrium */
+  double max_delta;            /**< Maximum change of section in last check */
   shared_data_t* shared_data;  /**< Pointer to the shared data structure. */
 } private_data_t;
 
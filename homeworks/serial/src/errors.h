@@ -4,6 +4,7 @@
 #define ERRORS_H
 
 #define NO_JOB_FILE_SPECIFIED 10
+#define INVALID_CHECK_STATES 20
 
 // JOB RELATED
 #define JOB_INIT_FAIL 11
@@ -4,7 +4,8 @@
 
 // ***[SIMULATION RELATED]***
 
-int simulate(char* job_file_path, uint64_t thread_count) {
+int simulate(char* job_file_path, uint64_t thread_count
+    , uint64_t check_states) {
   if (thread_count > 1) {
     printf("Concurrent solution yet to be developed\n");
   }
@@ -13,6 +14,7 @@ int simulate(char* job_file_path, uint64_t thread_count) {
   // Create job struct
   job_t* job = init_job(job_file_path);
   if (!job) return JOB_INIT_FAIL;
+  job->check_states = check_states;
 
   // Set the struct with necessary information
   error = set_job(job);
@@ -62,7 +64,11 @@ int process_plates(job_t* job) {
     struct timespec start_time, finish_time;
     clock_gettime(CLOCK_MONOTONIC, &start_time);
 
-    equilibrate_plate(job, plate_number);
+    error = equilibrate_plate(job, plate_number);
+    if (error != EXIT_SUCCESS) {
+      destroy_job(job);
+      return error;
+    }
 
     // Record end time
     clock_gettime(CLOCK_MONOTONIC, &finish_time);
@@ -80,22 +86,68 @@ int process_plates(job_t* job) {
 
 
 
-void equilibrate_plate(job_t* job, size_t plate_number) {
+int equilibrate_plate(job_t* job, size_t plate_number) {
   plate_t* curr_plate = job->plates[plate_number];
+  plate_matrix_t* plate_matrix = curr_plate->plate_matrix;
   // Loop to simulate the plate's changes in temperature
   uint64_t k_states = 0;
   bool reached_equilibrium = false;
 
+  // The maximum change may grow in unstable plates
+  const uint64_t fixed_states = calculate_mult_constant(curr_plate) > 0.25 ?
+      1 : job->check_states;
+  // State each run of states starts from, to simulate it again
+  double** run_start = fixed_states == 1 ? NULL
+      : create_double_matrix(plate_matrix->rows, plate_matrix->cols);
+  if (fixed_states != 1 && !run_start) {
+    fprintf(stderr, "Error: Could not allocate the states of plate %zu\n"
+        , plate_number);
+    return PLATE_ALLOCATION_FAIL;
+  }
+
+  uint64_t check_states = fixed_states ? fixed_states : 1;
+  double previous_delta = 0;
   //  while not reached_equilibrium do
   while (!reached_equilibrium) {
-    //  update_plate(plate)
-    reached_equilibrium = update_plate(curr_plate);
-
-    ++k_states;
+    if (run_start) {
+      copy_double_matrix(run_start, plate_matrix->matrix, plate_matrix->rows
+          , plate_matrix->cols);
+    }
+    reached_equilibrium = simulate_states(curr_plate, check_states);
+    k_states += check_states;
+
+    if (reached_equilibrium && check_states > 1) {
+      // Equilibrated at or before the check, simulate the run again checking
+      // every state to stop at the first one within epsilon
+      copy_double_matrix(plate_matrix->matrix, run_start, plate_matrix->rows
+          , plate_matrix->cols);
+      k_states -= check_states;
+      reached_equilibrium = false;
+      while (!reached_equilibrium) {
+        reached_equilibrium = update_plate(curr_plate, true);
+        ++k_states;
+      }
+    } else if (!reached_equilibrium) {
+      check_states = fixed_states ? fixed_states : choose_check_states(
+          check_states, curr_plate->max_delta, previous_delta
+          , curr_plate->epsilon);
+      previous_delta = curr_plate->max_delta;
+    }
   }  //  end while
+  if (run_start) destroy_double_matrix(run_start, plate_matrix->rows);
 
   // Store k, number of states iterated until equilibrium, in plate
   curr_plate->k_states = k_states;
+  return EXIT_SUCCESS;
+}
+
+
+
+bool simulate_states(plate_t* plate, uint64_t states) {
+  for (uint64_t state = 1; state < states; ++state) {
+    update_plate(plate, false);
+  }
+  return update_plate(plate, true);
 }
 
 
@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include "job.h"
@@ -31,6 +32,20 @@ int main(int argc, char* argv[]) {
   //   sscanf(argv[2], "%" SCNu64, &thread_count);
   // }
 
-  int error = simulate(argv[1], thread_count);
+  // States between convergence checks, given after the thread count like in
+  // the concurrent versions (the thread count is ignored)
+  uint64_t check_states = 1;
+  if (argc >= 4) {
+    char extra = '\0';
+    if (strcmp(argv[3], "auto") == 0) {
+      check_states = 0;
+    } else if (sscanf(argv[3], "%" SCNu64 "%c", &check_states, &extra) != 1
+        || check_states == 0 || argv[3][0] == '-') {
+      fprintf(stderr, "Error: Invalid check states (positive or auto)\n");
+      return INVALID_CHECK_STATES;
+    }
+  }
+
+  int error = simulate(argv[1], thread_count, check_states);
   return error;
 }
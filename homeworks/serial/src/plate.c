@@ -46,7 +46,7 @@ int set_plate_matrix(plate_t* plate, char* source_directory) {
 
 
 
-bool update_plate(plate_t* plate) {
+bool update_plate(plate_t* plate, bool check) {
   // Get the plate matrix from the plate structure
   plate_matrix_t* plate_matrix = plate->plate_matrix;
 
@@ -59,10 +59,17 @@ bool update_plate(plate_t* plate) {
   double biggest_change = 0;
 
   // Precompute constant for temperature update calculations
-  double diff_times_interval =
-      plate->thermal_diffusivity * plate->interval_duration;
-  uint64_t cell_area = plate->cells_dimension * plate->cells_dimension;
-  double mult_constant = diff_times_interval / cell_area;
+  double mult_constant = calculate_mult_constant(plate);
+
+  // States between convergence checks only update the cells
+  if (!check) {
+    for (size_t row = 1; row < plate_matrix->rows - 1; ++row) {
+      for (size_t col = 1; col < plate_matrix->cols - 1; ++col) {
+        update_cell(plate_matrix, row, col, mult_constant);
+      }
+    }
+    return false;
+  }
 
   // Iterate over all interior cells (excluding boundary cells)
   for (size_t row = 1; row < plate_matrix->rows - 1; ++row) {
@@ -89,11 +96,38 @@ bool update_plate(plate_t* plate) {
     reached_equilibrium = false;
   }
 
+  plate->max_delta = biggest_change;
   return reached_equilibrium;
 }
 
 
 
+double calculate_mult_constant(plate_t* plate) {
+  double diff_times_interval =
+      plate->thermal_diffusivity * plate->interval_duration;
+  uint64_t cell_area = plate->cells_dimension * plate->cells_dimension;
+  return diff_times_interval / cell_area;
+}
+
+
+
+uint64_t choose_check_states(uint64_t check_states, double delta
+    , double previous_delta, double epsilon) {
+  uint64_t limit = 2 * check_states;
+  if (limit > MAX_CHECK_STATES) limit = MAX_CHECK_STATES;
+  // Without a decay to extrapolate, the next check is farther away
+  if (previous_delta <= 0 || delta <= 0 || delta >= previous_delta) {
+    return limit;
+  }
+  const double decay_per_state = log(delta / previous_delta) / check_states;
+  const double remaining_states = log(epsilon / delta) / decay_per_state;
+  if (remaining_states / 2 < 1) return 1;
+  return remaining_states / 2 < limit ? (uint64_t) (remaining_states / 2)
+      : limit;
+}
+
+
+
 int update_plate_file(plate_t* plate, char* source_directory) {
   int error = EXIT_SUCCESS;
 
@@ -14,6 +14,9 @@
 #include "errors.h"
 #include "plate_matrix.h"
 
+/** @brief Most states between two convergence checks in adaptive mode */
+#define MAX_CHECK_STATES 1024
+
 /**
  * @struct plate_t
  * @brief Structure to store plate properties and state.
@@ -26,6 +29,7 @@ typedef struct {
   double cells_dimension;      ///< Cell size dimension
   double epsilon;                ///< Threshold for equilibrium check
   uint64_t k_states;             ///< Current simulation state
+  double max_delta;              ///< Maximum temperature change in last check
 } plate_t;
 
 /**
@@ -45,9 +49,33 @@ int set_plate_matrix(plate_t* plate, char* source_directory);
  * Computes new temperatures for each cell and checks for equilibrium.
  * 
  * @param plate Pointer to the plate structure.
- * @return True if equilibrium is reached, false otherwise.
+ * @param check True to measure the maximum temperature change of the state,
+ * false to only compute the new temperatures.
+ * @return True if equilibrium is reached, false otherwise. Always false if
+ * not checked.
+ */
+bool update_plate(plate_t* plate, bool check);
+
+/// @brief Calculates the constant of the new temperature of a cell, from
+/// the thermal diffusivity, interval duration and area of its plate
+double calculate_mult_constant(plate_t* plate);
+
+/**
+ * @brief Chooses the states until the next convergence check.
+ *
+ * Assumes the maximum change decays geometrically, at the rate measured
+ * between the last two checks, and checks again at half the states predicted
+ * to reach epsilon, so the states simulated again after the last check are
+ * few. States between checks at most double from one check to the next.
+ *
+ * @param check_states States between the last two checks
+ * @param delta Maximum change at the last check
+ * @param previous_delta Maximum change at the check before, 0 if none
+ * @param epsilon Epsilon of the plate
+ * @return States until the next check, at least 1
  */
-bool update_plate(plate_t* plate);
+uint64_t choose_check_states(uint64_t check_states, double delta
+    , double previous_delta, double epsilon);
 
 /**
  * @brief Writes the updated plate matrix to a binary file.
@@ -71,6 +71,16 @@ double** create_double_matrix(const size_t rows, const size_t cols);
  */
 void destroy_plate_matrix(plate_matrix_t* plate_matrix);
 
+/**
+ * @brief Copies the temperatures of a 2D matrix into another one.
+ * @param destination Matrix to copy into.
+ * @param source Matrix to copy.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ */
+void copy_double_matrix(double** destination, double** source
+    , const size_t rows, const size_t cols);
+
 /**
  * @brief Frees memory allocated for a 2D matrix of doubles.
  * @param matrix Pointer to the matrix.